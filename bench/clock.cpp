@@ -0,0 +1,35 @@
+#include <chrono>
+#include <cstdio>
+
+#include "rix/util/time.hpp"
+
+using namespace rix::util;
+
+/**
+ * Measures the cost of reading each clock domain.
+ */
+int main() {
+    constexpr int ITERATIONS = 1'000'000;
+
+    auto measure = [](const char *name, auto now) {
+        int64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            sink += now().to_nanoseconds();
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::fprintf(stderr, "%12s %8.1f ns (%lld)\n", name,
+                     std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS,
+                     static_cast<long long>(sink & 1));
+    };
+
+    TscTime::now();  // Calibrate before measuring
+    std::fprintf(stderr, "TSC %s, %.0f Hz\n", TscClock::available() ? "available" : "not available",
+                 TscClock::frequency());
+    measure("Time", []() { return Time::now(); });
+    measure("Steady", []() { return SteadyTime::now(); });
+    measure("CoarseSteady", []() { return CoarseSteadyTime::now(); });
+    measure("Coarse", []() { return CoarseTime::now(); });
+    measure("Tsc", []() { return TscTime::now(); });
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "rix/ipc/pipe.hpp"
+#include "rix/util/time.hpp"
+
+using namespace rix::ipc;
+
+/**
+ * Measures how long `File::wait_for_readable` actually blocks on an empty pipe
+ * for a range of timeouts. The overshoot is the time spent past the requested
+ * timeout; with millisecond-resolution polling every sub-millisecond timeout
+ * would overshoot to at least 1 ms.
+ */
+int main() {
+    constexpr int ITERATIONS = 200;
+    const std::vector<double> timeouts_us = {0, 10, 50, 100, 250, 500, 1000, 2000};
+
+    auto pipes = Pipe::create();
+    Pipe &reader = pipes[0];
+    if (!reader.ok()) {
+        std::fprintf(stderr, "failed to create pipe\n");
+        return 1;
+    }
+
+    std::printf("%12s %14s %14s %14s\n", "timeout(us)", "mean(us)", "p50(us)", "p99(us)");
+    for (double timeout_us : timeouts_us) {
+        rix::util::Duration timeout(timeout_us * 1e-6);
+        std::vector<double> samples;
+        samples.reserve(ITERATIONS);
+        for (int i = 0; i < ITERATIONS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            reader.wait_for_readable(timeout);
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        double mean = 0;
+        for (double s : samples) {
+            mean += s;
+        }
+        mean /= samples.size();
+        std::printf("%12.0f %14.1f %14.1f %14.1f\n", timeout_us, mean, samples[samples.size() / 2],
+                    samples[samples.size() * 99 / 100]);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "rix/util/binary_log.hpp"
+#include "rix/util/log.hpp"
+
+using namespace rix::util;
+
+/**
+ * Measures the time a thread spends in one `Log::info` statement in
+ * synchronous and asynchronous mode, in one `RIX_BLOG` statement, and in a
+ * disabled debug statement. Run with stdout redirected (for example
+ * to /dev/null) so the terminal does not dominate the synchronous case.
+ */
+int main() {
+    constexpr int ITERATIONS = 20000;
+
+    auto measure = [](const char *mode, auto &&log) {
+        std::vector<double> samples;
+        samples.reserve(ITERATIONS);
+        for (int i = 0; i < ITERATIONS; i++) {
+            auto start = std::chrono::steady_clock::now();
+            log(i);
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            if (i % 16 == 15) {
+                // Pace the loop like a 1 kHz control loop logging a few records per cycle
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::sort(samples.begin(), samples.end());
+        double mean = 0;
+        for (double s : samples) {
+            mean += s;
+        }
+        mean /= samples.size();
+        std::fprintf(stderr, "%8s %14.0f %14.0f %14.0f\n", mode, mean, samples[samples.size() / 2],
+                     samples[samples.size() * 99 / 100]);
+    };
+
+    // Time field of the header: Time::to_string against the cached formatter
+    {
+        detail::HeaderFormatter formatter;
+        size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            sink += Time::now().to_string().size();
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            sink += formatter.format(Time::now().to_nanoseconds(), "").size();
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::fprintf(stderr, "header time field: to_string %.0f ns, cached %.0f ns (%zu)\n",
+                     std::chrono::duration<double, std::nano>(middle - start).count() / ITERATIONS,
+                     std::chrono::duration<double, std::nano>(end - middle).count() / ITERATIONS, sink);
+    }
+
+    std::fprintf(stderr, "%8s %14s %14s %14s\n", "mode", "mean(ns)", "p50(ns)", "p99(ns)");
+    auto text = [](int i) { Log::info << "control loop iteration " << i << " error " << 0.001 * i << std::endl; };
+    measure("sync", text);
+    Log::start_async();
+    measure("async", text);
+    Log::stop_async();
+    std::fprintf(stderr, "dropped %zu\n", Log::dropped());
+
+    BinaryLog::open("/tmp/log_bench.blog");
+    measure("binary", [](int i) { RIX_BLOG(INFO, "control loop iteration %d error %f", i, 0.001 * i); });
+    BinaryLog::close();
+    std::fprintf(stderr, "dropped %zu\n", BinaryLog::dropped());
+
+    // Disabled levels: the stream still evaluates its arguments, the macro does not
+    measure("debug<<", [](int i) { Log::debug << "state " << std::to_string(i) << " error " << 0.001 * i << std::endl; });
+    measure("RIX_LOG", [](int i) { RIX_LOG(DEBUG) << "state " << std::to_string(i) << " error " << 0.001 * i << std::endl; });
+    return 0;
+}
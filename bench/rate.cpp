@@ -0,0 +1,41 @@
+#include <cstdio>
+
+#include "rix/util/time.hpp"
+
+using namespace rix::util;
+
+/**
+ * Runs a 1 kHz loop for two seconds in each scheduling configuration of
+ * `Rate` and prints the drift and wakeup jitter.
+ */
+int main() {
+    constexpr int CYCLES = 2000;
+
+    auto run = [](const char *name, Rate::Mode mode, const Duration &spin) {
+        Rate rate(1000.0);
+        rate.set_mode(mode);
+        rate.set_spin(spin);
+        const SteadyTime start = SteadyTime::now();
+        for (int i = 0; i < CYCLES; i++) {
+            rate.sleep();
+        }
+        const Duration drift = (SteadyTime::now() - start) - rate.period() * CYCLES;
+        const auto &stats = rate.stats();
+        std::fprintf(stderr, "%18s drift %9.1f us, jitter mean %7.1f us max %8.1f us, overruns %llu\n", name,
+                     drift.to_nanoseconds() * 1e-3, stats.mean_jitter().to_nanoseconds() * 1e-3,
+                     stats.max_jitter.to_nanoseconds() * 1e-3, static_cast<unsigned long long>(stats.overruns));
+        std::fprintf(stderr, "%18s", "histogram (us)");
+        for (size_t i = 0; i < Rate::Stats::BUCKETS; i++) {
+            if (stats.histogram[i] > 0) {
+                std::fprintf(stderr, " <%lld:%llu", static_cast<long long>(Rate::Stats::bucket_limit(i).to_microseconds()),
+                             static_cast<unsigned long long>(stats.histogram[i]));
+            }
+        }
+        std::fprintf(stderr, "\n");
+    };
+
+    run("relative", Rate::Mode::RELATIVE, Duration());
+    run("deadline", Rate::Mode::DEADLINE, Duration());
+    run("deadline+spin", Rate::Mode::DEADLINE, Duration(0.0001));
+    return 0;
+}
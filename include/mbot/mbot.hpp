@@ -13,6 +13,7 @@
 
 #include "mbot/messages.hpp"
 #include "mbot/mbot_base.hpp"
+#include "rix/ipc/event_notification.hpp"
 #include "rix/ipc/file.hpp"
 #include "rix/msg/geometry/Twist2DStamped.hpp"
 
@@ -28,9 +29,10 @@ class MBot : public MBotBase {
 
    private:
     void timesync();
+    bool send_timesync();
 
     mutable std::mutex mtx;
     std::thread timesync_thr;
-    std::atomic<bool> stop_timesync_flag;
+    rix::ipc::EventNotification stop_timesync;
     rix::ipc::File file;
 };
\ No newline at end of file
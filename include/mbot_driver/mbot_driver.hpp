@@ -4,8 +4,10 @@
 
 #include "mbot/mbot.hpp"
 #include "mbot/mbot_base.hpp"
+#include "rix/ipc/channel.hpp"
 #include "rix/ipc/file.hpp"
 #include "rix/ipc/interfaces/io.hpp"
+#include "rix/ipc/intra_channel.hpp"
 #include "rix/ipc/interfaces/notification.hpp"
 #include "rix/ipc/signal.hpp"
 #include "rix/msg/geometry/Twist2DStamped.hpp"
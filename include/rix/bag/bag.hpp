@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace bag {
+
+/**
+ * @brief On-disk layout of a bag file. All numbers are stored in host byte
+ * order, as by `rix::msg::detail::serialize_number`.
+ *
+ * @details A bag is written append-only:
+ *
+ *     | file header | chunk | chunk | ... | chunk | index | footer |
+ *
+ * The file header occupies the first `ALIGNMENT` bytes. Each chunk starts
+ * with a chunk header followed by the records it holds, and is zero-padded to
+ * a multiple of `ALIGNMENT` bytes, so every chunk starts on an aligned file
+ * offset. A record is a record header followed by the serialized message (the
+ * payload of one frame, without its size prefix).
+ *
+ * The index holds one `ChunkInfo` per chunk and the footer, at the very end
+ * of the file, locates the index. Since each entry holds the time range and
+ * offset of its chunk, the index is a sparse time index: a reader can find
+ * the chunks covering a time range without touching the others.
+ *
+ * A bag whose writer did not close it (for example after a crash) has no
+ * index; its chunks can still be recovered by scanning from the file header.
+ *
+ */
+namespace format {
+
+constexpr std::array<char, 8> FILE_MAGIC = {'R', 'I', 'X', 'B', 'A', 'G', '0', '1'};
+constexpr std::array<char, 8> INDEX_MAGIC = {'R', 'I', 'X', 'B', 'A', 'G', 'I', 'X'};
+constexpr uint32_t CHUNK_MAGIC = 0x4b4e4843;  // "CHNK"
+constexpr uint32_t VERSION = 1;
+constexpr size_t ALIGNMENT = 4096;
+
+// Header: magic, version, alignment
+constexpr size_t FILE_HEADER_SIZE = ALIGNMENT;
+
+// Chunk header: magic, record bytes, record count, padded chunk size,
+// earliest and latest record stamp in nanoseconds
+constexpr size_t CHUNK_HEADER_SIZE = 4 + 4 + 4 + 4 + 8 + 8;
+
+// Record header: stamp in nanoseconds, message hash, payload size
+constexpr size_t RECORD_HEADER_SIZE = 8 + 16 + 4;
+
+// Index entry: chunk offset, record count, padded chunk size, earliest and
+// latest record stamp in nanoseconds
+constexpr size_t INDEX_ENTRY_SIZE = 8 + 4 + 4 + 8 + 8;
+
+// Footer: index offset, chunk count, record count, magic
+constexpr size_t FOOTER_SIZE = 8 + 8 + 8 + 8;
+
+}  // namespace format
+
+/**
+ * @brief Location and time range of one chunk.
+ *
+ */
+struct ChunkInfo {
+    uint64_t offset;  /**< File offset of the chunk header */
+    uint32_t count;   /**< Number of records */
+    uint32_t size;    /**< Padded size of the chunk in bytes */
+    int64_t start;    /**< Earliest record stamp in nanoseconds */
+    int64_t end;      /**< Latest record stamp in nanoseconds */
+};
+
+/**
+ * @brief One recorded message. `data` refers to the `Reader`'s mapping of the
+ * bag and is valid as long as the `Reader` exists.
+ *
+ */
+struct Record {
+    util::Time stamp;                /**< Time at which the message was received */
+    std::array<uint64_t, 2> hash;    /**< Message type hash */
+    std::span<const uint8_t> data;   /**< Serialized message */
+};
+
+}  // namespace bag
+}  // namespace rix
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "rix/bag/reader.hpp"
+#include "rix/ipc/interfaces/io.hpp"
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace bag {
+
+/**
+ * @class Player
+ * @brief Replays the records of a bag to an `interfaces::IO` as frames of a
+ * 4-byte size prefix followed by the serialized message, the same framing
+ * `TeleopKeyboard` writes and `MBotDriver` reads.
+ *
+ * @details Each record is written when as much time has passed since the
+ * start of the replay as passed between the first record and this one when
+ * they were received, divided by `scale`. A scale of 2 replays twice as fast
+ * as recorded, and a scale of 0 writes every record as fast as the output
+ * accepts it. Records are scheduled against absolute times of the monotonic
+ * clock with `util::sleep_until`, so errors do not accumulate over a long
+ * replay and setting the wall clock does not disturb it.
+ *
+ * Replay starts at the reader's current position, so a time range can be
+ * selected with `Reader::seek` first.
+ *
+ */
+class Player {
+   public:
+    /**
+     * @brief Timing of a replay.
+     *
+     */
+    struct Stats {
+        size_t frames;           /**< Frames written */
+        util::Duration elapsed;  /**< Time from the first frame to the last */
+        util::Duration mean_error;  /**< Mean lateness of a frame relative to its schedule */
+        util::Duration max_error;   /**< Largest lateness of a frame */
+
+        /**
+         * @brief Returns the achieved rate in frames per second.
+         *
+         */
+        double rate() const;
+    };
+
+    /**
+     * @brief Creates a player. Neither the reader nor the output are owned and
+     * both must outlive the player.
+     *
+     * @param reader The bag to replay
+     * @param output The IO to write frames to
+     * @param scale The time-scale factor, or 0 to replay as fast as possible
+     */
+    Player(Reader &reader, ipc::interfaces::IO &output, double scale = 1.0);
+
+    /**
+     * @brief Replays records until the end of the bag (or of the reader's time
+     * range). Each call starts a new replay from the reader's current
+     * position, timed from its first record, and resets `stats`.
+     *
+     * @param interrupted Called before each frame and while the output is not
+     * writable. If it returns true, the replay stops.
+     * @return true if every record was written, false if the replay was
+     * interrupted or the output failed.
+     */
+    bool play(const std::function<bool()> &interrupted = nullptr);
+
+    /**
+     * @brief Returns the timing of the replay so far.
+     *
+     */
+    const Stats &stats() const;
+
+   private:
+    bool write_frame(const Record &record, const std::function<bool()> &interrupted);
+
+    Reader &reader_;
+    ipc::interfaces::IO &output_;
+    double scale_;
+    Stats stats_;
+    std::vector<uint8_t> frame_;
+};
+
+}  // namespace bag
+}  // namespace rix
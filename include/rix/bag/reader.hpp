@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rix/bag/bag.hpp"
+#include "rix/ipc/mapped_file.hpp"
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace bag {
+
+/**
+ * @class Reader
+ * @brief Reads the messages recorded in a bag file (see `rix::bag::format`)
+ * in the order they were written.
+ *
+ * @details The bag is mapped into memory, so records are returned without
+ * copies and only the pages that are actually read are loaded from disk. The
+ * chunks are located with the trailing index. If the bag has no index because
+ * its writer never closed it, the chunks are found by scanning the chunk
+ * headers instead, and any incomplete chunk at the end is ignored.
+ *
+ * `seek` uses the time ranges in the index to find the first chunk that may
+ * hold a record at or after a given time with a binary search, and can limit
+ * iteration to a time range. Chunks entirely outside the range are never
+ * read, so a few seconds can be extracted from a multi-hour bag without
+ * scanning it:
+ *
+ *     rix::bag::Reader bag("commands.bag");
+ *     bag.seek(start, start + rix::util::Duration(5.0));
+ *     rix::msg::geometry::Twist2DStamped msg;
+ *     rix::util::Time stamp;
+ *     while (bag.next(msg, stamp)) { ... }
+ *
+ * Stamps do not have to increase through the bag: a time range yields exactly
+ * the records whose stamps are in the range, in the order they were written.
+ *
+ */
+class Reader {
+   public:
+    /**
+     * @brief Default constructor. Does not refer to a bag.
+     *
+     */
+    Reader();
+
+    /**
+     * @brief Opens and maps the bag file specified by `pathname` and loads its
+     * index.
+     *
+     * @param pathname The path of the bag file
+     */
+    Reader(const std::string &pathname);
+
+    /**
+     * @brief Reads the next record in the current time range.
+     *
+     * @param record The record
+     * @return true if a record was read, false at the end of the bag or of the
+     * time range, or if a chunk is corrupt (`EINVAL`).
+     */
+    bool next(Record &record);
+
+    /**
+     * @brief Reads the next record of type `T` in the current time range,
+     * skipping records of other types and records that can not be
+     * deserialized.
+     *
+     * @tparam T The message type (derived from `rix::msg::Message`)
+     * @param msg The message
+     * @param stamp The time at which the message was received
+     * @return true if a message was read, false at the end of the bag or of the
+     * time range.
+     */
+    template <typename T>
+    bool next(T &msg, util::Time &stamp) {
+        const auto hash = msg.hash();
+        Record record;
+        while (next(record)) {
+            size_t offset = 0;
+            if (record.hash == hash && msg.deserialize(record.data.data(), record.data.size(), offset)) {
+                stamp = record.stamp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Restricts iteration to the records stamped between `begin` and
+     * `end` (inclusive) and moves to the first chunk that may hold one.
+     *
+     * @param begin The earliest stamp to read
+     * @param end The latest stamp to read
+     * @return true if the bag holds a record that may be in the range.
+     */
+    bool seek(const util::Time &begin, const util::Time &end = util::Time::max());
+
+    /**
+     * @brief Restarts iteration at the first record and removes the time
+     * range set by `seek`.
+     *
+     */
+    void rewind();
+
+    /**
+     * @brief Returns the chunks of the bag.
+     *
+     */
+    const std::vector<ChunkInfo> &chunks() const;
+
+    /**
+     * @brief Returns the number of records in the bag.
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the earliest record stamp, or `Time::max()` if the bag is
+     * empty.
+     *
+     */
+    util::Time start() const;
+
+    /**
+     * @brief Returns the latest record stamp, or `Time::min()` if the bag is
+     * empty.
+     *
+     */
+    util::Time end() const;
+
+    /**
+     * @brief Returns `true` if the chunks were located with the trailing
+     * index, or `false` if the file had to be scanned.
+     *
+     */
+    bool indexed() const;
+
+    /**
+     * @brief Returns `true` if the file is a bag, `false` otherwise.
+     *
+     */
+    bool ok() const;
+
+   private:
+    bool load_index();
+    void scan();
+    bool load_chunk(size_t index);
+
+    ipc::MappedFile map_;
+    std::vector<ChunkInfo> chunks_;
+    std::vector<int64_t> max_end_;    /**< Latest stamp in chunks [0, i] */
+    std::vector<int64_t> min_start_;  /**< Earliest stamp in chunks [i, n) */
+    size_t count_;
+    bool indexed_;
+    bool ok_;
+
+    int64_t begin_;      /**< Time range in nanoseconds */
+    int64_t end_;
+    size_t next_chunk_;
+    size_t offset_;      /**< File offset of the next record */
+    size_t chunk_end_;   /**< File offset of the end of the current chunk's records */
+};
+
+}  // namespace bag
+}  // namespace rix
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rix/bag/bag.hpp"
+#include "rix/ipc/file.hpp"
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace bag {
+
+/**
+ * @class Writer
+ * @brief Records messages into a bag file (see `rix::bag::format`).
+ *
+ * @details Records are appended to an in-memory chunk buffer aligned to
+ * `format::ALIGNMENT`. When a chunk is full it is handed to a background
+ * thread that writes it to disk with a single `pwrite`, while recording
+ * continues in another buffer. Calls to `write` therefore never wait for the
+ * disk. A chunk that is older than `max_age` when the next record arrives is
+ * written even if it is not full, which bounds the data lost if the process
+ * dies without closing the bag. At most `max_pending` chunk buffers exist; if all of them are waiting
+ * to be written, records are dropped (and counted by `dropped`) instead of
+ * stalling the caller.
+ *
+ *     rix::bag::Writer bag("commands.bag");
+ *     bag.write(msg);  // stamped with the current time
+ *     bag.close();     // writes the remaining records and the index
+ *
+ * Writer is not thread-safe: `write` must only be called from one thread at a
+ * time.
+ *
+ */
+class Writer {
+   public:
+    /**
+     * @brief Creates (or truncates) the bag file specified by `pathname` and
+     * starts the flush thread.
+     *
+     * @param pathname The path of the bag file
+     * @param chunk_size The size of each chunk buffer in bytes, rounded up to a
+     * multiple of `format::ALIGNMENT`
+     * @param max_pending The maximum number of chunk buffers
+     * @param max_age The time after which a chunk that is not full is written
+     * by the next `write`
+     */
+    Writer(const std::string &pathname, size_t chunk_size = 1 << 20, size_t max_pending = 8,
+           const util::Duration &max_age = util::Duration(1.0));
+
+    /**
+     * @brief Copy constructor is deleted because the flush thread can not be
+     * shared.
+     */
+    Writer(const Writer &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because the flush thread can not be
+     * shared.
+     */
+    Writer &operator=(const Writer &other) = delete;
+
+    /**
+     * @brief Destructor. Closes the bag.
+     *
+     */
+    ~Writer();
+
+    /**
+     * @brief Records a serialized message.
+     *
+     * @param data The serialized message
+     * @param size The size of the serialized message
+     * @param hash The message type hash
+     * @param stamp The time at which the message was received
+     * @return true if the message was recorded. Otherwise `errno` is `EBADF` if
+     * the bag is closed or invalid, `EMSGSIZE` if the record does not fit in a
+     * chunk, or `ENOBUFS` if it was dropped because every chunk buffer is
+     * waiting to be written.
+     */
+    bool write(const uint8_t *data, size_t size, const std::array<uint64_t, 2> &hash,
+               const util::Time &stamp = util::Time::now());
+
+    /**
+     * @brief Serializes and records `msg` directly into the chunk buffer.
+     *
+     * @tparam T The message type (derived from `rix::msg::Message`)
+     * @param msg The message
+     * @param stamp The time at which the message was received
+     * @return true if the message was recorded. See `write` for errors.
+     */
+    template <typename T>
+    bool write(const T &msg, const util::Time &stamp = util::Time::now()) {
+        uint8_t *dst = reserve(msg.size(), msg.hash(), stamp);
+        if (dst == nullptr) {
+            return false;
+        }
+        size_t offset = 0;
+        msg.serialize(dst, offset);
+        return true;
+    }
+
+    /**
+     * @brief Writes the remaining records, the index and the footer, and stops
+     * the flush thread. Has no effect if the bag is already closed.
+     *
+     * @return true if everything recorded so far was written successfully.
+     */
+    bool close();
+
+    /**
+     * @brief Returns `true` if the bag is open and no write has failed.
+     *
+     */
+    bool ok() const;
+
+    /**
+     * @brief Returns the number of messages recorded.
+     *
+     */
+    size_t count() const;
+
+    /**
+     * @brief Returns the number of messages dropped because every chunk buffer
+     * was waiting to be written.
+     *
+     */
+    size_t dropped() const;
+
+   private:
+    struct Chunk {
+        std::unique_ptr<uint8_t, void (*)(void *)> data;
+        size_t used;  /**< Bytes used, including the chunk header */
+        uint32_t count;
+        int64_t start;
+        int64_t end;
+        uint64_t offset;
+        uint32_t size;  /**< Padded size, set when sealed */
+        std::chrono::steady_clock::time_point opened;  /**< Time of the first record */
+    };
+
+    uint8_t *reserve(size_t size, const std::array<uint64_t, 2> &hash, const util::Time &stamp);
+    std::unique_ptr<Chunk> acquire();
+    void seal();
+    void flush_loop();
+    bool write_at(const uint8_t *src, size_t size, uint64_t offset);
+
+    ipc::File file_;
+    size_t chunk_size_;
+    size_t max_pending_;
+    util::Duration max_age_;
+    size_t allocated_;
+    uint64_t next_offset_;
+    size_t count_;
+    size_t dropped_;
+    bool open_;
+    std::unique_ptr<Chunk> current_;
+    std::vector<ChunkInfo> index_;
+
+    // Shared with the flush thread
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::unique_ptr<Chunk>> full_;
+    std::vector<std::unique_ptr<Chunk>> free_;
+    bool stopping_;
+    bool failed_;
+    std::thread flusher_;
+};
+
+}  // namespace bag
+}  // namespace rix
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "rix/ipc/interfaces/io.hpp"
+#include "rix/msg/geometry/Twist2D.hpp"
+#include "rix/msg/serialization.hpp"
+#include "rix/msg/standard/Duration.hpp"
+#include "rix/msg/standard/Time.hpp"
+#include "rix/msg/standard/UInt32.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @brief The serialized size of message type `T` if every instance has the
+ * same size, otherwise 0. Specialize it for other fixed-layout messages (no
+ * strings, vectors or nested variable-size messages) to give their channels
+ * the fixed-size framing path.
+ *
+ */
+template <typename T>
+struct fixed_size : std::integral_constant<uint32_t, 0> {};
+
+template <>
+struct fixed_size<rix::msg::geometry::Twist2D> : std::integral_constant<uint32_t, 12> {};
+template <>
+struct fixed_size<rix::msg::standard::Duration> : std::integral_constant<uint32_t, 8> {};
+template <>
+struct fixed_size<rix::msg::standard::Time> : std::integral_constant<uint32_t, 8> {};
+template <>
+struct fixed_size<rix::msg::standard::UInt32> : std::integral_constant<uint32_t, 4> {};
+
+/**
+ * @class Channel
+ * @brief Reads and writes messages of type `T` over any `interfaces::IO` as
+ * frames of a 4-byte size prefix followed by the serialized message.
+ *
+ * @details The channel does not own the IO, which must outlive it. Reads and
+ * writes keep going through partial transfers and `EINTR`. When the IO is
+ * non-blocking and not ready, the channel calls the optional `interrupted`
+ * callback and then waits up to 1ms for the IO, so a node can stop between
+ * partial transfers without busy waiting.
+ *
+ * Payloads are serialized into a buffer that is reused between calls. If `T`
+ * has a fixed size (see `fixed_size`), the frame size is a compile-time
+ * constant: frames are built in a fixed array, `T::size` is never called and
+ * the size prefix of incoming frames is only checked, not used to size a
+ * buffer.
+ *
+ *     Channel<rix::msg::geometry::Twist2DStamped> channel(*input);
+ *     while (channel.read(msg)) { ... }
+ *
+ * @tparam T The message type (derived from `rix::msg::Message`)
+ */
+template <typename T>
+class Channel {
+   public:
+    static constexpr size_t PREFIX_SIZE = 4;
+    static constexpr uint32_t FIXED_SIZE = fixed_size<T>::value;
+    static constexpr bool IS_FIXED = FIXED_SIZE > 0;
+
+    using Interrupt = std::function<bool()>;
+
+    /**
+     * @brief Creates a channel over `io`.
+     *
+     * @param io The IO to read frames from and write frames to
+     */
+    explicit Channel(interfaces::IO &io) : io_(io), buffer_(), fixed_() {}
+
+    /**
+     * @brief Serializes `msg` as one frame into `dst`, replacing its contents.
+     *
+     * @param msg The message to serialize
+     * @param dst The frame
+     */
+    static void encode(const T &msg, std::vector<uint8_t> &dst) {
+        const uint32_t size = IS_FIXED ? FIXED_SIZE : static_cast<uint32_t>(msg.size());
+        dst.resize(PREFIX_SIZE + size);
+        size_t offset = 0;
+        rix::msg::detail::serialize_number<uint32_t>(dst.data(), offset, size);
+        msg.serialize(dst.data(), offset);
+    }
+
+    /**
+     * @brief Writes `msg` as one frame.
+     *
+     * @param msg The message to write
+     * @param interrupted Called whenever the IO is not writable. If it returns
+     * true, the write is abandoned.
+     * @return true if the whole frame was written. Otherwise `errno` is
+     * `ECANCELED` if `interrupted` returned true, or the error of the IO. An
+     * abandoned frame may have been partially written.
+     */
+    bool write(const T &msg, const Interrupt &interrupted = nullptr) {
+        if constexpr (IS_FIXED) {
+            size_t offset = 0;
+            rix::msg::detail::serialize_number<uint32_t>(fixed_.data(), offset, FIXED_SIZE);
+            msg.serialize(fixed_.data(), offset);
+            return write_exact(fixed_.data(), fixed_.size(), interrupted);
+        } else {
+            encode(msg, buffer_);
+            return write_exact(buffer_.data(), buffer_.size(), interrupted);
+        }
+    }
+
+    /**
+     * @brief Reads one frame into `msg`.
+     *
+     * @param msg The message to deserialize into
+     * @param interrupted Called whenever no data is available. If it returns
+     * true, the read is abandoned.
+     * @return true if a message was read. Otherwise `errno` is 0 at end of
+     * file, `EBADMSG` if a whole frame was read but did not hold a valid `T`
+     * (the next frame can still be read), `ECANCELED` if `interrupted` returned
+     * true, or the error of the IO.
+     */
+    bool read(T &msg, const Interrupt &interrupted = nullptr) {
+        uint8_t prefix[PREFIX_SIZE];
+        if (!read_exact(prefix, PREFIX_SIZE, interrupted)) {
+            return false;
+        }
+        uint32_t size = 0;
+        size_t offset = 0;
+        rix::msg::detail::deserialize_number<uint32_t>(size, prefix, PREFIX_SIZE, offset);
+
+        if constexpr (IS_FIXED) {
+            if (size == FIXED_SIZE) {
+                uint8_t *payload = fixed_.data() + PREFIX_SIZE;
+                if (!read_exact(payload, FIXED_SIZE, interrupted)) {
+                    return false;
+                }
+                offset = 0;
+                if (!msg.deserialize(payload, FIXED_SIZE, offset)) {
+                    errno = EBADMSG;
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        buffer_.resize(size);
+        if (size > 0 && !read_exact(buffer_.data(), size, interrupted)) {
+            return false;
+        }
+        offset = 0;
+        if (IS_FIXED || !msg.deserialize(buffer_.data(), buffer_.size(), offset)) {
+            errno = EBADMSG;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns the underlying IO.
+     *
+     */
+    interfaces::IO &io() const { return io_; }
+
+   private:
+    bool read_exact(uint8_t *dst, size_t size, const Interrupt &interrupted) {
+        size_t got = 0;
+        while (got < size) {
+            ssize_t r = io_.read(dst + got, size - got);
+            if (r == 0) {
+                errno = 0;
+                return false;
+            }
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                // Only check for interruption when we would otherwise block
+                if (interrupted && interrupted()) {
+                    errno = ECANCELED;
+                    return false;
+                }
+                io_.wait_for_readable(rix::util::Duration(0.001));  // 1ms
+                continue;
+            }
+            got += static_cast<size_t>(r);
+        }
+        return true;
+    }
+
+    bool write_exact(const uint8_t *src, size_t size, const Interrupt &interrupted) {
+        size_t sent = 0;
+        while (sent < size) {
+            ssize_t w = io_.write(src + sent, size - sent);
+            if (w == 0) {
+                errno = EPIPE;
+                return false;
+            }
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                if (interrupted && interrupted()) {
+                    errno = ECANCELED;
+                    return false;
+                }
+                io_.wait_for_writable(rix::util::Duration(0.001));  // 1ms
+                continue;
+            }
+            sent += static_cast<size_t>(w);
+        }
+        return true;
+    }
+
+    interfaces::IO &io_;
+    std::vector<uint8_t> buffer_;
+    std::array<uint8_t, PREFIX_SIZE + FIXED_SIZE> fixed_;
+};
+
+}  // namespace ipc
+}  // namespace rix
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "rix/ipc/file.hpp"
+#include "rix/ipc/interfaces/notification.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class EventNotification
+ * @brief Intra-process event handler backed by a Linux `eventfd`. Unlike
+ * `Signal`, raising an EventNotification only affects the objects that share
+ * its file descriptor, and costs a single 8-byte write.
+ *
+ * @details The eventfd holds a 64-bit counter. `raise` and `post` add to the
+ * counter. In COUNTER mode, a successful `wait` consumes the entire counter;
+ * in SEMAPHORE mode, a successful `wait` decrements the counter by one. Copies
+ * share the same counter (the file descriptor is duplicated using `dup`), so
+ * one copy can be handed to `MBotDriver::spin` or `TeleopKeyboard::spin` while
+ * another is kept to request a shutdown from a different thread.
+ *
+ */
+class EventNotification : public interfaces::Notification {
+   public:
+    enum class Mode : int {
+        COUNTER,
+        SEMAPHORE
+    };
+
+    /**
+     * @brief Creates a new eventfd with the specified initial counter value.
+     * If the eventfd could not be created, the object is left in an invalid
+     * state (`ok` returns `false`).
+     *
+     * @param mode The counter semantics (COUNTER or SEMAPHORE)
+     * @param initial_value The initial value of the counter
+     */
+    EventNotification(Mode mode = Mode::COUNTER, uint32_t initial_value = 0);
+
+    /**
+     * @brief Copy constructor. This will duplicate the underlying file
+     * descriptor using `dup`. Both objects refer to the same counter.
+     *
+     * @param other The EventNotification to be copied
+     */
+    EventNotification(const EventNotification &other);
+
+    /**
+     * @brief Assignment operator. This will duplicate the underlying file
+     * descriptor using `dup`. Both objects refer to the same counter.
+     *
+     * @param other The EventNotification to be copied
+     */
+    EventNotification &operator=(const EventNotification &other);
+
+    /**
+     * @brief Move constructor. Moves the source file descriptor to the
+     * destination and invalidates the source.
+     *
+     * @param other The EventNotification to be moved
+     */
+    EventNotification(EventNotification &&other);
+
+    /**
+     * @brief Move assignment operator. If the destination is valid, close the
+     * destination. Moves the source file descriptor to the destination and
+     * invalidates the source.
+     *
+     * @param other The EventNotification to be moved
+     */
+    EventNotification &operator=(EventNotification &&other);
+
+    /**
+     * @brief Destructor. Closes the underlying file descriptor.
+     *
+     */
+    virtual ~EventNotification();
+
+    /**
+     * @brief Adds one to the counter. Returns `false` if the object is in an
+     * invalid state or the write failed.
+     *
+     */
+    virtual bool raise() const override;
+
+    /**
+     * @brief Adds `value` to the counter. Returns `false` if the object is in
+     * an invalid state, `value` is zero, or the write failed.
+     *
+     * @param value The amount to add to the counter
+     */
+    bool post(uint64_t value) const;
+
+    /**
+     * @brief Wait until the counter is nonzero, or until the specified duration
+     * elapses. Returns `true` if the counter was consumed within the duration.
+     *
+     * @param d The maximum duration to wait.
+     */
+    virtual bool wait(const rix::util::Duration &d) const override;
+
+    /**
+     * @brief Same as `wait`, but stores the amount consumed from the counter
+     * in `value` (the whole counter in COUNTER mode, 1 in SEMAPHORE mode).
+     *
+     * @param d The maximum duration to wait.
+     * @param value The amount consumed from the counter.
+     */
+    bool wait(const rix::util::Duration &d, uint64_t &value) const;
+
+    /**
+     * @brief Returns the underlying eventfd. It becomes readable whenever the
+     * counter is nonzero, so it may be used with `poll`/`epoll`.
+     *
+     */
+    int fd() const;
+
+    /**
+     * @brief Returns `true` if the eventfd is in a valid state.
+     *
+     */
+    bool ok() const;
+
+    /**
+     * @brief Returns the counter semantics of the EventNotification.
+     *
+     */
+    Mode mode() const;
+
+   private:
+    File file_;
+    Mode mode_;
+};
+
+}  // namespace ipc
+}  // namespace rix
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "rix/ipc/file.hpp"
+#include "rix/ipc/interfaces/io.hpp"
+#include "rix/ipc/pipe.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class FanOut
+ * @brief Write-only `interfaces::IO` sink that copies every write to a set
+ * of outputs, replacing an external `tee` process. It can be used wherever an
+ * output IO is expected, for example as the output of `TeleopKeyboard`, so the
+ * same stream reaches the driver, a recorder and a visualizer.
+ *
+ * @details Each call to `write` (or `writev`) is treated as one frame. Sinks
+ * are switched to non-blocking mode when they are added, so a slow sink never
+ * blocks the others. When a sink cannot take a frame, its policy decides what
+ * happens: DROP discards the frame for that sink, BUFFER keeps it (up to
+ * `buffer_limit` bytes per sink) and writes it on a later `write` or `flush`.
+ * A frame that was only partially written is always completed, so a sink
+ * never sees a torn frame.
+ *
+ * Frames of at least `TEE_MIN_SIZE` bytes for two or more sinks that are
+ * pipes or FIFOs are written once into an internal pipe and duplicated into
+ * each sink with `tee(2)`, which shares the pipe buffer pages instead of
+ * copying the frame once per sink. Staging costs a few extra system calls per
+ * frame, so smaller frames and a single pipe sink use plain writes.
+ *
+ * A sink that fails with an error other than `EAGAIN` (for example `EPIPE`)
+ * is disabled. FanOut is not thread-safe.
+ *
+ */
+class FanOut : public interfaces::IO {
+   public:
+    enum class Policy : int {
+        DROP,
+        BUFFER
+    };
+
+    static constexpr size_t TEE_MIN_SIZE = 4096; /**< Smallest frame sent with `tee` */
+
+    /**
+     * @brief Creates a FanOut without sinks.
+     *
+     * @param buffer_limit The maximum number of bytes buffered per BUFFER sink
+     */
+    FanOut(size_t buffer_limit = 64 * 1024);
+
+    /**
+     * @brief Copy constructor is deleted because buffered data can not be
+     * shared.
+     */
+    FanOut(const FanOut &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because buffered data can not be
+     * shared.
+     */
+    FanOut &operator=(const FanOut &other) = delete;
+
+    /**
+     * @brief Destructor. Buffered data that could not be written is lost.
+     *
+     */
+    virtual ~FanOut();
+
+    /**
+     * @brief Adds a sink and switches it to non-blocking mode.
+     *
+     * @param sink The output to be written to
+     * @param policy What to do when the sink is not ready for a frame
+     * @return true if the sink was added.
+     */
+    bool add(std::shared_ptr<interfaces::IO> sink, Policy policy = Policy::DROP);
+
+    /**
+     * @brief FanOut is write-only. Always returns -1 with `errno` set to
+     * `EBADF`.
+     *
+     */
+    virtual ssize_t read(uint8_t *dst, size_t size) const override;
+
+    /**
+     * @brief Writes `size` bytes from `src` as one frame to every sink. Never
+     * blocks.
+     *
+     * @param src The source byte array
+     * @param size The number of bytes to write
+     * @return ssize_t `size`, since the frame has been accepted for every
+     * enabled sink (written, buffered or dropped by policy), or -1 if no sink
+     * is enabled.
+     */
+    virtual ssize_t write(const uint8_t *src, size_t size) const override;
+
+    /**
+     * @brief FanOut is write-only. Always returns -1 with `errno` set to
+     * `EBADF`.
+     *
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt) const override;
+
+    /**
+     * @brief Gathers the buffers described by `iov` into one frame and writes
+     * it to every sink. See `write`.
+     *
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt) const override;
+
+    /**
+     * @brief Always returns false because FanOut is write-only.
+     *
+     */
+    virtual bool wait_for_readable(const util::Duration &duration) const override;
+
+    /**
+     * @brief Returns true immediately if any sink is enabled, since `write`
+     * never blocks.
+     *
+     */
+    virtual bool wait_for_writable(const util::Duration &duration) const override;
+
+    /**
+     * @brief Has no effect: writes to the sinks are always non-blocking.
+     *
+     */
+    virtual void set_nonblocking(bool status) override;
+
+    /**
+     * @brief Always returns true.
+     *
+     */
+    virtual bool is_nonblocking() const override;
+
+    /**
+     * @brief Attempts to write the buffered data of every sink.
+     *
+     * @return true if no data remains buffered.
+     */
+    bool flush() const;
+
+    /**
+     * @brief Returns the number of sinks.
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of frames dropped for the sink at `index`.
+     *
+     */
+    size_t dropped(size_t index) const;
+
+    /**
+     * @brief Returns the number of bytes buffered for the sink at `index`.
+     *
+     */
+    size_t buffered(size_t index) const;
+
+    /**
+     * @brief Returns false if the sink at `index` has been disabled after an
+     * error.
+     *
+     */
+    bool enabled(size_t index) const;
+
+   private:
+    struct Sink {
+        std::shared_ptr<interfaces::IO> io;
+        Policy policy;
+        int pipe_fd;                   /**< Sink descriptor if it is a pipe, otherwise -1 */
+        std::vector<uint8_t> pending;  /**< Buffered bytes not yet written */
+        size_t pending_offset;
+        size_t dropped;
+        bool enabled;
+    };
+
+    bool drain(Sink &sink) const;
+    void defer(Sink &sink, const uint8_t *src, size_t size) const;
+    bool reset_stage() const;
+    bool stage(const uint8_t *src, size_t size) const;
+    void unstage(size_t size) const;
+
+    size_t buffer_limit_;
+    mutable std::vector<Sink> sinks_;
+    mutable std::array<Pipe, 2> stage_;  /**< Internal pipe used as the tee source */
+    File null_;                          /**< /dev/null, used to discard the staged frame */
+    mutable std::vector<uint8_t> scratch_;
+};
+
+}  // namespace ipc
+}  // namespace rix
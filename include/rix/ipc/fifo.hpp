@@ -81,6 +81,17 @@ class Fifo : public File {
      */
     Mode mode() const;
 
+   protected:
+    /**
+     * @brief Wraps an already opened file descriptor of the fifo special file
+     * specified by `pathname`. The descriptor is owned by the Fifo.
+     *
+     * @param fd The file descriptor
+     * @param pathname The path to the fifo special file
+     * @param mode The mode the Fifo was opened with
+     */
+    Fifo(int fd, const std::string &pathname, Mode mode);
+
    private:
     Mode mode_;
     std::string pathname_;
@@ -3,6 +3,7 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <cstdint>
@@ -151,6 +152,26 @@ class File : public interfaces::IO {
      */
     virtual ssize_t write(const uint8_t *src, size_t size) const override;
 
+    /**
+     * @brief Read from the file into `iovcnt` buffers described by `iov`,
+     * filling each buffer in order before moving to the next (`readv`).
+     * 
+     * @param iov The destination buffers
+     * @param iovcnt The number of buffers
+     * @return ssize_t The total number of bytes read, or -1 on error.
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt) const override;
+
+    /**
+     * @brief Write the contents of `iovcnt` buffers described by `iov` to the
+     * file with a single system call (`writev`).
+     * 
+     * @param iov The source buffers
+     * @param iovcnt The number of buffers
+     * @return ssize_t The total number of bytes written, or -1 on error.
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt) const override;
+
     /**
      * @brief Get the underlying file descriptor.
      * 
@@ -165,6 +186,8 @@ class File : public interfaces::IO {
 
     /**
      * @brief Waits for the specified duration for the file to become readable.
+     * The timeout has nanosecond resolution (see `ppoll`), so sub-millisecond
+     * durations are not rounded up.
      * 
      * @param duration The maximum duration to wait.
      * @return true if the file has become readable within the duration.
@@ -173,6 +196,8 @@ class File : public interfaces::IO {
 
     /**
      * @brief Waits for the specified duration for the file to become writable.
+     * The timeout has nanosecond resolution (see `ppoll`), so sub-millisecond
+     * durations are not rounded up.
      * 
      * @param duration The maximum duration to wait.
      * @return true if the file has become writable within the duration.
@@ -195,6 +220,9 @@ class File : public interfaces::IO {
 
    protected:
     int fd_;
+
+   private:
+    bool wait_for(short events, const util::Duration &duration) const;
 };
 
 }  // namespace ipc
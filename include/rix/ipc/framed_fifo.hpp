@@ -0,0 +1,161 @@
+#pragma once
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rix/ipc/fifo.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class FramedFifo
+ * @brief A Fifo that carries whole frames from many producers to one reader.
+ *
+ * @details A write of at most `PIPE_BUF` bytes to a FIFO is atomic: it is
+ * never interleaved with data written by another process. FramedFifo relies on
+ * this by writing every frame as one or more chunks that each fit in a single
+ * `PIPE_BUF` write. Each chunk starts with a 12-byte header:
+ *
+ *     uint32_t producer;   // producer id of the writer
+ *     uint32_t size;       // total size of the frame
+ *     uint16_t length;     // number of payload bytes in this chunk
+ *     uint16_t flags;      // FIRST on the first chunk of a frame, MORE if
+ *                          // the frame continues in another chunk
+ *
+ * Frames up to `MAX_CHUNK_SIZE` bytes are a single chunk. Larger frames are
+ * split into continuation chunks (or rejected with `EMSGSIZE` if chunking is
+ * disabled). Chunks from different producers may interleave, so the reader
+ * reassembles frames per producer and returns each frame tagged with the id
+ * of the producer that wrote it. Each producer id must be used by at most one
+ * writer at a time. If a producer dies in the middle of a frame, the partial
+ * frame is discarded when the next frame with the same id starts.
+ *
+ *     FramedFifo writer("commands", Fifo::Mode::WRITE, 7);
+ *     writer.write_frame(buffer.data(), buffer.size());
+ *
+ *     FramedFifo reader("commands", Fifo::Mode::READ);
+ *     FramedFifo::Frame frame;
+ *     while (reader.read_frame(frame)) { ... frame.producer, frame.data ... }
+ *
+ */
+class FramedFifo : public Fifo {
+   public:
+    static constexpr size_t HEADER_SIZE = 12;
+    static constexpr size_t MAX_CHUNK_SIZE = PIPE_BUF - HEADER_SIZE;
+    static constexpr uint16_t MORE = 1;
+    static constexpr uint16_t FIRST = 2;
+
+    /**
+     * @brief A reassembled frame and the id of the producer that wrote it.
+     *
+     */
+    struct Frame {
+        uint32_t producer;
+        std::vector<uint8_t> data;
+    };
+
+    /**
+     * @brief Default constructor. This does not open a file descriptor.
+     *
+     */
+    FramedFifo();
+
+    /**
+     * @brief Opens the named pipe specified by `pathname` for framed IO. See
+     * `Fifo::Fifo`.
+     *
+     * @param pathname The path to the fifo special file
+     * @param mode The mode to open the Fifo with (READ or WRITE)
+     * @param producer_id The id written with every frame (defaults to the
+     * process id)
+     * @param nonblocking Flag to toggle non-blocking IO
+     * @param chunking If false, frames larger than `MAX_CHUNK_SIZE` are
+     * rejected instead of being split into continuation chunks
+     */
+    FramedFifo(const std::string &pathname, Mode mode, uint32_t producer_id = static_cast<uint32_t>(::getpid()),
+               bool nonblocking = false, bool chunking = true);
+
+    /**
+     * @brief Opens an existing named pipe for non-blocking framed writes.
+     * Unlike the constructor, this never creates the fifo special file, and
+     * fails if `pathname` is missing, is a symbolic link or is not a FIFO.
+     *
+     * @param pathname The path to the fifo special file
+     * @param producer_id The id written with every frame (defaults to the
+     * process id)
+     * @return FramedFifo The opened FramedFifo, or an invalid FramedFifo with
+     * `errno` set (`ENOENT` if the file does not exist, `ENXIO` if it is not
+     * a FIFO).
+     */
+    static FramedFifo open_existing(const std::string &pathname,
+                                    uint32_t producer_id = static_cast<uint32_t>(::getpid()));
+
+    /**
+     * @brief Writes `size` bytes from `src` as one frame. Each chunk is
+     * written with a single atomic `write`. In non-blocking mode, the call
+     * fails with `EAGAIN` if the first chunk does not fit; once the first
+     * chunk is written, the remaining chunks are written as space becomes
+     * available. If no space becomes available for `timeout`, the frame is
+     * abandoned and the call fails with `EAGAIN`; the reader discards the
+     * partial frame when the next frame from this producer starts.
+     *
+     * @param src The frame contents
+     * @param size The size of the frame in bytes
+     * @param timeout The maximum time to wait for space for each continuation
+     * chunk in non-blocking mode
+     * @return ssize_t `size` on success, or -1 on error (`EMSGSIZE` if the frame
+     * is too large and chunking is disabled).
+     */
+    ssize_t write_frame(const uint8_t *src, size_t size,
+                        const util::Duration &timeout = util::Duration::max()) const;
+
+    /**
+     * @brief Reads the next complete frame from any producer. In blocking
+     * mode, waits until a frame is complete. In non-blocking mode, returns
+     * false with `errno` set to `EAGAIN` if no frame is complete yet; partial
+     * frames are kept and completed by later calls.
+     *
+     * A chunk that does not fit its producer's frame (a continuation without
+     * a first chunk, or a size mismatch) is dropped along with that frame, and
+     * reading continues with the other producers (see `malformed`).
+     *
+     * @param frame Set to the frame and the id of its producer
+     * @return true if a frame was read. False on error, at end of stream, or
+     * if a chunk header is corrupt and the stream can not be realigned
+     * (`EPROTO`).
+     */
+    bool read_frame(Frame &frame);
+
+    /**
+     * @brief Returns the producer id written with every frame.
+     *
+     */
+    uint32_t producer_id() const;
+
+    /**
+     * @brief Returns the number of malformed chunks dropped by `read_frame`.
+     *
+     */
+    uint64_t malformed() const;
+
+   private:
+    FramedFifo(int fd, const std::string &pathname, uint32_t producer_id);
+
+    int next_chunk(Frame &frame, bool &complete);
+
+    uint32_t producer_id_;
+    bool chunking_;
+    std::vector<uint8_t> rx_;                                   /**< Bytes read but not yet parsed */
+    size_t rx_offset_;                                          /**< Start of the unparsed bytes */
+    std::unordered_map<uint32_t, std::vector<uint8_t>> partial_; /**< Frames being reassembled */
+    uint64_t malformed_;                                        /**< Chunks dropped by read_frame */
+};
+
+}  // namespace ipc
+}  // namespace rix
@@ -1,4 +1,6 @@
 #pragma once
+#include <sys/uio.h>
+
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -21,6 +23,8 @@ class IO {
 
     virtual ssize_t read(uint8_t *buffer, size_t len) const = 0;
     virtual ssize_t write(const uint8_t *buffer, size_t len) const = 0;
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt) const = 0;
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt) const = 0;
     virtual bool wait_for_writable(const rix::util::Duration &duration) const = 0;
     virtual bool wait_for_readable(const rix::util::Duration &duration) const = 0;
     virtual void set_nonblocking(bool status) = 0;
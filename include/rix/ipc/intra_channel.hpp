@@ -0,0 +1,479 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rix/ipc/interfaces/io.hpp"
+#include "rix/msg/serialization.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class IntraChannel
+ * @brief Single-producer/single-consumer channel that passes
+ * `std::shared_ptr<const T>` messages between threads of the same process
+ * without serializing them.
+ *
+ * @details Use the factory method `IntraChannel::create` to get a connected
+ * pair of ends. The ends share a bounded lock-free ring of message pointers:
+ * `push` and `pop` never take a lock or make a system call. A mutex and
+ * condition variable are only used when one side blocks in
+ * `wait_for_readable` or `wait_for_writable`, and the other side only touches
+ * them when it sees that a waiter is present.
+ *
+ * Both ends also implement `interfaces::IO` with the usual stream framing (a
+ * 4-byte size prefix followed by the serialized message), so a channel can be
+ * passed to code that only knows about byte streams. `TeleopKeyboard` and
+ * `MBotDriver` detect an IntraChannel and use the typed `push`/`pop` instead,
+ * so colocated components exchange commands without any serialization, while
+ * out-of-process peers keep using a `Fifo` or standard IO.
+ *
+ * @tparam T The message type (derived from `rix::msg::Message`)
+ */
+template <typename T>
+class IntraChannel : public interfaces::IO {
+   public:
+    enum class Mode : int {
+        WRITE,
+        READ
+    };
+
+    /**
+     * @brief Factory method to create a connected pair of channel ends. The
+     * first element is the read end and the second is the write end.
+     *
+     * @param capacity The minimum number of queued messages, rounded up to a
+     * power of two
+     */
+    static std::array<IntraChannel, 2> create(size_t capacity = 64) {
+        size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        auto state = std::make_shared<State>(cap);
+        return {IntraChannel(state, Mode::READ), IntraChannel(state, Mode::WRITE)};
+    }
+
+    /**
+     * @brief Default constructor. Not connected to a channel.
+     *
+     */
+    IntraChannel() : state_(), mode_(Mode::READ), nonblocking_(false), bytes_(), bytes_offset_(0), backlog_() {}
+
+    /**
+     * @brief Copy constructor is deleted because each end must have exactly
+     * one user.
+     */
+    IntraChannel(const IntraChannel &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because each end must have
+     * exactly one user.
+     */
+    IntraChannel &operator=(const IntraChannel &other) = delete;
+
+    /**
+     * @brief Move constructor. Moves the end to the destination and
+     * invalidates the source.
+     *
+     * @param other The IntraChannel to be moved
+     */
+    IntraChannel(IntraChannel &&other) : IntraChannel() { *this = std::move(other); }
+
+    /**
+     * @brief Move assignment operator. If the destination is valid, it is
+     * closed first.
+     *
+     * @param other The IntraChannel to be moved
+     */
+    IntraChannel &operator=(IntraChannel &&other) {
+        if (this == &other) {
+            return *this;
+        }
+        close();
+        state_ = std::move(other.state_);
+        mode_ = other.mode_;
+        nonblocking_ = other.nonblocking_;
+        bytes_ = std::move(other.bytes_);
+        bytes_offset_ = other.bytes_offset_;
+        backlog_ = std::move(other.backlog_);
+        other.bytes_offset_ = 0;
+        return *this;
+    }
+
+    /**
+     * @brief Destructor. Marks this end as closed and wakes the peer, like
+     * closing one end of a pipe.
+     *
+     */
+    virtual ~IntraChannel() { close(); }
+
+    /**
+     * @brief Queues `msg` for the reader without copying or serializing it.
+     * Never blocks.
+     *
+     * @param msg The message to send
+     * @return true if the message was queued. False with `errno` set to
+     * `EAGAIN` if the channel is full, `EPIPE` if the read end is closed, or
+     * `EBADF` if this is not a valid write end.
+     */
+    bool push(std::shared_ptr<const T> msg) const {
+        if (!state_ || mode_ != Mode::WRITE) {
+            errno = EBADF;
+            return false;
+        }
+        State &s = *state_;
+        if (s.reader_closed.load(std::memory_order_acquire)) {
+            errno = EPIPE;
+            return false;
+        }
+        const uint64_t tail = s.tail.load(std::memory_order_relaxed);
+        if (tail - s.head.load(std::memory_order_acquire) >= s.slots.size()) {
+            errno = EAGAIN;
+            return false;
+        }
+        s.slots[tail & s.mask] = std::move(msg);
+        s.tail.store(tail + 1, std::memory_order_seq_cst);
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Takes the next message from the channel. Never blocks.
+     *
+     * @param msg Set to the message
+     * @return true if a message was received. False with `errno` set to
+     * `EAGAIN` if the channel is empty, 0 if it is empty and the write end is
+     * closed, or `EBADF` if this is not a valid read end.
+     */
+    bool pop(std::shared_ptr<const T> &msg) const {
+        if (!state_ || mode_ != Mode::READ) {
+            errno = EBADF;
+            return false;
+        }
+        State &s = *state_;
+        const uint64_t head = s.head.load(std::memory_order_relaxed);
+        if (head == s.tail.load(std::memory_order_acquire)) {
+            errno = s.writer_closed.load(std::memory_order_acquire) ? 0 : EAGAIN;
+            return false;
+        }
+        msg = std::move(s.slots[head & s.mask]);
+        s.head.store(head + 1, std::memory_order_seq_cst);
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of queued messages.
+     *
+     */
+    size_t size() const {
+        if (!state_) {
+            return 0;
+        }
+        return state_->tail.load(std::memory_order_acquire) - state_->head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the maximum number of queued messages.
+     *
+     */
+    size_t capacity() const { return state_ ? state_->slots.size() : 0; }
+
+    /**
+     * @brief Returns true if the other end of the channel has been destroyed.
+     *
+     */
+    bool closed() const {
+        if (!state_) {
+            return true;
+        }
+        return mode_ == Mode::READ ? state_->writer_closed.load() : state_->reader_closed.load();
+    }
+
+    /**
+     * @brief Returns `true` if this end is connected to a channel.
+     *
+     */
+    bool ok() const { return state_ != nullptr; }
+
+    /**
+     * @brief Returns the mode of this end.
+     *
+     */
+    Mode mode() const { return mode_; }
+
+    /**
+     * @brief Reads framed, serialized messages (read end only). Each message
+     * is serialized as a 4-byte size prefix followed by its contents.
+     *
+     * @param dst The destination byte array
+     * @param size The maximum number of bytes to read
+     * @return ssize_t The number of bytes read, 0 if the write end is closed and
+     * the channel is empty, or -1 on error (`EAGAIN` in non-blocking mode).
+     */
+    virtual ssize_t read(uint8_t *dst, size_t size) const override {
+        if (!state_ || mode_ != Mode::READ) {
+            errno = EBADF;
+            return -1;
+        }
+        while (bytes_offset_ == bytes_.size()) {
+            bytes_.clear();
+            bytes_offset_ = 0;
+            std::shared_ptr<const T> msg;
+            if (pop(msg)) {
+                const uint32_t n = static_cast<uint32_t>(msg->size());
+                bytes_.resize(4 + n);
+                size_t offset = 0;
+                rix::msg::detail::serialize_number<uint32_t>(bytes_.data(), offset, n);
+                msg->serialize(bytes_.data(), offset);
+                break;
+            }
+            if (errno == 0) {
+                return 0;
+            }
+            if (nonblocking_) {
+                errno = EAGAIN;
+                return -1;
+            }
+            wait_for_readable(util::Duration::max());
+        }
+        const size_t n = std::min(size, bytes_.size() - bytes_offset_);
+        std::memcpy(dst, bytes_.data() + bytes_offset_, n);
+        bytes_offset_ += n;
+        return static_cast<ssize_t>(n);
+    }
+
+    /**
+     * @brief Writes framed, serialized messages (write end only). Complete
+     * frames are deserialized and queued; incomplete frames are kept until
+     * the rest arrives.
+     *
+     * @param src The source byte array
+     * @param size The number of bytes to write
+     * @return ssize_t `size` on success, or -1 on error (`EAGAIN` in
+     * non-blocking mode if earlier messages are still waiting for space,
+     * `EPIPE` if the read end is closed).
+     */
+    virtual ssize_t write(const uint8_t *src, size_t size) const override {
+        if (!state_ || mode_ != Mode::WRITE) {
+            errno = EBADF;
+            return -1;
+        }
+        if (!drain_backlog()) {
+            return -1;
+        }
+
+        bytes_.insert(bytes_.end(), src, src + size);
+        while (bytes_.size() - bytes_offset_ >= 4) {
+            uint32_t n = 0;
+            size_t offset = bytes_offset_;
+            rix::msg::detail::deserialize_number<uint32_t>(n, bytes_.data(), bytes_.size(), offset);
+            if (bytes_.size() - offset < n) {
+                break;
+            }
+            auto msg = std::make_shared<T>();
+            size_t end = offset;
+            bool valid = msg->deserialize(bytes_.data(), offset + n, end);
+            bytes_offset_ = offset + n;
+            if (valid) {
+                backlog_.push_back(std::move(msg));
+            }
+        }
+        bytes_.erase(bytes_.begin(), bytes_.begin() + bytes_offset_);
+        bytes_offset_ = 0;
+
+        // The bytes have been consumed; queued messages that do not fit yet
+        // are delivered by the next write in non-blocking mode
+        if (!drain_backlog() && errno != EAGAIN) {
+            return -1;
+        }
+        return static_cast<ssize_t>(size);
+    }
+
+    /**
+     * @brief Reads into `iovcnt` buffers, filling each buffer in order.
+     *
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt) const override {
+        ssize_t total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            if (iov[i].iov_len == 0) continue;
+            ssize_t n = read(static_cast<uint8_t *>(iov[i].iov_base), iov[i].iov_len);
+            if (n <= 0) return total > 0 ? total : n;
+            total += n;
+            if (static_cast<size_t>(n) < iov[i].iov_len || bytes_offset_ == bytes_.size()) break;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Writes the contents of `iovcnt` buffers. See `write`.
+     *
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt) const override {
+        ssize_t total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            ssize_t n = write(static_cast<const uint8_t *>(iov[i].iov_base), iov[i].iov_len);
+            if (n < 0) return total > 0 ? total : n;
+            total += n;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Waits for the specified duration for a message to arrive (or for
+     * the write end to close).
+     *
+     * @param duration The maximum duration to wait.
+     * @return true if the channel has become readable within the duration.
+     */
+    virtual bool wait_for_readable(const util::Duration &duration) const override {
+        if (!state_ || mode_ != Mode::READ) {
+            return false;
+        }
+        if (bytes_offset_ < bytes_.size()) {
+            return true;
+        }
+        State &s = *state_;
+        return wait(duration, [&s]() {
+            return s.tail.load(std::memory_order_seq_cst) != s.head.load(std::memory_order_seq_cst) ||
+                   s.writer_closed.load(std::memory_order_seq_cst);
+        });
+    }
+
+    /**
+     * @brief Waits for the specified duration for space to become available
+     * (or for the read end to close).
+     *
+     * @param duration The maximum duration to wait.
+     * @return true if the channel has become writable within the duration.
+     */
+    virtual bool wait_for_writable(const util::Duration &duration) const override {
+        if (!state_ || mode_ != Mode::WRITE) {
+            return false;
+        }
+        State &s = *state_;
+        return wait(duration, [&s]() {
+            return s.tail.load(std::memory_order_seq_cst) - s.head.load(std::memory_order_seq_cst) < s.slots.size() ||
+                   s.reader_closed.load(std::memory_order_seq_cst);
+        });
+    }
+
+    /**
+     * @brief Toggles non-blocking mode for the byte stream `read` and `write`.
+     * `push` and `pop` never block.
+     *
+     */
+    virtual void set_nonblocking(bool status) override { nonblocking_ = status; }
+
+    /**
+     * @brief Returns true if the byte stream is in non-blocking mode.
+     *
+     */
+    virtual bool is_nonblocking() const override { return nonblocking_; }
+
+   private:
+    struct State {
+        explicit State(size_t capacity) : slots(capacity), mask(capacity - 1) {}
+
+        std::vector<std::shared_ptr<const T>> slots;
+        const uint64_t mask;
+        alignas(64) std::atomic<uint64_t> tail{0};  /**< Messages ever pushed (writer) */
+        alignas(64) std::atomic<uint64_t> head{0};  /**< Messages ever popped (reader) */
+        alignas(64) std::atomic<bool> writer_closed{false};
+        std::atomic<bool> reader_closed{false};
+        std::atomic<uint32_t> waiters{0};           /**< Nonzero while a side is blocked */
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    IntraChannel(std::shared_ptr<State> state, Mode mode)
+        : state_(std::move(state)), mode_(mode), nonblocking_(false), bytes_(), bytes_offset_(0), backlog_() {}
+
+    void close() {
+        if (!state_) {
+            return;
+        }
+        if (mode_ == Mode::WRITE) {
+            state_->writer_closed.store(true, std::memory_order_seq_cst);
+        } else {
+            state_->reader_closed.store(true, std::memory_order_seq_cst);
+        }
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+        }
+        state_->cv.notify_all();
+        state_.reset();
+        bytes_.clear();
+        bytes_offset_ = 0;
+        backlog_.clear();
+    }
+
+    void wake() const {
+        // Only take the lock if the peer may be sleeping
+        if (state_->waiters.load(std::memory_order_seq_cst) != 0) {
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+            }
+            state_->cv.notify_all();
+        }
+    }
+
+    template <typename Predicate>
+    bool wait(const util::Duration &duration, Predicate ready) const {
+        if (ready()) {
+            return true;
+        }
+        State &s = *state_;
+        std::unique_lock<std::mutex> lock(s.mutex);
+        s.waiters.fetch_add(1, std::memory_order_seq_cst);
+        bool result;
+        const auto ns = std::chrono::nanoseconds(std::max<int64_t>(duration.to_nanoseconds(), 0));
+        if (ns >= std::chrono::hours(24 * 365)) {
+            s.cv.wait(lock, ready);
+            result = true;
+        } else {
+            result = s.cv.wait_for(lock, ns, ready);
+        }
+        s.waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return result;
+    }
+
+    // Pushes decoded messages from the byte stream, waiting for space in
+    // blocking mode. Returns false (EAGAIN or EPIPE) if messages remain.
+    bool drain_backlog() const {
+        while (!backlog_.empty()) {
+            if (push(backlog_.front())) {
+                backlog_.pop_front();
+                continue;
+            }
+            if (errno != EAGAIN || nonblocking_) {
+                return false;
+            }
+            wait_for_writable(util::Duration::max());
+        }
+        return true;
+    }
+
+    std::shared_ptr<State> state_;
+    Mode mode_;
+    bool nonblocking_;
+    mutable std::vector<uint8_t> bytes_;                     /**< Byte stream staging (read or write side) */
+    mutable size_t bytes_offset_;
+    mutable std::deque<std::shared_ptr<const T>> backlog_;  /**< Decoded messages waiting for space */
+};
+
+}  // namespace ipc
+}  // namespace rix
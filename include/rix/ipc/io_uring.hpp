@@ -0,0 +1,281 @@
+#pragma once
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "rix/ipc/file.hpp"
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class IOUring
+ * @brief Completion-driven I/O engine built directly on the Linux io_uring
+ * system calls. This is an optional alternative to the synchronous
+ * `File::read`/`File::write` path that works with any `File`, including `Pipe`
+ * and `Fifo` objects.
+ *
+ * @details Requests are queued with the `prepare_*` methods and are not seen by
+ * the kernel until `submit` is called, so many reads and writes can be issued
+ * with a single system call. Each request carries a caller-chosen `user_data`
+ * value that is returned in the matching `Completion`. Completions are reaped
+ * from shared memory with `peek` (no system call) or `wait`.
+ *
+ * Files and buffers can be registered with the kernel ahead of time using
+ * `register_files` and `register_buffers`. Fixed files are referred to by
+ * their index in the registered set, and fixed buffers by their index in the
+ * registered set of buffers, which avoids the per-request file reference and
+ * page pinning costs.
+ *
+ * For example, the following reads the first 64 bytes of a file:
+ *
+ *     IOUring ring(8);
+ *     File f("my_file.txt", O_RDONLY);
+ *     uint8_t buf[64];
+ *     ring.prepare_read(f, buf, sizeof(buf), 1, 0);
+ *     ring.submit();
+ *     IOUring::Completion c;
+ *     if (ring.wait(c, rix::util::Duration(1.0))) {
+ *         // c.user_data == 1, c.result is the number of bytes read or -errno
+ *     }
+ *
+ * If the kernel does not support io_uring (or it is disabled), the object is
+ * left in an invalid state and `ok` returns `false`.
+ */
+class IOUring {
+   public:
+    /**
+     * @brief Result of a completed request.
+     *
+     */
+    struct Completion {
+        uint64_t user_data; /**< The value passed to the `prepare_*` method */
+        int32_t result;     /**< Bytes transferred, or -errno on failure */
+        uint32_t flags;     /**< io_uring completion flags */
+    };
+
+    /**
+     * @brief Creates an io_uring instance with room for `entries` outstanding
+     * submissions. The kernel rounds `entries` up to a power of two. An
+     * `entries` value of 0 creates an invalid IOUring.
+     *
+     * @param entries The submission queue depth
+     */
+    explicit IOUring(unsigned entries = 64);
+
+    /**
+     * @brief Copy constructor is deleted because the rings are mapped into
+     * this process and shared with the kernel.
+     */
+    IOUring(const IOUring &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because the rings are mapped into
+     * this process and shared with the kernel.
+     */
+    IOUring &operator=(const IOUring &other) = delete;
+
+    /**
+     * @brief Move constructor. Moves the rings to the destination and
+     * invalidates the source.
+     *
+     * @param other The IOUring to be moved
+     */
+    IOUring(IOUring &&other);
+
+    /**
+     * @brief Move assignment operator. If the destination is valid, it is
+     * released first. Moves the rings to the destination and invalidates the
+     * source.
+     *
+     * @param other The IOUring to be moved
+     */
+    IOUring &operator=(IOUring &&other);
+
+    /**
+     * @brief Destructor. Unmaps the rings and closes the io_uring descriptor.
+     *
+     */
+    ~IOUring();
+
+    /**
+     * @brief Returns `true` if the io_uring instance was set up successfully.
+     *
+     */
+    bool ok() const;
+
+    /**
+     * @brief Registers a set of files with the kernel. The position of each
+     * file in `files` is its fixed file index. Any previously registered set
+     * must be unregistered first.
+     *
+     * @param files The files to register
+     * @return true if the files were registered.
+     */
+    bool register_files(const std::vector<const File *> &files);
+
+    /**
+     * @brief Unregisters the set of fixed files.
+     *
+     */
+    bool unregister_files();
+
+    /**
+     * @brief Registers a set of buffers with the kernel. The position of each
+     * buffer in `buffers` is its fixed buffer index. The memory must remain
+     * valid until the buffers are unregistered.
+     *
+     * @param buffers The buffers to register
+     * @return true if the buffers were registered.
+     */
+    bool register_buffers(const std::vector<struct iovec> &buffers);
+
+    /**
+     * @brief Unregisters the set of fixed buffers.
+     *
+     */
+    bool unregister_buffers();
+
+    /**
+     * @brief Queues a read of `size` bytes from `file` into `dst`. `dst` must
+     * remain valid until the request completes.
+     *
+     * @param file The file to read from
+     * @param dst The destination byte array
+     * @param size The number of bytes to read
+     * @param user_data Value returned in the matching Completion
+     * @param offset File offset to read from, or -1 to use (and advance) the
+     * current file position. Pipes and Fifos must use -1.
+     * @return false if the submission queue is full or the ring is invalid.
+     */
+    bool prepare_read(const File &file, uint8_t *dst, size_t size, uint64_t user_data, int64_t offset = -1);
+
+    /**
+     * @brief Queues a write of `size` bytes from `src` to `file`. `src` must
+     * remain valid until the request completes.
+     *
+     * @param file The file to write to
+     * @param src The source byte array
+     * @param size The number of bytes to write
+     * @param user_data Value returned in the matching Completion
+     * @param offset File offset to write to, or -1 to use (and advance) the
+     * current file position. Pipes and Fifos must use -1.
+     * @return false if the submission queue is full or the ring is invalid.
+     */
+    bool prepare_write(const File &file, const uint8_t *src, size_t size, uint64_t user_data, int64_t offset = -1);
+
+    /**
+     * @brief Queues a read from a registered file. If `buffer_index` is not
+     * negative, `dst` must lie within that registered buffer.
+     *
+     * @param file_index Index of the file in the registered set
+     * @param dst The destination byte array
+     * @param size The number of bytes to read
+     * @param buffer_index Index of the registered buffer containing `dst`, or
+     * -1 if `dst` is not a registered buffer
+     * @param user_data Value returned in the matching Completion
+     * @param offset File offset to read from, or -1 for the current position
+     * @return false if the submission queue is full or the ring is invalid.
+     */
+    bool prepare_read_fixed(unsigned file_index, uint8_t *dst, size_t size, int buffer_index, uint64_t user_data,
+                            int64_t offset = -1);
+
+    /**
+     * @brief Queues a write to a registered file. If `buffer_index` is not
+     * negative, `src` must lie within that registered buffer.
+     *
+     * @param file_index Index of the file in the registered set
+     * @param src The source byte array
+     * @param size The number of bytes to write
+     * @param buffer_index Index of the registered buffer containing `src`, or
+     * -1 if `src` is not a registered buffer
+     * @param user_data Value returned in the matching Completion
+     * @param offset File offset to write to, or -1 for the current position
+     * @return false if the submission queue is full or the ring is invalid.
+     */
+    bool prepare_write_fixed(unsigned file_index, const uint8_t *src, size_t size, int buffer_index,
+                             uint64_t user_data, int64_t offset = -1);
+
+    /**
+     * @brief Submits all queued requests to the kernel with a single system
+     * call, optionally blocking until at least `wait_nr` requests complete.
+     *
+     * @param wait_nr The number of completions to wait for
+     * @return int The number of requests submitted, or -1 on error.
+     */
+    int submit(unsigned wait_nr = 0);
+
+    /**
+     * @brief Returns the number of requests queued but not yet submitted.
+     *
+     */
+    unsigned pending() const;
+
+    /**
+     * @brief Reaps up to `max` available completions without a system call and
+     * appends them to `out`.
+     *
+     * @param out The vector to append completions to
+     * @param max The maximum number of completions to reap
+     * @return size_t The number of completions reaped.
+     */
+    size_t peek(std::vector<Completion> &out, size_t max = SIZE_MAX);
+
+    /**
+     * @brief Waits for the specified duration for a completion. Any queued
+     * requests are submitted first.
+     *
+     * @param completion The reaped completion
+     * @param duration The maximum duration to wait
+     * @return true if a completion was reaped within the duration.
+     */
+    bool wait(Completion &completion, const rix::util::Duration &duration);
+
+    /**
+     * @brief Returns the io_uring file descriptor. It becomes readable when
+     * completions are available.
+     *
+     */
+    int fd() const;
+
+   private:
+    struct io_uring_sqe *next_sqe();
+    bool prepare_rw(uint8_t opcode, int fd, uint64_t addr, size_t size, uint64_t user_data, int64_t offset,
+                    uint8_t sqe_flags, int buffer_index);
+    bool pop_completion(Completion &completion);
+    void release();
+
+    File ring_;
+
+    void *sq_ring_;
+    size_t sq_ring_size_;
+    void *cq_ring_;
+    size_t cq_ring_size_;
+    struct io_uring_sqe *sqes_;
+    size_t sqes_size_;
+
+    unsigned *sq_head_;
+    unsigned *sq_tail_;
+    unsigned *sq_mask_;
+    unsigned *sq_array_;
+    unsigned *cq_head_;
+    unsigned *cq_tail_;
+    unsigned *cq_mask_;
+    struct io_uring_cqe *cqes_;
+
+    unsigned sq_entries_;
+    unsigned sqe_tail_;    /**< Local tail: SQEs prepared but not yet published */
+    unsigned sqe_head_;    /**< Local head: first SQE not yet published */
+    bool files_registered_;
+    bool buffers_registered_;
+};
+
+}  // namespace ipc
+}  // namespace rix
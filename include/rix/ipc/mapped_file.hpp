@@ -0,0 +1,200 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "rix/ipc/file.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class MappedFile
+ * @brief Object representing a file that is mapped into memory with `mmap`.
+ * The contents are exposed as a `std::span`, so large read-mostly data (such as
+ * recorded command logs) can be scanned without `read` system calls or copies
+ * into intermediate buffers. Pages are faulted in on first access.
+ *
+ * @details Messages can be deserialized directly from the mapping:
+ *
+ *     MappedFile log("commands.bin", MappedFile::Mode::READ);
+ *     log.advise(MappedFile::Advice::SEQUENTIAL);
+ *     auto bytes = log.data();
+ *     size_t offset = 0;
+ *     rix::msg::geometry::Twist2DStamped msg;
+ *     while (msg.deserialize(bytes.data(), bytes.size(), offset)) { ... }
+ *
+ * In READ_WRITE mode the contents can be written through `writable_data`, the
+ * file is created if it does not exist, and `resize` grows (or shrinks) both
+ * the file and the mapping with `mremap`. Growing may move the mapping, so
+ * spans obtained before a `resize` must not be used afterwards.
+ *
+ */
+class MappedFile {
+   public:
+    enum class Mode : int {
+        READ,
+        READ_WRITE
+    };
+
+    enum class Advice : int {
+        NORMAL = MADV_NORMAL,
+        SEQUENTIAL = MADV_SEQUENTIAL,
+        RANDOM = MADV_RANDOM,
+        WILLNEED = MADV_WILLNEED,
+        DONTNEED = MADV_DONTNEED
+    };
+
+    /**
+     * @brief Default constructor. Does not map a file.
+     *
+     */
+    MappedFile();
+
+    /**
+     * @brief Opens and maps the file specified by `pathname`. In READ mode the
+     * whole file is mapped read-only and `size` is ignored. In READ_WRITE mode
+     * the file is created with permissions 0644 if it does not exist, and is
+     * extended to at least `size` bytes before it is mapped.
+     *
+     * @details If `huge_pages` is set, the mapping is placed on a huge page
+     * boundary and transparent huge pages are requested with `madvise`. This
+     * is a hint: the kernel only backs the mapping with huge pages when the
+     * underlying file system supports it.
+     *
+     * @param pathname The path name of the file to be mapped
+     * @param mode The mode to map the file with (READ or READ_WRITE)
+     * @param size The minimum size of the file in READ_WRITE mode
+     * @param huge_pages Flag to request huge page alignment and backing
+     */
+    MappedFile(const std::string &pathname, Mode mode, size_t size = 0, bool huge_pages = false);
+
+    /**
+     * @brief Copy constructor is deleted because each mapping must have exactly
+     * one owner.
+     */
+    MappedFile(const MappedFile &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because each mapping must have
+     * exactly one owner.
+     */
+    MappedFile &operator=(const MappedFile &other) = delete;
+
+    /**
+     * @brief Move constructor. Moves the mapping to the destination and
+     * invalidates the source.
+     *
+     * @param other The MappedFile to be moved
+     */
+    MappedFile(MappedFile &&other);
+
+    /**
+     * @brief Move assignment operator. If the destination is valid, it is
+     * unmapped first. Moves the mapping to the destination and invalidates the
+     * source.
+     *
+     * @param other The MappedFile to be moved
+     */
+    MappedFile &operator=(MappedFile &&other);
+
+    /**
+     * @brief Destructor. Unmaps the file and closes the file descriptor.
+     *
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Returns the mapped contents as read-only bytes. The span is empty
+     * if the object is invalid or the file is empty.
+     *
+     */
+    std::span<const uint8_t> data() const;
+
+    /**
+     * @brief Returns the mapped contents for writing. The span is empty if the
+     * object is invalid, the file is empty or the mode is READ, since the
+     * pages of a READ mapping cannot be written.
+     *
+     */
+    std::span<uint8_t> writable_data();
+
+    /**
+     * @brief Returns the size of the mapping in bytes.
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Changes the size of the file (READ_WRITE mode only) and remaps it.
+     * Existing contents up to the smaller of the old and new sizes are kept.
+     *
+     * @param size The new size in bytes
+     * @return true if the file was resized and remapped.
+     */
+    bool resize(size_t size);
+
+    /**
+     * @brief Remaps the file at its current size on disk. This is used to pick
+     * up data that another process has appended since the file was mapped.
+     *
+     * @return true if the mapping reflects the current file size.
+     */
+    bool remap();
+
+    /**
+     * @brief Gives the kernel a hint about the access pattern for a range of
+     * the mapping using `madvise`.
+     *
+     * @param advice The expected access pattern
+     * @param offset The start of the range (rounded down to a page boundary)
+     * @param length The length of the range, or 0 for the rest of the mapping
+     * @return true if the hint was accepted.
+     */
+    bool advise(Advice advice, size_t offset = 0, size_t length = 0) const;
+
+    /**
+     * @brief Flushes modified pages back to the file using `msync`.
+     *
+     * @param blocking If true, waits until the write-back has completed.
+     * @return true on success.
+     */
+    bool sync(bool blocking = true) const;
+
+    /**
+     * @brief Returns `true` if the file is open and mapped, `false` otherwise.
+     *
+     */
+    bool ok() const;
+
+    /**
+     * @brief Returns the mode of the mapping.
+     *
+     */
+    Mode mode() const;
+
+    /**
+     * @brief Returns the underlying file descriptor.
+     *
+     */
+    int fd() const;
+
+   private:
+    bool map(size_t size);
+    void unmap();
+    int protection() const;
+
+    File file_;
+    Mode mode_;
+    bool huge_pages_;
+    uint8_t *data_;
+    size_t size_;
+};
+
+}  // namespace ipc
+}  // namespace rix
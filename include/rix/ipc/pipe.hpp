@@ -1,5 +1,9 @@
 #pragma once
 
+#include <fcntl.h>
+
+#include <array>
+
 #include "rix/ipc/file.hpp"
 
 namespace rix {
@@ -19,9 +23,34 @@ class Pipe : public File {
     * @brief Factory method to create a pair of Pipe objects. The first element
     * is the read-end and the second is the write-end.
     * 
+    * @param capacity The requested pipe capacity in bytes (`F_SETPIPE_SZ`), or
+    * 0 to keep the system default. The kernel may round the capacity up; if it
+    * cannot be applied, the pipe keeps its default capacity.
     * @return std::array<Pipe, 2> The pipe pair
     */
-    static std::array<Pipe, 2> create();
+    static std::array<Pipe, 2> create(size_t capacity = 0);
+
+   /**
+    * @brief Moves up to `size` bytes from `src` to `dst` without copying them
+    * through user space. If neither file is a pipe, the bytes are staged in
+    * a pipe that is kept for later calls on the same thread. Unless `src` is
+    * a regular file, this returns after the first bytes are moved, like
+    * read(2), instead of waiting for `size` bytes. Staged bytes are always written to `dst` (waiting up
+    * to a second at a time for it to become writable if it is non-blocking),
+    * and -1 is returned if that fails (`EAGAIN` if `dst` did not drain), in
+    * which case the staged bytes are lost since they can no longer be read
+    * again from `src`. Reads from the current position of `src` and writes at
+    * the current position of `dst`.
+    * 
+    * @param src The source file
+    * @param dst The destination file
+    * @param size The maximum number of bytes to move
+    * @return ssize_t The number of bytes moved, or -1 on error (including
+    * `EAGAIN` if a non-blocking `src` has no data). If reading from `src`
+    * fails after some bytes were moved, the short count is returned and
+    * `errno` is set.
+    */
+    static ssize_t transfer(const File &src, const File &dst, size_t size);
 
     /**
      * @brief Default constructor. This does not open a file descriptor. The 
@@ -77,11 +106,73 @@ class Pipe : public File {
     bool is_read_end() const;
     
     /**
-     * @brief Returns `true` if this Pipe is the read end.
+     * @brief Returns `true` if this Pipe is the write end.
      * 
      */
     bool is_write_end() const;
 
+    /**
+     * @brief Returns the capacity of the pipe in bytes, or -1 on error.
+     * 
+     */
+    ssize_t capacity() const;
+
+    /**
+     * @brief Sets the capacity of the pipe (`F_SETPIPE_SZ`). The kernel may
+     * round the capacity up to a multiple of the page size.
+     * 
+     * @param capacity The requested capacity in bytes
+     * @return true if the capacity was changed.
+     */
+    bool set_capacity(size_t capacity);
+
+    /**
+     * @brief Moves up to `size` bytes from `src` into this pipe without
+     * copying them through user space. This must be the write end.
+     * 
+     * @param src The source file
+     * @param size The maximum number of bytes to move
+     * @param offset The offset in `src` to read from, or -1 to read from (and
+     * advance) the current position. Must be -1 if `src` is a pipe.
+     * @return ssize_t The number of bytes moved, 0 at end of input, or -1 on
+     * error.
+     */
+    ssize_t splice_from(const File &src, size_t size, int64_t offset = -1) const;
+
+    /**
+     * @brief Moves up to `size` bytes from this pipe into `dst` without
+     * copying them through user space. This must be the read end.
+     * 
+     * @param dst The destination file
+     * @param size The maximum number of bytes to move
+     * @param offset The offset in `dst` to write to, or -1 to write at (and
+     * advance) the current position. Must be -1 if `dst` is a pipe.
+     * @return ssize_t The number of bytes moved, or -1 on error.
+     */
+    ssize_t splice_to(const File &dst, size_t size, int64_t offset = -1) const;
+
+    /**
+     * @brief Maps the user pages holding `src` into this pipe instead of
+     * copying them. This must be the write end. The contents of `src` must
+     * not be modified until the data has been consumed from the pipe.
+     * 
+     * @param src The source byte array
+     * @param size The number of bytes to map
+     * @return ssize_t The number of bytes mapped, or -1 on error.
+     */
+    ssize_t vmsplice(const uint8_t *src, size_t size) const;
+
+    /**
+     * @brief Duplicates up to `size` bytes from this pipe into `dst` without
+     * consuming them. This must be the read end, and `dst` must be the write
+     * end of another pipe.
+     * 
+     * @param dst The write end of the destination pipe
+     * @param size The maximum number of bytes to duplicate
+     * @return ssize_t The number of bytes duplicated, or -1 on error.
+     */
+    ssize_t tee(const Pipe &dst, size_t size) const;
+
    private:
     /**
      * @brief Private constructor used by the `create` factory method.
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rix/ipc/framed_fifo.hpp"
+#include "rix/ipc/topic.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class Publisher
+ * @brief Publishes messages of type `T` on a named topic to every subscriber
+ * of the same message type, without a broker process.
+ *
+ * @details Each subscriber owns a FIFO in the topic directory (see `Topic`).
+ * `publish` serializes the message once and writes it to every matching FIFO
+ * as an atomic `FramedFifo` frame, so any number of publishers may share a
+ * topic. Writes are non-blocking: a subscriber whose FIFO is full misses the
+ * message instead of stalling the publisher and the other subscribers. This
+ * includes messages larger than `FramedFifo::MAX_CHUNK_SIZE` whose FIFO fills
+ * up part way through; the subscriber discards the partial frame.
+ *
+ *     Publisher<rix::msg::geometry::Twist2DStamped> pub("cmd_vel");
+ *     pub.publish(msg);
+ *
+ * @tparam T The message type (derived from `rix::msg::Message`)
+ */
+template <typename T>
+class Publisher {
+   public:
+    /**
+     * @brief Default constructor. Does not refer to a topic.
+     *
+     */
+    Publisher() : topic_(), subscribers_(), buffer_() {}
+
+    /**
+     * @brief Creates a publisher on the topic specified by `name`.
+     *
+     * @param name The topic name (see `Topic::Topic`)
+     * @param root The directory in which topics are created
+     */
+    Publisher(const std::string &name, const std::string &root = Topic::default_root())
+        : topic_(name, T().hash(), root), subscribers_(), buffer_() {}
+
+    /**
+     * @brief Publishes `msg` to every current subscriber.
+     *
+     * @param msg The message to publish
+     * @return ssize_t The number of subscribers the message was delivered to,
+     * or -1 if the publisher is invalid.
+     */
+    ssize_t publish(const T &msg) {
+        if (!topic_.ok()) {
+            errno = EBADF;
+            return -1;
+        }
+        refresh();
+
+        buffer_.resize(msg.size());
+        size_t offset = 0;
+        msg.serialize(buffer_.data(), offset);
+
+        ssize_t delivered = 0;
+        for (auto &[path, fifo] : subscribers_) {
+            const ssize_t n = fifo.write_frame(buffer_.data(), buffer_.size(), util::Duration(0.0));
+            if (n == static_cast<ssize_t>(buffer_.size())) {
+                delivered++;
+            }
+        }
+        return delivered;
+    }
+
+    /**
+     * @brief Returns the number of subscribers currently on the topic.
+     *
+     */
+    size_t subscriber_count() {
+        refresh();
+        return subscribers_.size();
+    }
+
+    /**
+     * @brief Returns the topic.
+     *
+     */
+    const Topic &topic() const { return topic_; }
+
+    /**
+     * @brief Returns `true` if the publisher refers to a valid topic.
+     *
+     */
+    bool ok() const { return topic_.ok(); }
+
+   private:
+    /**
+     * @brief Opens newly created subscriber FIFOs and closes removed ones.
+     * Only lists the topic directory if it has changed.
+     *
+     */
+    void refresh() {
+        if (!topic_.changed()) {
+            return;
+        }
+        std::map<std::string, FramedFifo> current;
+        for (const auto &path : topic_.endpoints()) {
+            auto it = subscribers_.find(path);
+            if (it != subscribers_.end()) {
+                current.emplace(path, std::move(it->second));
+            } else {
+                // Never create the FIFO: a subscriber may have removed it
+                FramedFifo fifo = FramedFifo::open_existing(path);
+                if (fifo.ok()) {
+                    current.emplace(path, std::move(fifo));
+                }
+            }
+        }
+        subscribers_ = std::move(current);
+    }
+
+    Topic topic_;
+    std::map<std::string, FramedFifo> subscribers_;
+    std::vector<uint8_t> buffer_;
+};
+
+}  // namespace ipc
+}  // namespace rix
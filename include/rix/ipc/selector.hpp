@@ -0,0 +1,149 @@
+#pragma once
+
+#include <poll.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "rix/ipc/event_notification.hpp"
+#include "rix/ipc/file.hpp"
+#include "rix/ipc/signal.hpp"
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class Selector
+ * @brief Waits on many file descriptors at once with a single `ppoll` call.
+ * Any `File` (including `Pipe`, `Fifo` and `Socket`), `Signal` or
+ * `EventNotification` can be added, so one thread can serve several command
+ * sources and still react to a shutdown notification without polling each
+ * source in turn with a timeout.
+ *
+ * @details Objects are identified by their file descriptor. The Selector does
+ * not take ownership, so every added object must outlive its registration.
+ *
+ *     Selector selector;
+ *     selector.add(command_fifo);
+ *     selector.add(shutdown);
+ *     std::vector<Selector::Ready> ready;
+ *     while (selector.wait(util::Duration::max(), ready) >= 0) {
+ *         for (auto &r : ready) {
+ *             if (r.fd == shutdown.fd()) return;
+ *             ...
+ *         }
+ *     }
+ *
+ * A ready `Signal` or `EventNotification` is not consumed by the Selector; call
+ * its `wait` method with a zero duration to reset it.
+ *
+ */
+class Selector {
+   public:
+    enum Event : short {
+        READABLE = POLLIN,
+        WRITABLE = POLLOUT
+    };
+
+    /**
+     * @brief A ready file descriptor and the events that occurred. `events`
+     * may also contain `POLLHUP` or `POLLERR`, which are always reported.
+     *
+     */
+    struct Ready {
+        int fd;
+        short events;
+    };
+
+    /**
+     * @brief Default constructor. Creates an empty Selector.
+     *
+     */
+    Selector();
+
+    /**
+     * @brief Adds a file descriptor to the set. If the descriptor is already
+     * in the set, its events are replaced.
+     *
+     * @param fd The file descriptor
+     * @param events A bitwise or of `Event` values
+     * @return true if the descriptor was added, false if it is invalid.
+     */
+    bool add(int fd, short events = READABLE);
+
+    /**
+     * @brief Adds a File (or any class derived from File) to the set.
+     *
+     * @param file The file to wait on
+     * @param events A bitwise or of `Event` values
+     * @return true if the file was added, false if it is invalid.
+     */
+    bool add(const File &file, short events = READABLE);
+
+    /**
+     * @brief Adds a Signal to the set. It is reported as readable when the
+     * signal arrives.
+     *
+     * @param signal The signal to wait on
+     * @return true if the signal was added, false if it is invalid.
+     */
+    bool add(const Signal &signal);
+
+    /**
+     * @brief Adds an EventNotification to the set. It is reported as readable
+     * when its counter is nonzero.
+     *
+     * @param notification The notification to wait on
+     * @return true if the notification was added, false if it is invalid.
+     */
+    bool add(const EventNotification &notification);
+
+    /**
+     * @brief Removes a file descriptor from the set.
+     *
+     * @param fd The file descriptor
+     * @return true if the descriptor was in the set.
+     */
+    bool remove(int fd);
+
+    /**
+     * @brief Removes a File from the set.
+     *
+     * @param file The file to be removed
+     * @return true if the file was in the set.
+     */
+    bool remove(const File &file);
+
+    /**
+     * @brief Waits until at least one descriptor in the set is ready or until
+     * the specified duration elapses, then fills `ready` with every ready
+     * descriptor. If the wait is interrupted by a signal, the set is checked
+     * once more without blocking, so a `Signal` in the set is reported; if
+     * nothing is ready, the wait resumes for the rest of the duration.
+     *
+     * @param duration The maximum duration to wait
+     * @param ready Set to the ready descriptors (cleared first)
+     * @return ssize_t The number of ready descriptors (0 on timeout), or -1 on
+     * error.
+     */
+    ssize_t wait(const util::Duration &duration, std::vector<Ready> &ready);
+
+    /**
+     * @brief Returns the number of descriptors in the set.
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Removes every descriptor from the set.
+     *
+     */
+    void clear();
+
+   private:
+    std::vector<struct pollfd> pfds_;
+};
+
+}  // namespace ipc
+}  // namespace rix
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "rix/ipc/file.hpp"
+#include "rix/ipc/interfaces/io.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class ShmRing
+ * @brief Single-producer/single-consumer byte stream over a shared-memory ring
+ * buffer. Implements `interfaces::IO`, so it can replace a `Pipe` or `Fifo`
+ * between two processes (or threads) on the same host.
+ *
+ * @details The ring lives in a `memfd` (see `ShmRing::create`) or a named POSIX
+ * shared memory object (see the named constructor). The head and tail indices
+ * are kept on separate cache lines so the producer and consumer never write to
+ * the same line. The data region is mapped twice back to back, so every
+ * readable or writable region is contiguous in memory, even across the end of
+ * the buffer. This is what allows the in-place `reserve`/`commit` and
+ * `peek`/`release` APIs:
+ *
+ *     uint8_t *dst = writer.reserve(n);   // space for n bytes, or nullptr
+ *     msg.serialize(dst, offset);         // build the frame in place
+ *     writer.commit(n);                   // publish it to the reader
+ *
+ * A blocked reader or writer sleeps on a futex in the shared region. The other
+ * side only issues a wake-up system call when it sees that its peer is
+ * sleeping, so an uncontended transfer costs no system calls at all.
+ *
+ * Like a pipe, `read` returns 0 once the write end has been destroyed and all
+ * data has been consumed, and `write` fails with `EPIPE` once the read end has
+ * been destroyed. There must be at most one reader and one writer.
+ */
+class ShmRing : public interfaces::IO {
+   public:
+    enum class Mode : int {
+        WRITE,
+        READ
+    };
+
+    /**
+     * @brief Factory method to create a connected pair of ShmRing objects
+     * backed by an anonymous `memfd`. The first element is the read end and the
+     * second is the write end. Both ends share the same memory, so one end can
+     * be handed to a child process after `fork`.
+     *
+     * @param capacity The minimum capacity in bytes. It is rounded up to a
+     * power of two that is at least one page.
+     * @return std::array<ShmRing, 2> The ring pair (invalid on failure)
+     */
+    static std::array<ShmRing, 2> create(size_t capacity);
+
+    /**
+     * @brief Removes the named shared memory object specified by `name`.
+     *
+     * @param name The name of the shared memory object
+     * @return true if the object was successfully removed.
+     */
+    static bool remove(const std::string &name);
+
+    /**
+     * @brief Opens the named shared memory ring specified by `name`, creating
+     * it with the requested capacity if it does not exist. If the ring already
+     * exists, its capacity is used and the `capacity` parameter is ignored.
+     * The object is created with permissions 0600, so only the owner can open
+     * it. If an existing object's size is not a valid ring size, the object is
+     * left in an invalid state and errno is set to `EINVAL`. Opening an end
+     * of an existing ring reopens it if a previous user closed it, so a
+     * restarted writer or reader can reuse the name.
+     *
+     * @param name The name of the shared memory object (a leading '/' is added
+     * if missing)
+     * @param capacity The minimum capacity in bytes if the ring is created
+     * @param mode The mode to open the ring with (READ or WRITE)
+     * @param nonblocking Flag to toggle non-blocking IO
+     */
+    ShmRing(const std::string &name, size_t capacity, Mode mode, bool nonblocking = false);
+
+    /**
+     * @brief Default constructor. This does not map a ring.
+     *
+     */
+    ShmRing();
+
+    /**
+     * @brief Copy constructor is deleted because each end of the ring must
+     * have exactly one user.
+     */
+    ShmRing(const ShmRing &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because each end of the ring must
+     * have exactly one user.
+     */
+    ShmRing &operator=(const ShmRing &other) = delete;
+
+    /**
+     * @brief Move constructor. Moves the mapping to the destination and
+     * invalidates the source.
+     *
+     * @param other The ShmRing to be moved
+     */
+    ShmRing(ShmRing &&other);
+
+    /**
+     * @brief Move assignment operator. If the destination is valid, it is
+     * closed first. Moves the mapping to the destination and invalidates the
+     * source.
+     *
+     * @param other The ShmRing to be moved
+     */
+    ShmRing &operator=(ShmRing &&other);
+
+    /**
+     * @brief Destructor. Marks this end as closed, wakes the peer and unmaps
+     * the ring.
+     *
+     */
+    virtual ~ShmRing();
+
+    /**
+     * @brief Read up to `size` bytes from the ring and store them in `dst`. In
+     * blocking mode, waits until at least one byte is available.
+     *
+     * @param dst The destination byte array
+     * @param size The maximum number of bytes to read
+     * @return ssize_t The number of bytes read, 0 if the write end is closed
+     * and the ring is empty, or -1 on error (`EAGAIN` in non-blocking mode).
+     */
+    virtual ssize_t read(uint8_t *dst, size_t size) const override;
+
+    /**
+     * @brief Write `size` bytes from `src` to the ring. In blocking mode, waits
+     * until all bytes are written. In non-blocking mode, writes as many bytes
+     * as fit.
+     *
+     * @param src The source byte array
+     * @param size The number of bytes to write
+     * @return ssize_t The number of bytes written, or -1 on error (`EAGAIN` if
+     * the ring is full in non-blocking mode, `EPIPE` if the read end is closed).
+     */
+    virtual ssize_t write(const uint8_t *src, size_t size) const override;
+
+    /**
+     * @brief Read into `iovcnt` buffers described by `iov`, filling each buffer
+     * in order. Blocks (in blocking mode) only until the first byte is
+     * available, like `read`.
+     *
+     * @param iov The destination buffers
+     * @param iovcnt The number of buffers
+     * @return ssize_t The total number of bytes read, 0 at end of stream, or -1
+     * on error.
+     */
+    virtual ssize_t readv(const struct iovec *iov, int iovcnt) const override;
+
+    /**
+     * @brief Write the contents of `iovcnt` buffers described by `iov`. Bytes
+     * from all buffers are gathered directly into the ring and published with
+     * one commit, so the reader sees (and is woken for) the whole frame at once
+     * whenever it fits.
+     *
+     * @param iov The source buffers
+     * @param iovcnt The number of buffers
+     * @return ssize_t The total number of bytes written, or -1 on error.
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt) const override;
+
+    /**
+     * @brief Waits for the specified duration for data to become available (or
+     * for the write end to close).
+     *
+     * @param duration The maximum duration to wait.
+     * @return true if the ring has become readable within the duration.
+     */
+    virtual bool wait_for_readable(const util::Duration &duration) const override;
+
+    /**
+     * @brief Waits for the specified duration for space to become available
+     * (or for the read end to close).
+     *
+     * @param duration The maximum duration to wait.
+     * @return true if the ring has become writable within the duration.
+     */
+    virtual bool wait_for_writable(const util::Duration &duration) const override;
+
+    /**
+     * @brief Toggles non-blocking IO operations.
+     *
+     * @param status Flag to toggle non-blocking mode (true for non-blocking,
+     * false for blocking).
+     */
+    virtual void set_nonblocking(bool status) override;
+
+    /**
+     * @brief Returns true if the ring is in non-blocking mode.
+     *
+     */
+    virtual bool is_nonblocking() const override;
+
+    /**
+     * @brief Returns a pointer to `size` contiguous writable bytes, or
+     * `nullptr` if this is not the write end or there is not enough free
+     * space. The bytes are not visible to the reader until `commit` is called.
+     *
+     * @param size The number of bytes to reserve
+     */
+    uint8_t *reserve(size_t size) const;
+
+    /**
+     * @brief Publishes `size` bytes previously obtained from `reserve`. At
+     * most the free space is published, so `size` should not exceed the size
+     * passed to `reserve`.
+     *
+     * @param size The number of bytes to publish
+     */
+    void commit(size_t size) const;
+
+    /**
+     * @brief Returns a pointer to the contiguous readable bytes without
+     * consuming them, or `nullptr` if this is not the read end or the ring is
+     * empty.
+     *
+     * @param size Set to the number of readable bytes
+     */
+    const uint8_t *peek(size_t &size) const;
+
+    /**
+     * @brief Consumes `size` bytes previously obtained from `peek`.
+     *
+     * @param size The number of bytes to consume
+     */
+    void release(size_t size) const;
+
+    /**
+     * @brief Returns the capacity of the ring in bytes.
+     *
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Returns the number of bytes available to read.
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the shared memory file descriptor.
+     *
+     */
+    int fd() const;
+
+    /**
+     * @brief Returns `true` if the ring is in a valid state, `false` otherwise.
+     */
+    bool ok() const;
+
+    /**
+     * @brief Returns the mode of the ring.
+     *
+     */
+    Mode mode() const;
+
+   private:
+    /**
+     * @brief Control block at the start of the shared region. The producer
+     * and consumer fields are on separate cache lines to avoid false sharing.
+     *
+     */
+    struct Control {
+        alignas(64) std::atomic<uint64_t> tail;         /**< Bytes ever written (producer) */
+        std::atomic<uint32_t> tail_seq;                 /**< Futex word, bumped on commit */
+        std::atomic<uint32_t> reader_waiting;           /**< Set while the reader sleeps */
+        alignas(64) std::atomic<uint64_t> head;         /**< Bytes ever read (consumer) */
+        std::atomic<uint32_t> head_seq;                 /**< Futex word, bumped on release */
+        std::atomic<uint32_t> writer_waiting;           /**< Set while the writer sleeps */
+        alignas(64) std::atomic<uint32_t> writer_closed;
+        std::atomic<uint32_t> reader_closed;
+        std::atomic<uint64_t> capacity;                 /**< Nonzero once initialized */
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "ShmRing requires lock-free 64-bit atomics");
+
+    ShmRing(File &&file, size_t capacity, Mode mode, bool initialize);
+    bool map(size_t capacity, bool initialize);
+    void unmap();
+    bool wait_on(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiting, bool readable,
+                 const util::Duration &duration) const;
+    size_t readable_bytes() const;
+    size_t writable_bytes() const;
+
+    File file_;
+    Mode mode_;
+    bool nonblocking_;
+    Control *control_;
+    uint8_t *data_;
+    size_t capacity_;
+};
+
+}  // namespace ipc
+}  // namespace rix
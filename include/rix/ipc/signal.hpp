@@ -89,6 +89,15 @@ class Signal : public interfaces::Notification {
      */
     int signum() const;
 
+    /**
+     * @brief Returns the read end of the pipe that the signal handler writes
+     * to, or -1 if the Signal is in an invalid state. It becomes readable when
+     * the signal arrives, so it may be used with `Selector` or `poll`. Call
+     * `wait` to consume the signal.
+     *
+     */
+    int fd() const;
+
     /**
      * @brief Wait until the signal is received, or until the specified duration
      * elapses. If the Signal is in an invalid, returns `false` immediately.
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "rix/ipc/file.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class Socket
+ * @brief Message-preserving local socket (`AF_UNIX`). Inherits from the `File`
+ * class. Unlike `Pipe` and `Fifo`, each successful `read` returns exactly one
+ * whole message as it was passed to `write`, so readers do not need a length
+ * prefix or partial-read loop.
+ *
+ * @details Two socket types are supported:
+ *     SEQPACKET: connection-oriented, reliable and ordered (`SOCK_SEQPACKET`)
+ *     DATAGRAM:  connectionless (`SOCK_DGRAM`)
+ * A connected pair can be created with `Socket::create_pair`. Named sockets
+ * are created with `bind` on a path; SEQPACKET servers then call `listen` and
+ * `accept`, and clients call `connect`.
+ *
+ * If the buffer passed to `read` is smaller than the next message, the excess
+ * bytes of that message are discarded.
+ *
+ * `send_batch` and `recv_batch` move many messages with a single system call
+ * (`sendmmsg`/`recvmmsg`).
+ */
+class Socket : public File {
+   public:
+    enum class Type : int {
+        SEQPACKET = SOCK_SEQPACKET,
+        DATAGRAM = SOCK_DGRAM
+    };
+
+    /**
+     * @brief Factory method to create a pair of connected Sockets.
+     *
+     * @param type The socket type
+     * @return std::array<Socket, 2> The connected pair (invalid on failure)
+     */
+    static std::array<Socket, 2> create_pair(Type type);
+
+    /**
+     * @brief Default constructor. This does not open a file descriptor.
+     *
+     */
+    Socket();
+
+    /**
+     * @brief Creates an unbound, unconnected socket of the specified type.
+     *
+     * @param type The socket type
+     * @param nonblocking Flag to toggle non-blocking IO
+     */
+    Socket(Type type, bool nonblocking = false);
+
+    /**
+     * @brief Copy constructor. This will duplicate the underlying file
+     * descriptor using `dup`.
+     *
+     * @param src The Socket to be copied
+     */
+    Socket(const Socket &src);
+
+    /**
+     * @brief Assignment operator. This will duplicate the underlying file
+     * descriptor using `dup`.
+     *
+     * @param src The Socket to be copied
+     */
+    Socket &operator=(const Socket &src);
+
+    /**
+     * @brief Move constructor. Moves the source file descriptor to the
+     * destination Socket and invalidates the source Socket.
+     *
+     * @param src The Socket to be moved
+     */
+    Socket(Socket &&src);
+
+    /**
+     * @brief Move assignment operator. If the destination Socket is valid,
+     * close the destination. Moves the source file descriptor to the
+     * destination Socket and invalidates the source Socket.
+     *
+     * @param src The Socket to be moved
+     */
+    Socket &operator=(Socket &&src);
+
+    /**
+     * @brief Destructor. This will close the underlying file descriptor. The
+     * bound path (if any) is not removed; use `File::remove`.
+     *
+     */
+    ~Socket();
+
+    /**
+     * @brief Binds the socket to the specified path.
+     *
+     * @param pathname The path of the socket file
+     * @return true if the socket was bound.
+     */
+    bool bind(const std::string &pathname);
+
+    /**
+     * @brief Marks a bound SEQPACKET socket as accepting connections.
+     *
+     * @param backlog The maximum number of pending connections
+     * @return true on success.
+     */
+    bool listen(int backlog = 16) const;
+
+    /**
+     * @brief Accepts a pending connection on a listening socket.
+     *
+     * @return Socket The connected socket (invalid on failure)
+     */
+    Socket accept() const;
+
+    /**
+     * @brief Connects the socket to the socket bound at the specified path.
+     * For DATAGRAM sockets this sets the default destination.
+     *
+     * @param pathname The path of the peer socket file
+     * @return true if the socket was connected.
+     */
+    bool connect(const std::string &pathname) const;
+
+    /**
+     * @brief Sends `size` bytes from `src` as one message. Uses `send` with
+     * `MSG_NOSIGNAL`, so writing to a socket whose peer has closed fails with
+     * `EPIPE` instead of raising `SIGPIPE`.
+     *
+     * @param src The message
+     * @param size The size of the message in bytes
+     * @return ssize_t The number of bytes sent, or -1 on error.
+     */
+    virtual ssize_t write(const uint8_t *src, size_t size) const override;
+
+    /**
+     * @brief Sends the buffers described by `iov` as one message using
+     * `sendmsg` with `MSG_NOSIGNAL` (see `write`).
+     *
+     * @param iov The buffers to gather
+     * @param iovcnt The number of buffers
+     * @return ssize_t The number of bytes sent, or -1 on error.
+     */
+    virtual ssize_t writev(const struct iovec *iov, int iovcnt) const override;
+
+    /**
+     * @brief Sends each element of `frames` as a separate message using a
+     * single `sendmmsg` system call. The socket must be connected.
+     *
+     * @param frames The messages to send
+     * @return ssize_t The number of messages sent, or -1 on error.
+     */
+    ssize_t send_batch(const std::vector<struct iovec> &frames) const;
+
+    /**
+     * @brief Receives up to `frames.size()` messages using a single `recvmmsg`
+     * system call. Each element of `frames` describes a receive buffer. On
+     * return, the `iov_len` of each of the first N elements is set to the size
+     * of the message stored in it.
+     *
+     * @param frames The receive buffers
+     * @return ssize_t The number of messages received (N), or -1 on error.
+     */
+    ssize_t recv_batch(std::vector<struct iovec> &frames) const;
+
+    /**
+     * @brief Returns the type of the socket.
+     *
+     */
+    Type type() const;
+
+    /**
+     * @brief Returns the path the socket is bound to, or an empty string.
+     *
+     */
+    std::string pathname() const;
+
+   private:
+    /**
+     * @brief Private constructor used by the `create_pair` factory method and
+     * `accept`.
+     *
+     * @param fd The underlying file descriptor
+     * @param type The socket type
+     */
+    Socket(int fd, Type type);
+
+    static bool make_address(const std::string &pathname, struct sockaddr_un &addr);
+
+    Type type_;
+    std::string pathname_;
+};
+
+}  // namespace ipc
+}  // namespace rix
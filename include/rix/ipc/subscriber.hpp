@@ -0,0 +1,172 @@
+#pragma once
+
+#include <string>
+
+#include "rix/ipc/framed_fifo.hpp"
+#include "rix/ipc/topic.hpp"
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class Subscriber
+ * @brief Receives messages of type `T` published on a named topic by any
+ * number of `Publisher` objects.
+ *
+ * @details The subscriber creates its own FIFO in the topic directory and
+ * removes it when destroyed. Publishers only deliver to subscribers of the
+ * same message type (compared by `hash`). The FIFO descriptor can be added to
+ * a `Selector` to wait on several topics at once.
+ *
+ *     Subscriber<rix::msg::geometry::Twist2DStamped> sub("cmd_vel");
+ *     rix::msg::geometry::Twist2DStamped msg;
+ *     while (sub.receive(msg)) { ... }
+ *
+ * @tparam T The message type (derived from `rix::msg::Message`)
+ */
+template <typename T>
+class Subscriber {
+   public:
+    /**
+     * @brief Default constructor. Does not refer to a topic.
+     *
+     */
+    Subscriber() : topic_(), endpoint_(), fifo_(), frame_(), producer_(0) {}
+
+    /**
+     * @brief Subscribes to the topic specified by `name`.
+     *
+     * @param name The topic name (see `Topic::Topic`)
+     * @param root The directory in which topics are created
+     * @param nonblocking Flag to toggle non-blocking IO
+     */
+    Subscriber(const std::string &name, const std::string &root = Topic::default_root(), bool nonblocking = false)
+        : topic_(name, T().hash(), root), endpoint_(), fifo_(), frame_(), producer_(0) {
+        endpoint_ = topic_.create_endpoint();
+        if (!endpoint_.empty()) {
+            fifo_ = FramedFifo(endpoint_, Fifo::Mode::READ, 0, nonblocking);
+        }
+    }
+
+    /**
+     * @brief Copy constructor is deleted because the endpoint is removed when
+     * its owner is destroyed.
+     */
+    Subscriber(const Subscriber &other) = delete;
+
+    /**
+     * @brief Assignment operator is deleted because the endpoint is removed
+     * when its owner is destroyed.
+     */
+    Subscriber &operator=(const Subscriber &other) = delete;
+
+    /**
+     * @brief Move constructor. Moves the endpoint to the destination and
+     * invalidates the source.
+     *
+     * @param other The Subscriber to be moved
+     */
+    Subscriber(Subscriber &&other)
+        : topic_(std::move(other.topic_)),
+          endpoint_(std::move(other.endpoint_)),
+          fifo_(std::move(other.fifo_)),
+          frame_(),
+          producer_(0) {
+        other.endpoint_.clear();
+    }
+
+    /**
+     * @brief Move assignment operator. Removes the destination's endpoint,
+     * then moves the source endpoint to the destination and invalidates the
+     * source.
+     *
+     * @param other The Subscriber to be moved
+     */
+    Subscriber &operator=(Subscriber &&other) {
+        if (this == &other) {
+            return *this;
+        }
+        unsubscribe();
+        topic_ = std::move(other.topic_);
+        endpoint_ = std::move(other.endpoint_);
+        fifo_ = std::move(other.fifo_);
+        other.endpoint_.clear();
+        return *this;
+    }
+
+    /**
+     * @brief Destructor. Removes the endpoint from the topic directory.
+     *
+     */
+    ~Subscriber() { unsubscribe(); }
+
+    /**
+     * @brief Receives the next message from any publisher. In blocking mode,
+     * waits until a message arrives.
+     *
+     * @param msg Set to the received message
+     * @return true if a message was received and deserialized.
+     */
+    bool receive(T &msg) { return receive(msg, producer_); }
+
+    /**
+     * @brief Receives the next message from any publisher and reports the
+     * process id of the publisher that sent it.
+     *
+     * @param msg Set to the received message
+     * @param publisher Set to the publisher's process id
+     * @return true if a message was received and deserialized.
+     */
+    bool receive(T &msg, uint32_t &publisher) {
+        if (!fifo_.read_frame(frame_)) {
+            return false;
+        }
+        publisher = frame_.producer;
+        size_t offset = 0;
+        return msg.deserialize(frame_.data.data(), frame_.data.size(), offset);
+    }
+
+    /**
+     * @brief Waits for the specified duration for a message to arrive.
+     *
+     * @param duration The maximum duration to wait.
+     * @return true if data has arrived within the duration.
+     */
+    bool wait_for_message(const util::Duration &duration) const { return fifo_.wait_for_readable(duration); }
+
+    /**
+     * @brief Returns the subscriber's FIFO descriptor.
+     *
+     */
+    int fd() const { return fifo_.fd(); }
+
+    /**
+     * @brief Returns the path of the subscriber's endpoint.
+     *
+     */
+    const std::string &endpoint() const { return endpoint_; }
+
+    /**
+     * @brief Returns `true` if the subscriber is registered on a topic.
+     *
+     */
+    bool ok() const { return fifo_.ok(); }
+
+   private:
+    void unsubscribe() {
+        if (!endpoint_.empty()) {
+            File::remove(endpoint_);
+            endpoint_.clear();
+        }
+        fifo_ = FramedFifo();
+    }
+
+    Topic topic_;
+    std::string endpoint_;
+    FramedFifo fifo_;
+    FramedFifo::Frame frame_;
+    uint32_t producer_;
+};
+
+}  // namespace ipc
+}  // namespace rix
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rix {
+namespace ipc {
+
+/**
+ * @class Topic
+ * @brief A named topic in a shared directory, used by `Publisher` and
+ * `Subscriber` to find each other without a broker process.
+ *
+ * @details Each topic is a directory `<root>/<name>`. Every subscriber creates
+ * its own FIFO (an endpoint) in that directory, named after the message type
+ * hash, its process id and a per-process counter:
+ *
+ *     /run/user/1000/rix_topics/cmd_vel/463cb851594cfdbe9be7d269b40e97b6.1234.0
+ *
+ * Publishers list the directory to find the endpoints with a matching type
+ * hash. Adding or removing an endpoint changes the directory's modification
+ * time, so publishers only list the directory again after `changed` returns
+ * true. Endpoints left behind by processes that no longer exist are removed
+ * when the directory is listed.
+ *
+ */
+class Topic {
+   public:
+    /**
+     * @brief Returns the default directory in which topics are created:
+     * `$XDG_RUNTIME_DIR/rix_topics`, or `/tmp/rix_topics_<uid>` if
+     * `XDG_RUNTIME_DIR` is not set.
+     *
+     */
+    static std::string default_root();
+
+    /**
+     * @brief Default constructor. Does not refer to a topic.
+     *
+     */
+    Topic();
+
+    /**
+     * @brief Creates the topic directory if it does not exist. Directories are
+     * created with permissions 0700 and endpoints with 0600. The topic is
+     * invalid (and errno is set to `EACCES`) if `root` or a directory below it
+     * already exists but is not a directory owned by the current user.
+     *
+     * @param name The topic name. It may contain letters, digits, '_', '-'
+     * and '/' (for nested topics), but may not start with '/' or contain "..".
+     * @param hash The message type hash (see `rix::msg::Message::hash`)
+     * @param root The directory in which topics are created
+     */
+    Topic(const std::string &name, const std::array<uint64_t, 2> &hash, const std::string &root = default_root());
+
+    /**
+     * @brief Creates a new endpoint FIFO in the topic directory.
+     *
+     * @return std::string The path of the endpoint, or an empty string on
+     * failure.
+     */
+    std::string create_endpoint() const;
+
+    /**
+     * @brief Returns the paths of all endpoints whose message type hash
+     * matches this topic, removing stale endpoints of dead processes.
+     *
+     */
+    std::vector<std::string> endpoints() const;
+
+    /**
+     * @brief Returns true if endpoints have been added or removed since the
+     * last call (always true on the first call). May also return true for up
+     * to one clock tick after a change, since the directory's modification
+     * time can be too coarse to tell later changes in the same tick apart.
+     *
+     */
+    bool changed();
+
+    /**
+     * @brief Returns the topic name.
+     *
+     */
+    const std::string &name() const;
+
+    /**
+     * @brief Returns the topic directory.
+     *
+     */
+    const std::string &path() const;
+
+    /**
+     * @brief Returns `true` if the topic directory exists, `false` otherwise.
+     *
+     */
+    bool ok() const;
+
+   private:
+    std::string name_;
+    std::string path_;
+    std::string hash_;
+    struct timespec mtime_;  /**< Modification time seen by the last `changed` */
+    struct timespec listed_; /**< Coarse time of the last `changed` that returned true */
+    bool ok_;
+};
+
+}  // namespace ipc
+}  // namespace rix
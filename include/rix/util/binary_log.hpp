@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "rix/ipc/mapped_file.hpp"
+#include "rix/util/log.hpp"
+#include "rix/util/time.hpp"
+
+/**
+ * @brief Logs a printf-style message to the binary log if `level` (DEBUG,
+ * INFO, WARN, ERROR or FATAL) is enabled (see `Log::enabled`); arguments of
+ * disabled levels are not evaluated. The format string must be a string
+ * literal. Only the arguments are recorded; they are formatted by
+ * `rix_logcat` when the log is read.
+ *
+ *     RIX_BLOG(INFO, "pose x=%.3f y=%.3f seq=%u", x, y, seq);
+ *
+ */
+#define RIX_BLOG(level, format, ...)                                                                          \
+    do {                                                                                                      \
+        if constexpr (::rix::util::Log::compiled(::rix::util::Log::Level::level)) {                           \
+            if (::rix::util::Log::enabled(::rix::util::Log::Level::level)) {                                  \
+                static const uint32_t rix_blog_id =                                                           \
+                    ::rix::util::BinaryLog::define(::rix::util::Log::Level::level, format, __FILE__, __LINE__); \
+                ::rix::util::BinaryLog::write(rix_blog_id __VA_OPT__(, ) __VA_ARGS__);                         \
+            }                                                                                                 \
+        }                                                                                                     \
+    } while (0)
+
+namespace rix {
+namespace util {
+
+/**
+ * @brief Layout of a binary log file. All numbers are stored in host byte
+ * order.
+ *
+ * @details The file starts with `MAGIC` and is followed by records, each
+ * starting with a one-byte type:
+ *
+ *     FORMAT: id (u32), level (u8), format, file (u16 length + bytes), line (u32)
+ *     ENTRY:  id (u32), stamp in nanoseconds (i64), argument bytes (u16 length + bytes)
+ *
+ * A FORMAT record describes a log statement and is written before the first
+ * ENTRY that refers to it. Each argument is a one-byte `ArgType` followed by
+ * its value: 8 bytes for numbers and pointers, 1 byte for `char` and `bool`,
+ * and a u16 length plus the characters for strings.
+ *
+ */
+namespace binary_log {
+
+constexpr std::array<char, 8> MAGIC = {'R', 'I', 'X', 'B', 'L', 'O', 'G', '1'};
+constexpr uint8_t FORMAT = 1;
+constexpr uint8_t ENTRY = 2;
+constexpr size_t MAX_ARGS_SIZE = 4096;
+
+enum ArgType : uint8_t { INT = 1, UINT, DOUBLE, STRING, CHAR, BOOL, POINTER };
+
+/**
+ * @brief Formats the encoded `args` with the printf-style `format`. Length
+ * modifiers in the format are ignored since the argument types are recorded.
+ *
+ */
+std::string format(std::string_view format, const uint8_t *args, size_t size);
+
+}  // namespace binary_log
+
+/**
+ * @class BinaryLog
+ * @brief A log that records compact binary entries instead of text, for
+ * high-rate diagnostics that should stay enabled in production.
+ *
+ * @details Each log statement (see `RIX_BLOG`) is registered once with an id.
+ * An entry holds only that id, the time and the raw argument values, so
+ * logging does no text formatting at all. Entries are pushed into a lock-free
+ * ring buffer owned by the logging thread (the same rings as `Log`'s
+ * asynchronous mode) and a background thread writes them to the file. When a
+ * ring is full the entry is dropped (see `dropped`) instead of blocking.
+ *
+ * Logs are read back with `BinaryLogReader` or the `rix_logcat` tool.
+ *
+ */
+class BinaryLog {
+   public:
+    /**
+     * @brief Creates (or truncates) the log file specified by `pathname` and
+     * starts the background writer.
+     *
+     * @param pathname The path of the log file
+     * @param ring_size The size in bytes of each thread's ring buffer
+     * @return true if the file was opened.
+     */
+    static bool open(const std::string &pathname, size_t ring_size = 1 << 16);
+
+    /**
+     * @brief Writes every pending entry and closes the log file. Pending
+     * entries are also written at exit if the file is not closed.
+     *
+     */
+    static void close();
+
+    /**
+     * @brief Returns `true` if a log file is open.
+     *
+     */
+    static bool is_open();
+
+    /**
+     * @brief Returns the number of entries dropped because a ring buffer was
+     * full.
+     *
+     */
+    static size_t dropped();
+
+    /**
+     * @brief Registers a log statement. Used by `RIX_BLOG`.
+     *
+     * @return uint32_t The id of the statement
+     */
+    static uint32_t define(Log::Level level, const char *format, const char *file, int line);
+
+    /**
+     * @brief Records an entry for the statement `id`. Used by `RIX_BLOG`.
+     *
+     */
+    template <typename... Args>
+    static void write(uint32_t id, const Args &...args) {
+        if (!is_open()) {
+            return;
+        }
+        thread_local std::array<uint8_t, binary_log::MAX_ARGS_SIZE> buffer;
+        size_t size = 0;
+        (encode(buffer.data(), size, args), ...);
+        push(id, buffer.data(), size);
+    }
+
+   private:
+    static void push(uint32_t id, const uint8_t *args, size_t size);
+
+    template <typename T>
+    static void encode_number(uint8_t *dst, size_t &offset, uint8_t type, const T &value) {
+        if (offset + 1 + sizeof(T) > binary_log::MAX_ARGS_SIZE) {
+            return;
+        }
+        dst[offset++] = type;
+        std::memcpy(dst + offset, &value, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    static void encode_string(uint8_t *dst, size_t &offset, std::string_view value) {
+        if (offset + 3 > binary_log::MAX_ARGS_SIZE) {
+            return;
+        }
+        const uint16_t size = static_cast<uint16_t>(std::min(value.size(), binary_log::MAX_ARGS_SIZE - offset - 3));
+        dst[offset++] = binary_log::STRING;
+        std::memcpy(dst + offset, &size, sizeof(size));
+        std::memcpy(dst + offset + sizeof(size), value.data(), size);
+        offset += sizeof(size) + size;
+    }
+
+    template <typename T>
+    static void encode(uint8_t *dst, size_t &offset, const T &value) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            encode_number<uint8_t>(dst, offset, binary_log::BOOL, value);
+        } else if constexpr (std::is_same_v<U, char>) {
+            encode_number<char>(dst, offset, binary_log::CHAR, value);
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            encode_number<int64_t>(dst, offset, binary_log::INT, value);
+        } else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+            encode_number<uint64_t>(dst, offset, binary_log::UINT, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<U>) {
+            encode_number<double>(dst, offset, binary_log::DOUBLE, value);
+        } else if constexpr (std::is_same_v<U, const char *> || std::is_same_v<U, char *>) {
+            encode_string(dst, offset, value ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const U &, std::string_view>) {
+            encode_string(dst, offset, std::string_view(value));
+        } else if constexpr (std::is_pointer_v<U>) {
+            encode_number<uint64_t>(dst, offset, binary_log::POINTER, reinterpret_cast<uintptr_t>(value));
+        } else {
+            static_assert(std::is_pointer_v<U>, "Unsupported RIX_BLOG argument type");
+        }
+    }
+};
+
+/**
+ * @class BinaryLogReader
+ * @brief Decodes a binary log file written by `BinaryLog`.
+ *
+ * @details The file is mapped into memory. A file that is still being
+ * written (or was cut off) is read up to its last complete record.
+ *
+ */
+class BinaryLogReader {
+   public:
+    struct Entry {
+        Log::Level level;
+        Time stamp;
+        std::string text;  /**< The formatted message */
+        std::string file;  /**< The source file of the log statement */
+        int line;          /**< The source line of the log statement */
+    };
+
+    /**
+     * @brief Opens and maps the log file specified by `pathname`.
+     *
+     */
+    BinaryLogReader(const std::string &pathname);
+
+    /**
+     * @brief Reads and formats the next entry.
+     *
+     * @return true if an entry was read, false at the end of the log or at a
+     * malformed record (such as a level above FATAL).
+     */
+    bool next(Entry &entry);
+
+    /**
+     * @brief Returns `true` if the file is a binary log, `false` otherwise.
+     *
+     */
+    bool ok() const;
+
+   private:
+    struct Format {
+        Log::Level level;
+        std::string format;
+        std::string file;
+        int line;
+    };
+
+    ipc::MappedFile map_;
+    size_t offset_;
+    std::unordered_map<uint32_t, Format> formats_;
+    bool ok_;
+};
+
+}  // namespace util
+}  // namespace rix
@@ -4,18 +4,50 @@
 #define RIX_UTIL_LOG_LEVEL 1
 #endif
 
+/**
+ * @brief Returns the log stream for `level` (DEBUG, INFO, WARN, ERROR or
+ * FATAL) if that level is enabled, so that
+ *
+ *     RIX_LOG(DEBUG) << "state " << expensive() << std::endl;
+ *
+ * neither evaluates nor formats its arguments when the level is disabled.
+ * Levels below RIX_UTIL_LOG_LEVEL are discarded at compile time and levels
+ * below `Log::get_level()` are skipped with a single check at runtime. The
+ * macro expands to an if-else statement, so put braces around it when it is
+ * the body of an unbraced `if`.
+ *
+ */
+#define RIX_LOG(level)                                                                 \
+    if constexpr (!::rix::util::Log::compiled(::rix::util::Log::Level::level)) {      \
+    } else if (!::rix::util::Log::enabled(::rix::util::Log::Level::level)) {          \
+    } else                                                                             \
+        ::rix::util::Log::stream<::rix::util::Log::Level::level>()
+
 #include <pwd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <charconv>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
-#include <string>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "rix/util/time.hpp"
 
@@ -92,6 +124,378 @@ class NullBuffer : public std::streambuf {
 
 inline int NullBuffer::overflow(int c) { return c; }
 
+/**
+ * @brief NullStream class. The stream returned for disabled log levels. It is
+ * kept in a failed state, so the `<<` calls that follow in the same statement
+ * return without formatting anything.
+ *
+ */
+class NullStream : public std::ostream {
+   public:
+    NullStream();
+
+   private:
+    NullBuffer buffer_;
+};
+
+inline NullStream::NullStream() : std::ostream(&buffer_) { setstate(std::ios::badbit); }
+
+/**
+ * @brief LogRing class. A lock-free single-producer, single-consumer ring of
+ * log records. Each thread that logs in asynchronous mode owns one ring, and
+ * the background thread of `AsyncCore` is its only consumer. A record that
+ * does not fit is dropped instead of blocking the logging thread.
+ *
+ */
+class LogRing {
+   public:
+    struct RecordHeader {
+        int64_t ns;
+        uint32_t size;
+        uint32_t tag;  /**< The log level of a text record, or the statement id of a binary record */
+    };
+
+    LogRing(size_t capacity);
+
+    bool push(uint32_t tag, int64_t ns, const char *text, size_t size);
+    bool pop(uint32_t &tag, int64_t &ns, std::string &text);
+    bool empty() const;
+
+   private:
+    void copy_in(size_t pos, const void *src, size_t size);
+    void copy_out(size_t pos, void *dst, size_t size) const;
+
+    std::vector<char> buffer_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> head_;  /**< Read position, written by the consumer */
+    alignas(64) std::atomic<size_t> tail_;  /**< Write position, written by the producer */
+};
+
+inline LogRing::LogRing(size_t capacity) : buffer_(), mask_(0), head_(0), tail_(0) {
+    size_t size = 64;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    buffer_.resize(size);
+    mask_ = size - 1;
+}
+
+inline void LogRing::copy_in(size_t pos, const void *src, size_t size) {
+    const size_t start = pos & mask_;
+    const size_t first = std::min(size, buffer_.size() - start);
+    std::memcpy(buffer_.data() + start, src, first);
+    std::memcpy(buffer_.data(), static_cast<const char *>(src) + first, size - first);
+}
+
+inline void LogRing::copy_out(size_t pos, void *dst, size_t size) const {
+    const size_t start = pos & mask_;
+    const size_t first = std::min(size, buffer_.size() - start);
+    std::memcpy(dst, buffer_.data() + start, first);
+    std::memcpy(static_cast<char *>(dst) + first, buffer_.data(), size - first);
+}
+
+inline bool LogRing::push(uint32_t tag, int64_t ns, const char *text, size_t size) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    if (sizeof(RecordHeader) + size > buffer_.size() - (tail - head)) {
+        return false;
+    }
+    RecordHeader header{ns, static_cast<uint32_t>(size), tag};
+    copy_in(tail, &header, sizeof(header));
+    copy_in(tail + sizeof(header), text, size);
+    tail_.store(tail + sizeof(header) + size, std::memory_order_release);
+    return true;
+}
+
+inline bool LogRing::pop(uint32_t &tag, int64_t &ns, std::string &text) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    RecordHeader header;
+    copy_out(head, &header, sizeof(header));
+    text.resize(header.size);
+    copy_out(head + sizeof(header), text.data(), header.size);
+    tag = header.tag;
+    ns = header.ns;
+    head_.store(head + sizeof(header) + header.size, std::memory_order_release);
+    return true;
+}
+
+inline bool LogRing::empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief AsyncCore class. Holds the rings of every thread that has logged in
+ * asynchronous mode and the background thread that drains them into a sink.
+ * Each `Tag` type has its own set of rings and thread, so the text log and
+ * the binary log (see `BinaryLog`) do not share them.
+ *
+ */
+template <typename Tag>
+class AsyncCore {
+   public:
+    using Sink = std::function<void(uint32_t tag, int64_t ns, std::string_view text)>;
+    using Flush = std::function<void()>;
+
+    inline static void start(size_t ring_size, Sink sink, Flush flush);
+    inline static void stop();
+    inline static std::shared_ptr<LogRing> add_ring();
+
+    inline static std::atomic<bool> enabled{false};
+    inline static std::atomic<size_t> dropped{0};
+    inline static std::atomic<size_t> ring_size{1 << 16};
+
+   private:
+    inline static bool drain();
+    inline static void run();
+
+    inline static std::mutex mutex{};
+    inline static std::vector<std::shared_ptr<LogRing>> rings{};
+    inline static Sink sink{};
+    inline static Flush flush{};
+    inline static std::thread thread{};
+    inline static std::atomic<bool> running{false};
+};
+
+template <typename Tag>
+inline void AsyncCore<Tag>::start(size_t size, Sink output, Flush flush_output) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (running.load()) {
+        return;
+    }
+    ring_size = size;
+    sink = std::move(output);
+    flush = std::move(flush_output);
+    running = true;
+    thread = std::thread(&AsyncCore<Tag>::run);
+    enabled = true;
+
+    // Drain and join the thread at exit if stop() was never called. The
+    // handler runs before the statics that the sink writes to are destroyed.
+    static const bool registered = (std::atexit(&AsyncCore<Tag>::stop), true);
+    (void)registered;
+}
+
+template <typename Tag>
+inline void AsyncCore<Tag>::stop() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!running.load()) {
+            return;
+        }
+        enabled = false;
+        running = false;
+    }
+    thread.join();
+}
+
+template <typename Tag>
+inline std::shared_ptr<LogRing> AsyncCore<Tag>::add_ring() {
+    auto ring = std::make_shared<LogRing>(ring_size.load());
+    std::lock_guard<std::mutex> guard(mutex);
+    rings.push_back(ring);
+    return ring;
+}
+
+template <typename Tag>
+inline bool AsyncCore<Tag>::drain() {
+    std::vector<std::shared_ptr<LogRing>> current;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        current = rings;
+    }
+
+    bool drained = false;
+    uint32_t tag;
+    int64_t ns;
+    std::string text;
+    for (auto &ring : current) {
+        while (ring->pop(tag, ns, text)) {
+            sink(tag, ns, text);
+            drained = true;
+        }
+    }
+    if (drained) {
+        flush();
+    }
+
+    // Forget the rings of threads that have exited once they are empty
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto it = rings.begin(); it != rings.end();) {
+        if (it->use_count() <= 2 && (*it)->empty()) {
+            it = rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return drained;
+}
+
+template <typename Tag>
+inline void AsyncCore<Tag>::run() {
+    while (running.load()) {
+        if (!drain()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    drain();
+}
+
+/**
+ * @brief Tag of the `AsyncCore` used by the text log.
+ *
+ */
+struct TextRecords {};
+using TextCore = AsyncCore<TextRecords>;
+
+/**
+ * @brief RecordBuffer class. The stream buffer behind each thread's
+ * asynchronous log stream. Text written to it is collected into a record,
+ * which is pushed to the thread's `LogRing` when the stream is flushed (for
+ * example by `std::endl`), when a write ends with a newline, or when the next
+ * record begins.
+ *
+ */
+class RecordBuffer : public std::streambuf {
+   public:
+    RecordBuffer();
+    ~RecordBuffer();
+
+    void begin(int level, int64_t ns);
+    void commit();
+
+   protected:
+    int overflow(int c) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+
+   private:
+    std::shared_ptr<LogRing> ring_;
+    std::string text_;
+    int level_;
+    int64_t ns_;
+    bool open_;
+};
+
+inline RecordBuffer::RecordBuffer() : ring_(TextCore::add_ring()), text_(), level_(0), ns_(0), open_(false) {
+    text_.reserve(256);
+}
+
+inline RecordBuffer::~RecordBuffer() { commit(); }
+
+inline void RecordBuffer::begin(int level, int64_t ns) {
+    commit();
+    level_ = level;
+    ns_ = ns;
+    open_ = true;
+}
+
+inline void RecordBuffer::commit() {
+    if (!open_) {
+        return;
+    }
+    if (!ring_->push(static_cast<uint32_t>(level_), ns_, text_.data(), text_.size())) {
+        TextCore::dropped++;
+    }
+    text_.clear();
+    open_ = false;
+}
+
+inline int RecordBuffer::overflow(int c) {
+    if (c != EOF) {
+        open_ = true;
+        text_.push_back(static_cast<char>(c));
+        if (c == '\n') {
+            commit();
+        }
+    }
+    return 0;
+}
+
+inline std::streamsize RecordBuffer::xsputn(const char *s, std::streamsize n) {
+    open_ = true;
+    text_.append(s, n);
+    if (n > 0 && s[n - 1] == '\n') {
+        commit();
+    }
+    return n;
+}
+
+inline int RecordBuffer::sync() {
+    commit();
+    return 0;
+}
+
+/**
+ * @brief HeaderFormatter class. Formats the time field of log headers,
+ * "[MM/DD/YY HH:MM:SS.uuuuuu GMT] ". The date and time up to the second are
+ * only formatted when the second changes; otherwise only the six microsecond
+ * digits are patched in with `std::to_chars`. Each thread uses its own
+ * formatter, so the returned header stays valid until that thread's next call.
+ *
+ */
+class HeaderFormatter {
+   public:
+    HeaderFormatter();
+
+    std::string_view format(int64_t ns, std::string_view suffix);
+
+   private:
+    static constexpr size_t DATE = 1;       /**< "MM/DD/YY HH:MM:SS" */
+    static constexpr size_t MICROS = 19;    /**< "uuuuuu" */
+    static constexpr size_t STAMP_SIZE = 31;
+
+    std::array<char, STAMP_SIZE + 1> stamp_;
+    int64_t second_;
+    std::string line_;
+};
+
+inline HeaderFormatter::HeaderFormatter() : stamp_(), second_(std::numeric_limits<int64_t>::min()), line_() {
+    std::memcpy(stamp_.data(), "[00/00/00 00:00:00.000000 GMT] ", STAMP_SIZE);
+    line_.reserve(128);
+}
+
+inline std::string_view HeaderFormatter::format(int64_t ns, std::string_view suffix) {
+    int64_t second = ns / 1'000'000'000;
+    int64_t sub = ns % 1'000'000'000;
+    if (sub < 0) {
+        second--;
+        sub += 1'000'000'000;
+    }
+
+    if (second != second_) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm timeinfo;
+        ::gmtime_r(&time, &timeinfo);
+        char date[18];
+        std::strftime(date, sizeof(date), "%D %T", &timeinfo);
+        std::memcpy(stamp_.data() + DATE, date, sizeof(date) - 1);
+        second_ = second;
+    }
+
+    // Zero-padded microseconds
+    char digits[6];
+    auto result = std::to_chars(digits, digits + sizeof(digits), sub / 1000);
+    const size_t length = static_cast<size_t>(result.ptr - digits);
+    std::memset(stamp_.data() + MICROS, '0', sizeof(digits) - length);
+    std::memcpy(stamp_.data() + MICROS + sizeof(digits) - length, digits, length);
+
+    line_.assign(stamp_.data(), STAMP_SIZE);
+    line_.append(suffix);
+    return line_;
+}
+
+/**
+ * @brief LocalLog struct. The asynchronous log stream of one thread.
+ *
+ */
+struct LocalLog {
+    RecordBuffer buffer;
+    std::ostream stream{&buffer};
+};
+
 }  // namespace detail
 
 /**
@@ -109,12 +513,6 @@ class Log {
     enum Level { DEBUG, INFO, WARN, ERROR, FATAL };
 
    private:
-    /**
-     * @brief static declaration of NullBuffer used by LogStream objects to
-     * "write" to when the RIX_UTIL_LOG_LEVEL < level.
-     *
-     */
-    inline static detail::NullBuffer null_buffer{};
     inline static std::ofstream logFile{};
     inline static detail::TeeBuffer tee_buffer{std::vector<std::streambuf *>{std::cout.rdbuf()}};
     inline static std::mutex mutex{};
@@ -134,7 +532,12 @@ class Log {
         template <typename T>
         std::ostream &operator<<(const T &val);
 
-        inline static std::ostream null_stream{&Log::null_buffer};
+        /**
+         * @brief The stream LogStream objects "write" to when their level is
+         * disabled.
+         *
+         */
+        inline static detail::NullStream null_stream{};
         inline static std::ostream tee_stream{&Log::tee_buffer};
         inline static std::mutex &mutex{Log::mutex};
 
@@ -145,6 +548,80 @@ class Log {
    public:
     inline static void init(const std::string &name, bool logToFile = false);
 
+    /**
+     * @brief Sets the lowest level that is logged at runtime. Levels below
+     * RIX_UTIL_LOG_LEVEL are compiled out and stay disabled regardless.
+     *
+     */
+    inline static void set_level(Level level);
+
+    /**
+     * @brief Returns the lowest level that is logged at runtime.
+     *
+     */
+    inline static Level get_level();
+
+    /**
+     * @brief Returns `true` if `level` is at least RIX_UTIL_LOG_LEVEL, i.e. if
+     * logging at `level` is compiled in.
+     *
+     */
+    static constexpr bool compiled(Level level) { return level >= RIX_UTIL_LOG_LEVEL; }
+
+    /**
+     * @brief Returns `true` if messages at `level` are currently logged.
+     *
+     */
+    inline static bool enabled(Level level);
+
+    /**
+     * @brief Returns the LogStream object for `level`. Used by `RIX_LOG`.
+     *
+     */
+    template <Level level>
+    inline static LogStream<level> &stream();
+
+    /**
+     * @brief Switches to asynchronous mode. Each logging thread then only
+     * copies its records into its own lock-free ring buffer, and a background
+     * thread adds the headers and writes them to the outputs. A record ends
+     * at `std::endl`, `std::flush`, a write ending in a newline, or the start
+     * of the next record. Records that do not fit in a full ring are dropped
+     * (see `dropped`) so logging never blocks. Pending records are written
+     * at exit if `stop_async` is not called.
+     *
+     * @param ring_size The size in bytes of each thread's ring buffer
+     */
+    inline static void start_async(size_t ring_size = 1 << 16);
+
+    /**
+     * @brief Writes every pending record and switches back to synchronous
+     * mode. Records that other threads have not yet ended are written when
+     * they end, if asynchronous mode is started again.
+     *
+     */
+    inline static void stop_async();
+
+    /**
+     * @brief Returns `true` in asynchronous mode.
+     *
+     */
+    inline static bool is_async();
+
+    /**
+     * @brief Returns the number of records dropped in asynchronous mode
+     * because a ring buffer was full.
+     *
+     */
+    inline static size_t dropped();
+
+    /**
+     * @brief Adds an output to which every record is written, in addition to
+     * stdout (and the log file). The buffer must outlive all logging.
+     *
+     */
+    inline static void add_output(std::streambuf *output);
+
     /**
      * The public LogStream objects. These are used to log inforamtion at the
      * corresponding level. If RIX_UTIL_LOG_LEVEL is greater than the template
@@ -163,40 +640,76 @@ class Log {
     inline static const std::string unbold = "\x1b[22m";
     inline static std::string name;
     inline static bool is_init{false};
+    inline static std::atomic<int> runtime_level{RIX_UTIL_LOG_LEVEL};
 
     inline static std::string get_color_code(Level level);
     inline static std::string get_level_string(Level level);
+    inline static std::string create_header(Level level, const Time &t);
+    inline static std::string_view header(Level level, int64_t ns);
+    inline static std::array<std::string, 5> create_suffixes();
+
+    /**
+     * @brief The level and name fields of the header for each level. They only
+     * change in `init`, so they are formatted once.
+     *
+     */
+    inline static std::array<std::string, 5> suffixes{create_suffixes()};
+    inline static detail::LocalLog &local();
 };
 
 template <Log::Level level>
 template <typename T>
 inline std::ostream &Log::LogStream<level>::operator<<(const T &val) {
-    if (level < RIX_UTIL_LOG_LEVEL) {
+    if constexpr (!compiled(level)) {
         return null_stream;
     }
+    if (level < runtime_level.load(std::memory_order_relaxed)) {
+        return null_stream;
+    }
+
+    if (detail::TextCore::enabled.load(std::memory_order_relaxed)) {
+        detail::LocalLog &log = local();
+        log.buffer.begin(level, Time::now().to_nanoseconds());
+        return log.stream << val;
+    }
 
     std::lock_guard<std::mutex> guard(mutex);
-    std::string header = create_header(Time::now());
-    return tee_stream << header << val;
+    std::string_view header = Log::header(level, Time::now().to_nanoseconds());
+    tee_stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+    return tee_stream << val;
 }
 
 template <Log::Level level>
 inline std::string Log::LogStream<level>::create_header(const Time &t) {
-    std::stringstream ss;
+    return Log::create_header(level, t);
+}
 
-    // Date field
-    ss << "[" << t.to_string() << "] ";
+inline std::string Log::create_header(Level level, const Time &t) {
+    return std::string(header(level, t.to_nanoseconds()));
+}
 
-    // Level field
-    std::string level_str = "[" + bold + get_color_code(level) + get_level_string(level) + reset_color + "] ";
-    ss << std::setw(21) << std::left << level_str;
+inline std::string_view Log::header(Level level, int64_t ns) {
+    thread_local detail::HeaderFormatter formatter;
+    return formatter.format(ns, suffixes[level]);
+}
 
-    // Name field
-    if (is_init) {
-        ss << "[" << bold << name << unbold << "] ";
-    }
+inline std::array<std::string, 5> Log::create_suffixes() {
+    std::array<std::string, 5> result;
+    for (int level = DEBUG; level <= FATAL; level++) {
+        std::stringstream ss;
 
-    return ss.str();
+        // Level field
+        std::string level_str = "[" + bold + get_color_code(static_cast<Level>(level)) +
+                                get_level_string(static_cast<Level>(level)) + reset_color + "] ";
+        ss << std::setw(21) << std::left << level_str;
+
+        // Name field
+        if (is_init) {
+            ss << "[" << bold << name << unbold << "] ";
+        }
+        result[level] = ss.str();
+    }
+    return result;
 }
 
 template <Log::Level level>
@@ -235,6 +748,7 @@ inline void Log::init(const std::string &name, bool logToFile) {
                 std::string err = strerror(errno);
                 logToFile = false;
                 is_init = true;
+                suffixes = create_suffixes();
                 return;
             }
         }
@@ -242,6 +756,62 @@ inline void Log::init(const std::string &name, bool logToFile) {
         tee_buffer.add(logFile.rdbuf());
     }
     is_init = true;
+    suffixes = create_suffixes();
+}
+
+inline void Log::set_level(Level level) { runtime_level.store(level, std::memory_order_relaxed); }
+
+inline Log::Level Log::get_level() { return static_cast<Level>(runtime_level.load(std::memory_order_relaxed)); }
+
+inline bool Log::enabled(Level level) {
+    return compiled(level) && level >= runtime_level.load(std::memory_order_relaxed);
+}
+
+template <Log::Level level>
+inline Log::LogStream<level> &Log::stream() {
+    if constexpr (level == Level::DEBUG) {
+        return debug;
+    } else if constexpr (level == Level::INFO) {
+        return info;
+    } else if constexpr (level == Level::WARN) {
+        return warn;
+    } else if constexpr (level == Level::ERROR) {
+        return error;
+    } else {
+        return fatal;
+    }
+}
+
+inline void Log::start_async(size_t ring_size) {
+    detail::TextCore::start(ring_size, [](uint32_t level, int64_t ns, std::string_view text) {
+        std::string_view header = Log::header(static_cast<Level>(level), ns);
+        std::lock_guard<std::mutex> guard(mutex);
+        std::ostream &out = LogStream<Level::FATAL>::tee_stream;
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }, []() {
+        std::lock_guard<std::mutex> guard(mutex);
+        LogStream<Level::FATAL>::tee_stream.flush();
+    });
+}
+
+inline void Log::stop_async() {
+    local().buffer.commit();
+    detail::TextCore::stop();
+}
+
+inline bool Log::is_async() { return detail::TextCore::enabled.load(); }
+
+inline size_t Log::dropped() { return detail::TextCore::dropped.load(); }
+
+inline void Log::add_output(std::streambuf *output) {
+    std::lock_guard<std::mutex> guard(mutex);
+    tee_buffer.add(output);
+}
+
+inline detail::LocalLog &Log::local() {
+    thread_local detail::LocalLog log;
+    return log;
 }
 
 inline std::string Log::get_color_code(Level level) {
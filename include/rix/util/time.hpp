@@ -1,7 +1,12 @@
 #pragma once
 
+#include <time.h>
+
+#include <array>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 #include "rix/msg/standard/Duration.hpp"
@@ -119,6 +124,208 @@ class Duration {
     Type d;
 };
 
+/**
+ * @brief The reference point a clock counts from. Times of clocks with the
+ * same epoch can be compared directly; converting between epochs needs a
+ * sample of both (see `time_cast`).
+ *
+ */
+enum class Epoch { REALTIME, MONOTONIC };
+
+/**
+ * @brief The monotonic clock (`CLOCK_MONOTONIC`). It is not adjusted when the
+ * wall clock is set or slewed, so it is the clock to use for rates, timeouts
+ * and latency measurements.
+ *
+ */
+struct SteadyClock {
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<SteadyClock>;
+    static constexpr bool is_steady = true;
+    static constexpr Epoch epoch = Epoch::MONOTONIC;
+    static constexpr clockid_t id = CLOCK_MONOTONIC;
+
+    static time_point now() noexcept;
+};
+
+/**
+ * @brief The coarse monotonic clock (`CLOCK_MONOTONIC_COARSE`). Cheaper to read
+ * than `SteadyClock` but only advances once per scheduler tick (typically 1
+ * to 4 ms), which is enough for timeouts and watchdogs.
+ *
+ */
+struct CoarseSteadyClock {
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<CoarseSteadyClock>;
+    static constexpr bool is_steady = true;
+    static constexpr Epoch epoch = Epoch::MONOTONIC;
+    static constexpr clockid_t id = CLOCK_MONOTONIC_COARSE;
+
+    static time_point now() noexcept;
+};
+
+/**
+ * @brief The coarse wall clock (`CLOCK_REALTIME_COARSE`), for cheap time
+ * stamps where tick resolution is enough.
+ *
+ */
+struct CoarseSystemClock {
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<CoarseSystemClock>;
+    static constexpr bool is_steady = false;
+    static constexpr Epoch epoch = Epoch::REALTIME;
+    static constexpr clockid_t id = CLOCK_REALTIME_COARSE;
+
+    static time_point now() noexcept;
+};
+
+/**
+ * @brief A monotonic clock read from the CPU's time stamp counter. On x86-64
+ * CPUs with an invariant TSC it is calibrated against `SteadyClock` the first
+ * time it is used (which takes about 10 ms) and then read without a system
+ * call or vDSO lookup. Elsewhere it falls back to `SteadyClock`. Its times
+ * count from the monotonic epoch, but drift from `SteadyClock` by the
+ * calibration error (typically a few parts per million).
+ *
+ */
+struct TscClock {
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<TscClock>;
+    static constexpr bool is_steady = true;
+    static constexpr Epoch epoch = Epoch::MONOTONIC;
+    static constexpr clockid_t id = CLOCK_MONOTONIC;
+
+    static time_point now() noexcept;
+
+    /**
+     * @brief Returns `true` if the clock reads the time stamp counter, `false`
+     * if it falls back to `SteadyClock`.
+     *
+     */
+    static bool available();
+
+    /**
+     * @brief Returns the calibrated counter frequency in Hz, or 0 if the
+     * counter is not used.
+     *
+     */
+    static double frequency();
+};
+
+/**
+ * @brief A point in time of clock `C`. Times of different clocks are distinct
+ * types, so a monotonic time can not be mixed up with a wall-clock `Time` by
+ * accident; use `time_cast` to convert explicitly. Differences are ordinary
+ * `Duration`s.
+ *
+ */
+template <typename C>
+class ClockTime {
+   public:
+    using Clock = C;
+    using Type = typename C::time_point;
+
+    static ClockTime now() { return ClockTime(C::now()); }
+    static ClockTime max() { return ClockTime(Type::max()); }
+    static ClockTime min() { return ClockTime(Type::min()); }
+
+    ClockTime() : tp{} {}
+    explicit ClockTime(const Type &time_point) : tp(time_point) {}
+
+    ClockTime operator+(const Duration &other) const { return ClockTime(tp + other.get()); }
+    ClockTime operator-(const Duration &other) const { return ClockTime(tp - other.get()); }
+    Duration operator-(const ClockTime &other) const { return Duration(tp - other.tp); }
+
+    ClockTime &operator+=(const Duration &other) {
+        tp += other.get();
+        return *this;
+    }
+    ClockTime &operator-=(const Duration &other) {
+        tp -= other.get();
+        return *this;
+    }
+    bool operator==(const ClockTime &other) const { return tp == other.tp; }
+    bool operator!=(const ClockTime &other) const { return tp != other.tp; }
+    bool operator<(const ClockTime &other) const { return tp < other.tp; }
+    bool operator<=(const ClockTime &other) const { return tp <= other.tp; }
+    bool operator>(const ClockTime &other) const { return tp > other.tp; }
+    bool operator>=(const ClockTime &other) const { return tp >= other.tp; }
+
+    int64_t to_nanoseconds() const { return tp.time_since_epoch().count(); }
+
+    const Type &get() const { return tp; }
+    Type &get() { return tp; }
+
+   private:
+    Type tp;
+};
+
+using SteadyTime = ClockTime<SteadyClock>;
+using CoarseSteadyTime = ClockTime<CoarseSteadyClock>;
+using CoarseTime = ClockTime<CoarseSystemClock>;
+using TscTime = ClockTime<TscClock>;
+
+namespace detail {
+
+template <typename T>
+struct TimeTraits;
+
+template <>
+struct TimeTraits<Time> {
+    static constexpr Epoch epoch = Epoch::REALTIME;
+    static Time from_nanoseconds(int64_t ns) { return Time(Time::Type(std::chrono::nanoseconds(ns))); }
+};
+
+template <typename C>
+struct TimeTraits<ClockTime<C>> {
+    static constexpr Epoch epoch = C::epoch;
+    static ClockTime<C> from_nanoseconds(int64_t ns) {
+        return ClockTime<C>(typename C::time_point(std::chrono::nanoseconds(ns)));
+    }
+};
+
+/**
+ * @brief Returns the nanoseconds to add to a time counted from epoch `from` to
+ * count it from epoch `to`, measured from a sample of both clocks.
+ *
+ */
+int64_t epoch_offset(Epoch from, Epoch to);
+
+void sleep_until(clockid_t clock, int64_t ns);
+
+}  // namespace detail
+
+/**
+ * @brief Converts a time to another clock, e.g. `time_cast<Time>(steady)` or
+ * `time_cast<SteadyTime>(stamp)`. Clocks with the same epoch convert exactly;
+ * otherwise the offset between the epochs is sampled, so the result is only
+ * as accurate as that sample (about a microsecond) and follows any later
+ * adjustment of the wall clock. `max()` and `min()` are preserved.
+ *
+ */
+template <typename To, typename From>
+To time_cast(const From &from) {
+    const int64_t ns = from.to_nanoseconds();
+    if constexpr (detail::TimeTraits<To>::epoch == detail::TimeTraits<From>::epoch) {
+        return detail::TimeTraits<To>::from_nanoseconds(ns);
+    } else {
+        if (ns == std::numeric_limits<int64_t>::max() || ns == std::numeric_limits<int64_t>::min()) {
+            return detail::TimeTraits<To>::from_nanoseconds(ns);
+        }
+        const int64_t offset =
+            detail::epoch_offset(detail::TimeTraits<From>::epoch, detail::TimeTraits<To>::epoch);
+        return detail::TimeTraits<To>::from_nanoseconds(ns + offset);
+    }
+}
+
 /**
  * @brief Sleep for a given duration
  * @param duration The duration to sleep for.
@@ -132,7 +339,17 @@ void sleep_for(const Duration &duration);
 void sleep_until(const Time &time);
 
 /**
- * @brief A class for measuring time.
+ * @brief Sleep until a given time of clock `C`, with an absolute
+ * `clock_nanosleep` on the clock's epoch.
+ * @param time The time to sleep until.
+ */
+template <typename C>
+void sleep_until(const ClockTime<C> &time) {
+    detail::sleep_until(C::epoch == Epoch::REALTIME ? CLOCK_REALTIME : CLOCK_MONOTONIC, time.to_nanoseconds());
+}
+
+/**
+ * @brief A class for measuring time with the monotonic clock.
  */
 class Timer {
    public:
@@ -161,12 +378,25 @@ class Timer {
     Duration get() const;
 
    private:
-    Time start_;  //< The start time.
-    Time end_;    //< The end time.
+    SteadyTime start_;  //< The start time.
+    SteadyTime end_;    //< The end time.
 };
 
 /**
- * @brief A class for setting the rate of a loop.
+ * @brief A class for setting the rate of a loop. Periods are measured with the
+ * monotonic clock, so setting the wall clock does not disturb the loop.
+ *
+ * @details In `Mode::DEADLINE` (the default) every cycle ends at a fixed
+ * deadline, one period after the previous one, and the loop sleeps until it
+ * with an absolute `clock_nanosleep`. Wakeup latency therefore does not
+ * accumulate as drift. A cycle that overruns its deadline is counted and the
+ * schedule skips ahead to the next deadline that is still in the future,
+ * keeping its phase. In `Mode::RELATIVE` each period starts when the previous
+ * sleep returned instead.
+ *
+ * With a spin window (see `set_spin`) the loop sleeps until the window before
+ * the deadline and busy-waits for the rest, trading CPU time for wakeups
+ * within a few microseconds of the deadline.
  *
  * @example shared_mutex.cpp
  * @example tcp_client.cpp
@@ -177,6 +407,43 @@ class Timer {
  */
 class Rate {
    public:
+    enum class Mode { DEADLINE, RELATIVE };
+
+    /**
+     * @brief Timing of the cycles since the rate was created or reset.
+     *
+     */
+    struct Stats {
+        static constexpr size_t BUCKETS = 16;
+
+        uint64_t cycles;      /**< Calls to `sleep` */
+        uint64_t overruns;    /**< Cycles that ended after their deadline */
+        uint64_t missed;      /**< Deadlines skipped because of overruns */
+        Duration max_jitter;  /**< Largest lateness of a wakeup */
+        Duration total_jitter;
+
+        /**
+         * @brief Histogram of wakeup lateness. Bucket `i` counts wakeups less
+         * than `bucket_limit(i)` late (and at least `bucket_limit(i - 1)`); the
+         * last bucket counts all later ones.
+         *
+         */
+        std::array<uint64_t, BUCKETS> histogram;
+
+        /**
+         * @brief Returns the mean lateness of a wakeup.
+         *
+         */
+        Duration mean_jitter() const;
+
+        /**
+         * @brief Returns the upper limit of histogram bucket `i`, 2^i
+         * microseconds.
+         *
+         */
+        static Duration bucket_limit(size_t i);
+    };
+
     static inline double min_frequency() { return (1e9 / std::chrono::nanoseconds::max().count()); }
     static inline double max_frequency() { return 1e9; }
     static inline Duration min_period() { return Duration(0, 1); }
@@ -195,18 +462,44 @@ class Rate {
 
     /**
      * @brief Sleeps for the time required to maintain the rate.
-     * @return True if the sleep duration was met, false otherwise.
+     * @return True if the sleep duration was met, false if the deadline had
+     * already passed.
      */
     bool sleep();
 
+    /**
+     * @brief Starts a new schedule from now and clears the statistics.
+     *
+     */
+    void reset();
+
     Duration period() const;
     void set_period(const Duration &period);
     double frequency() const;
     void set_frequency(double frequency);
 
+    Mode mode() const;
+    void set_mode(Mode mode);
+
+    /**
+     * @brief Sets how long before each deadline `sleep` stops sleeping and
+     * busy-waits instead. 0 (the default) disables spinning. About 50 to 100
+     * microseconds covers typical wakeup latency.
+     *
+     */
+    void set_spin(const Duration &window);
+    Duration spin() const;
+
+    const Stats &stats() const;
+
    private:
+    void record(const Duration &lateness);
+
     Duration period_;
-    Time start_;
+    SteadyTime start_;  //< The start of the current cycle
+    Mode mode_;
+    Duration spin_;
+    Stats stats_;
 };
 
 }  // namespace util
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "rix/ipc/file.hpp"
+#include "rix/util/time.hpp"
+
+namespace rix {
+namespace util {
+
+/**
+ * @class TimerWheel
+ * @brief Runs many one-shot and periodic timers from a single thread, driven by
+ * one `timerfd`, so watchdogs, heartbeats and periodic publishers do not each
+ * need a thread.
+ *
+ * @details Timers are kept in a hierarchical timing wheel of four levels with
+ * 256 slots each. Level 0 holds timers due within 256 ticks, one slot per
+ * tick; each higher level covers 256 times the range of the one below, and
+ * its timers are moved down a level when the wheel reaches their slot. Adding
+ * and cancelling a timer is O(1). Expiry times are rounded up to whole ticks
+ * of `resolution` on the monotonic clock (periods to the nearest tick), and
+ * timers further away than 2^32 ticks are cascaded again until they are due.
+ *
+ * The timerfd (see `fd`) is armed for the next tick at which a timer is due or
+ * must be cascaded, so an idle wheel does not wake up every tick. Add it to a
+ * `Selector` (or any poll loop) and call `process` when it is readable, or
+ * call `wait`:
+ *
+ *     TimerWheel wheel;
+ *     wheel.add_periodic(Duration(0.5), [&]() { send_heartbeat(); });
+ *     auto watchdog = wheel.add(Duration(0.1), [&]() { stop_motors(); });
+ *     while (running) {
+ *         wheel.wait(Duration(1.0));
+ *         ...
+ *         wheel.cancel(watchdog);
+ *     }
+ *
+ * A TimerWheel is not thread-safe. Callbacks run in the thread that calls
+ * `process` and may add and cancel timers, including their own.
+ *
+ */
+class TimerWheel {
+   public:
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Identifies a timer. Each id carries a generation count, so
+     * cancelling a timer that already expired does not cancel a later timer
+     * stored in the same place.
+     *
+     */
+    using Id = uint64_t;
+
+    static constexpr Id INVALID_ID = 0;
+
+    /**
+     * @brief Creates a timer wheel and its timerfd. If the timerfd could not be
+     * created, the object is left in an invalid state (`ok` returns `false`).
+     *
+     * @param resolution The duration of one tick
+     */
+    TimerWheel(const Duration &resolution = Duration(0.001));
+
+    TimerWheel(const TimerWheel &other) = delete;
+    TimerWheel &operator=(const TimerWheel &other) = delete;
+
+    /**
+     * @brief Adds a one-shot timer.
+     *
+     * @param delay The time from now after which `callback` runs
+     * @param callback The function to run
+     * @return Id The id of the timer, or INVALID_ID if the wheel is invalid.
+     */
+    Id add(const Duration &delay, Callback callback);
+
+    /**
+     * @brief Adds a periodic timer. Expirations follow a fixed schedule, so
+     * late processing does not accumulate as drift; periods that were missed
+     * entirely are skipped.
+     *
+     * @param period The time between runs of `callback`
+     * @param callback The function to run
+     * @param delay The time from now until the first run (one period if
+     * negative)
+     * @return Id The id of the timer, or INVALID_ID if the wheel is invalid.
+     */
+    Id add_periodic(const Duration &period, Callback callback, const Duration &delay = Duration(-1.0));
+
+    /**
+     * @brief Cancels a timer.
+     *
+     * @return true if the timer was pending, false if it had already expired
+     * or been cancelled.
+     */
+    bool cancel(Id id);
+
+    /**
+     * @brief Runs the callbacks of every timer that is due and rearms the
+     * timerfd.
+     *
+     * @return size_t The number of callbacks run
+     */
+    size_t process();
+
+    /**
+     * @brief Waits until a timer is due or until `duration` elapses, then calls
+     * `process`.
+     *
+     * @return size_t The number of callbacks run
+     */
+    size_t wait(const Duration &duration);
+
+    /**
+     * @brief Returns the timerfd. It becomes readable when a timer is due.
+     *
+     */
+    int fd() const;
+
+    /**
+     * @brief Returns `true` if the timerfd is in a valid state.
+     *
+     */
+    bool ok() const;
+
+    /**
+     * @brief Returns the number of pending timers.
+     *
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the duration of one tick.
+     *
+     */
+    Duration resolution() const;
+
+   private:
+    static constexpr size_t LEVELS = 4;
+    static constexpr size_t SLOT_BITS = 8;
+    static constexpr size_t SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    struct Node {
+        uint64_t expiry;    /**< The tick at which the timer is due */
+        uint64_t period;    /**< Period in ticks, or 0 for a one-shot timer */
+        Callback callback;
+        uint32_t generation;
+        uint32_t slot;      /**< Slot the node is linked into, or NONE */
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    Id insert(uint64_t expiry, uint64_t period, Callback callback);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(size_t level);
+    size_t expire();
+    size_t advance(uint64_t target);
+    size_t distance(size_t level, size_t from) const;
+    uint64_t next_tick() const;
+    void arm();
+    uint64_t ticks(const Duration &duration) const;
+    uint64_t tick_at(const SteadyTime &time, bool round_up) const;
+
+    ipc::File file_;
+    Duration resolution_;
+    SteadyTime origin_;     /**< Time of tick 0 */
+    uint64_t current_;      /**< The last tick processed */
+    uint64_t armed_;        /**< The tick the timerfd is armed for, or NEVER */
+    std::deque<Node> nodes_;  /**< A deque, so a running callback is not moved when timers are added */
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, LEVELS * SLOTS> slots_;
+    std::array<uint64_t, LEVELS * SLOTS / 64> occupied_;  /**< Bitmap of non-empty slots */
+    size_t size_;
+    uint32_t firing_;       /**< The node whose callback is running, or NONE */
+    bool firing_cancelled_;
+};
+
+}  // namespace util
+}  // namespace rix
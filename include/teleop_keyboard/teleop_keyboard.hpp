@@ -1,9 +1,13 @@
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
+#include "rix/ipc/channel.hpp"
 #include "rix/ipc/fifo.hpp"
 #include "rix/ipc/file.hpp"
+#include "rix/ipc/intra_channel.hpp"
 #include "rix/ipc/signal.hpp"
 #include "rix/msg/geometry/Twist2DStamped.hpp"
 #include "rix/msg/standard/UInt32.hpp"
@@ -16,15 +20,43 @@ using namespace rix::util;
 
 class TeleopKeyboard {
    public:
+    /**
+     * @brief What to do with a new command when the output queue is full
+     * because the consumer is not keeping up. A stop command (space bar) is
+     * never dropped: under DROP_NEWEST it replaces the oldest queued command.
+     *
+     */
+    enum class OverflowPolicy : int {
+        DROP_OLDEST,        /**< Discard the oldest queued command */
+        DROP_NEWEST,        /**< Discard the new command */
+        COLLAPSE_TO_LATEST  /**< Keep only the latest command, whatever the queue size */
+    };
+
     TeleopKeyboard(std::unique_ptr<rix::ipc::interfaces::IO> input,
                    std::unique_ptr<rix::ipc::interfaces::IO> output, double linear_speed,
-                   double angular_speed);
+                   double angular_speed, size_t queue_capacity = 64,
+                   OverflowPolicy policy = OverflowPolicy::DROP_OLDEST);
 
     void spin(std::unique_ptr<rix::ipc::interfaces::Notification> notif);
 
+    /**
+     * @brief Returns the number of commands discarded by the overflow policy,
+     * or because an `IntraChannel` output was full.
+     *
+     */
+    size_t dropped() const;
+
    private:
+    void enqueue(std::vector<uint8_t> &&frame, bool stop);
+    bool flush();
+
     std::unique_ptr<rix::ipc::interfaces::IO> input;
     std::unique_ptr<rix::ipc::interfaces::IO> output;
     double linear_speed;
     double angular_speed;
+    size_t queue_capacity;
+    OverflowPolicy policy;
+    std::deque<std::vector<uint8_t>> pending;  /**< Framed commands waiting for the output */
+    size_t pending_offset;                     /**< Bytes of the front frame already written */
+    size_t dropped_frames;
 };
\ No newline at end of file
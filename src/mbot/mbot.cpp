@@ -1,5 +1,8 @@
 #include "mbot/mbot.hpp"
 
+#include "rix/ipc/selector.hpp"
+#include "rix/util/timer_wheel.hpp"
+
 MBot::MBot() : file("/dev/mbot_lcm", O_RDWR | O_NOCTTY | O_NDELAY, 0) {
     if (!file.ok()) {
         perror("open");
@@ -28,8 +31,8 @@ MBot::MBot() : file("/dev/mbot_lcm", O_RDWR | O_NOCTTY | O_NDELAY, 0) {
 }
 
 MBot::~MBot() {
-    // Set the stop flag for the time synchronization thread
-    stop_timesync_flag = 1;
+    // Wake the time synchronization thread so it stops immediately
+    stop_timesync.raise();
 
     // Join the time synchronization thread
     if (timesync_thr.joinable()) {
@@ -58,32 +61,61 @@ void MBot::drive(const Twist2DStamped &cmd) const {
 }
 
 void MBot::timesync() {
-    int status;
-
-    // Time synchronization loop
-    while (!stop_timesync_flag) {
-        // Encode the timesync message
-        serial_timestamp_t msg = {0};
-        struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
-        msg.utime = ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
-        const size_t msg_size = sizeof(serial_timestamp_t) + ROS_PKG_LENGTH;
-        uint8_t rospkt[msg_size];
-        if (encode_msg((uint8_t *)&msg, sizeof(serial_timestamp_t), MBOT_TIMESYNC, rospkt, msg_size) < 0) {
-            perror("encode_msg");
-            break;
+    // Run at 2 Hz from a timer wheel, which also leaves room for other
+    // periodic work on this thread
+    rix::util::TimerWheel wheel;
+    if (!wheel.ok()) {
+        // Without a timerfd, send at 2 Hz from a plain timed wait instead
+        perror("timerfd_create");
+        while (send_timesync()) {
+            if (stop_timesync.wait(rix::util::Duration(0.5))) {
+                return;
+            }
         }
+        return;
+    }
+    bool failed = false;
+    wheel.add_periodic(rix::util::Duration(0.5), [this, &failed]() { failed = !send_timesync(); },
+                       rix::util::Duration(0.0));
 
-        // Send the timesync message
-        mtx.lock();
-        status = file.write(rospkt, msg_size);
-        mtx.unlock();
-        if (status < 0) {
-            perror("write");
+    rix::ipc::Selector selector;
+    selector.add(wheel.fd());
+    selector.add(stop_timesync.fd());
+    std::vector<rix::ipc::Selector::Ready> ready;
+    while (!failed && wheel.ok()) {
+        if (selector.wait(rix::util::Duration::max(), ready) < 0) {
+            perror("ppoll");
             break;
         }
+        for (auto &r : ready) {
+            if (r.fd == stop_timesync.fd()) {
+                return;
+            }
+        }
+        wheel.process();
+    }
+}
+
+bool MBot::send_timesync() {
+    // Encode the timesync message
+    serial_timestamp_t msg = {0};
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    msg.utime = ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    const size_t msg_size = sizeof(serial_timestamp_t) + ROS_PKG_LENGTH;
+    uint8_t rospkt[msg_size];
+    if (encode_msg((uint8_t *)&msg, sizeof(serial_timestamp_t), MBOT_TIMESYNC, rospkt, msg_size) < 0) {
+        perror("encode_msg");
+        return false;
+    }
 
-        // Run at 2 Hz
-        usleep(500000);
+    // Send the timesync message
+    mtx.lock();
+    int status = file.write(rospkt, msg_size);
+    mtx.unlock();
+    if (status < 0) {
+        perror("write");
+        return false;
     }
-}
\ No newline at end of file
+    return true;
+}
@@ -20,30 +20,34 @@ void MBotDriver::spin(std::unique_ptr<interfaces::Notification> notif) {
         return (notif != nullptr) && notif->wait(rix::util::Duration(0.0));
     };
 
+    // A colocated TeleopKeyboard passes messages through an IntraChannel
+    // without serialization
+    auto *intra = dynamic_cast<IntraChannel<rix::msg::geometry::Twist2DStamped> *>(input.get());
+    if (intra != nullptr) {
+        std::shared_ptr<const rix::msg::geometry::Twist2DStamped> cmd;
+        while (true) {
+            if (notif_ready()) {
+                send_stop();
+                return;
+            }
+            if (intra->pop(cmd)) {
+                mbot->drive(*cmd);
+                continue;
+            }
+            if (errno != EAGAIN) {
+                send_stop();  // write end closed
+                return;
+            }
+            intra->wait_for_readable(rix::util::Duration(0.001));  // 1ms
+        }
+    }
+
     // Nonblocking input so tests can simulate partial availability
     input->set_nonblocking(true);
 
-    auto read_exact = [&](uint8_t* dst, size_t n) -> bool {
-        size_t got = 0;
-        while (got < n) {
-            ssize_t r = input->read(dst + got, n - got);
-            if (r == 0) return false;                // EOF
-            if (r < 0) {
-                if (errno == EINTR) continue;        // interrupted by signal, retry
-                if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    // Only check notification when we'd otherwise block
-                    if (notif_ready()) return false;
-
-                    // Wait briefly for more bytes
-                    input->wait_for_readable(rix::util::Duration(0.001)); // 1ms
-                    continue;
-                }
-                return false; // real error
-            }
-            got += static_cast<size_t>(r);
-        }
-        return true;
-    };
+    // The notification is only checked when the channel would otherwise block
+    Channel<rix::msg::geometry::Twist2DStamped> channel(*input);
+    rix::msg::geometry::Twist2DStamped cmd{};
 
     while (true) {
         // Check notification between full messages (not in a tight loop)
@@ -53,35 +57,11 @@ void MBotDriver::spin(std::unique_ptr<interfaces::Notification> notif) {
             return;
         }
 
-        // Read 4-byte size prefix
-        uint8_t size_buf[4];
-        if (!read_exact(size_buf, 4)) {
-            send_stop(); // EOF or error
-            return;
-        }
-
-        uint32_t msg_size = 0;
-        size_t off = 0;
-        if (!::rix::msg::detail::deserialize_number<uint32_t>(msg_size, size_buf, 4, off)) {
-            send_stop();
-            return;
-        }
-
-        // Read payload
-        std::vector<uint8_t> payload(msg_size);
-        if (msg_size > 0) {
-            if (!read_exact(payload.data(), msg_size)) {
-                send_stop();
-                return;
-            }
-        }
-
-        // Deserialize + drive
-        rix::msg::geometry::Twist2DStamped cmd{};
-        off = 0;
-        if (!cmd.deserialize(payload.data(), payload.size(), off)) {
+        if (!channel.read(cmd, notif_ready)) {
             // Bad message: ignore and continue
-            continue;
+            if (errno == EBADMSG) continue;
+            send_stop();  // EOF, notification or error
+            return;
         }
 
         mbot->drive(cmd);
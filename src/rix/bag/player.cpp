@@ -0,0 +1,94 @@
+#include "rix/bag/player.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "rix/msg/serialization.hpp"
+
+namespace rix {
+namespace bag {
+
+namespace {
+
+// Longest uninterrupted sleep, so a replay with long gaps still stops promptly
+const util::Duration MAX_SLEEP(0.1);
+
+}  // namespace
+
+double Player::Stats::rate() const {
+    const double seconds = elapsed.to_nanoseconds() * 1e-9;
+    return seconds > 0.0 ? (frames - 1) / seconds : 0.0;
+}
+
+Player::Player(Reader &reader, ipc::interfaces::IO &output, double scale)
+    : reader_(reader), output_(output), scale_(std::max(scale, 0.0)), stats_{0, {}, {}, {}}, frame_() {}
+
+bool Player::play(const std::function<bool()> &interrupted) {
+    Record record;
+    util::Time first_stamp;
+    util::SteadyTime start, last;
+    int64_t total_error = 0;
+    // Each call is a new replay, timed from its own first record
+    stats_ = Stats{0, {}, {}, {}};
+
+    while (reader_.next(record)) {
+        if (interrupted && interrupted()) {
+            return false;
+        }
+
+        util::SteadyTime target = util::SteadyTime::now();
+        if (stats_.frames == 0) {
+            first_stamp = record.stamp;
+            start = target;
+        } else if (scale_ > 0.0) {
+            target = start + (record.stamp - first_stamp) / scale_;
+            for (auto now = util::SteadyTime::now(); now < target; now = util::SteadyTime::now()) {
+                if (interrupted && interrupted()) {
+                    return false;
+                }
+                util::sleep_until(std::min(target, now + MAX_SLEEP));
+            }
+        }
+
+        if (!write_frame(record, interrupted)) {
+            return false;
+        }
+        last = util::SteadyTime::now();
+
+        const util::Duration error = (scale_ > 0.0) ? last - target : util::Duration(0);
+        total_error += error.to_nanoseconds();
+        stats_.frames++;
+        stats_.elapsed = last - start;
+        stats_.mean_error = util::Duration(std::chrono::nanoseconds(total_error / static_cast<int64_t>(stats_.frames)));
+        stats_.max_error = std::max(stats_.max_error, error);
+    }
+    return true;
+}
+
+bool Player::write_frame(const Record &record, const std::function<bool()> &interrupted) {
+    const uint32_t size = static_cast<uint32_t>(record.data.size());
+    frame_.resize(4 + size);
+    size_t offset = 0;
+    rix::msg::detail::serialize_number<uint32_t>(frame_.data(), offset, size);
+    std::memcpy(frame_.data() + offset, record.data.data(), size);
+
+    size_t sent = 0;
+    while (sent < frame_.size()) {
+        ssize_t w = output_.write(frame_.data() + sent, frame_.size() - sent);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            if (interrupted && interrupted()) return false;
+            output_.wait_for_writable(util::Duration(0.001));  // 1ms
+            continue;
+        }
+        sent += static_cast<size_t>(w);
+    }
+    return true;
+}
+
+const Player::Stats &Player::stats() const { return stats_; }
+
+}  // namespace bag
+}  // namespace rix
@@ -0,0 +1,240 @@
+#include "rix/bag/reader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include "rix/msg/serialization.hpp"
+
+namespace rix {
+namespace bag {
+
+using rix::msg::detail::deserialize_number;
+
+namespace {
+
+constexpr int64_t NS_MIN = std::numeric_limits<int64_t>::min();
+constexpr int64_t NS_MAX = std::numeric_limits<int64_t>::max();
+
+bool parse_chunk_header(const uint8_t *src, ChunkInfo &info, uint32_t &used) {
+    uint32_t magic = 0;
+    size_t offset = 0;
+    const size_t size = format::CHUNK_HEADER_SIZE;
+    deserialize_number(magic, src, size, offset);
+    deserialize_number(used, src, size, offset);
+    deserialize_number(info.count, src, size, offset);
+    deserialize_number(info.size, src, size, offset);
+    deserialize_number(info.start, src, size, offset);
+    deserialize_number(info.end, src, size, offset);
+    return magic == format::CHUNK_MAGIC && info.size >= format::CHUNK_HEADER_SIZE + used &&
+           info.size % format::ALIGNMENT == 0;
+}
+
+}  // namespace
+
+Reader::Reader()
+    : map_(),
+      chunks_(),
+      max_end_(),
+      min_start_(),
+      count_(0),
+      indexed_(false),
+      ok_(false),
+      begin_(NS_MIN),
+      end_(NS_MAX),
+      next_chunk_(0),
+      offset_(0),
+      chunk_end_(0) {}
+
+Reader::Reader(const std::string &pathname) : Reader() {
+    map_ = ipc::MappedFile(pathname, ipc::MappedFile::Mode::READ);
+    if (!map_.ok()) {
+        return;
+    }
+
+    auto bytes = map_.data();
+    uint32_t version = 0;
+    size_t offset = format::FILE_MAGIC.size();
+    if (bytes.size() < format::FILE_HEADER_SIZE ||
+        std::memcmp(bytes.data(), format::FILE_MAGIC.data(), format::FILE_MAGIC.size()) != 0 ||
+        !deserialize_number(version, bytes.data(), bytes.size(), offset) || version != format::VERSION) {
+        errno = EINVAL;
+        return;
+    }
+
+    indexed_ = load_index();
+    if (!indexed_) {
+        scan();
+    }
+
+    // Running bounds make the binary search in seek valid even if stamps do
+    // not increase from chunk to chunk
+    max_end_.resize(chunks_.size());
+    min_start_.resize(chunks_.size());
+    int64_t latest = NS_MIN;
+    for (size_t i = 0; i < chunks_.size(); i++) {
+        latest = std::max(latest, chunks_[i].end);
+        max_end_[i] = latest;
+    }
+    int64_t earliest = NS_MAX;
+    for (size_t i = chunks_.size(); i-- > 0;) {
+        earliest = std::min(earliest, chunks_[i].start);
+        min_start_[i] = earliest;
+    }
+    ok_ = true;
+}
+
+bool Reader::load_index() {
+    auto bytes = map_.data();
+    if (bytes.size() < format::FILE_HEADER_SIZE + format::FOOTER_SIZE) {
+        return false;
+    }
+    const uint8_t *footer = bytes.data() + bytes.size() - format::FOOTER_SIZE;
+    uint64_t index_offset = 0, chunk_count = 0, record_count = 0;
+    size_t offset = 0;
+    deserialize_number(index_offset, footer, format::FOOTER_SIZE, offset);
+    deserialize_number(chunk_count, footer, format::FOOTER_SIZE, offset);
+    deserialize_number(record_count, footer, format::FOOTER_SIZE, offset);
+    // Bounded before they are added, so a corrupt footer cannot overflow
+    if (std::memcmp(footer + offset, format::INDEX_MAGIC.data(), format::INDEX_MAGIC.size()) != 0 ||
+        index_offset < format::FILE_HEADER_SIZE || index_offset > bytes.size() - format::FOOTER_SIZE ||
+        chunk_count > (bytes.size() - format::FOOTER_SIZE - index_offset) / format::INDEX_ENTRY_SIZE ||
+        index_offset + chunk_count * format::INDEX_ENTRY_SIZE + format::FOOTER_SIZE != bytes.size()) {
+        return false;
+    }
+
+    const uint8_t *index = bytes.data() + index_offset;
+    const size_t size = chunk_count * format::INDEX_ENTRY_SIZE;
+    chunks_.resize(chunk_count);
+    offset = 0;
+    for (auto &info : chunks_) {
+        deserialize_number(info.offset, index, size, offset);
+        deserialize_number(info.count, index, size, offset);
+        deserialize_number(info.size, index, size, offset);
+        deserialize_number(info.start, index, size, offset);
+        deserialize_number(info.end, index, size, offset);
+        if (info.offset < format::FILE_HEADER_SIZE || info.offset > index_offset ||
+            info.size < format::CHUNK_HEADER_SIZE || info.size > index_offset - info.offset) {
+            chunks_.clear();
+            return false;
+        }
+    }
+    count_ = record_count;
+    return true;
+}
+
+void Reader::scan() {
+    auto bytes = map_.data();
+    chunks_.clear();
+    count_ = 0;
+    uint64_t offset = format::FILE_HEADER_SIZE;
+    while (offset + format::CHUNK_HEADER_SIZE <= bytes.size()) {
+        ChunkInfo info{};
+        uint32_t used = 0;
+        // A chunk that was never completely written ends the scan
+        if (!parse_chunk_header(bytes.data() + offset, info, used) || offset + info.size > bytes.size()) {
+            break;
+        }
+        info.offset = offset;
+        chunks_.push_back(info);
+        count_ += info.count;
+        offset += info.size;
+    }
+}
+
+bool Reader::load_chunk(size_t index) {
+    const ChunkInfo &info = chunks_[index];
+    const size_t mapped = map_.size();
+    if (info.offset > mapped || info.size < format::CHUNK_HEADER_SIZE || info.size > mapped - info.offset) {
+        errno = EINVAL;
+        return false;
+    }
+    // The header bounds the records, so it must describe the same chunk as
+    // the index (parse_chunk_header checks that the records fit in it)
+    ChunkInfo header{};
+    uint32_t used = 0;
+    if (!parse_chunk_header(map_.data().data() + info.offset, header, used) || header.size != info.size) {
+        errno = EINVAL;
+        return false;
+    }
+    map_.advise(ipc::MappedFile::Advice::WILLNEED, info.offset, info.size);
+    offset_ = info.offset + format::CHUNK_HEADER_SIZE;
+    chunk_end_ = offset_ + used;
+    return true;
+}
+
+bool Reader::next(Record &record) {
+    auto bytes = map_.data();
+    while (true) {
+        while (offset_ >= chunk_end_) {
+            // Stop once no remaining chunk can hold a record in the range
+            if (next_chunk_ >= chunks_.size() || min_start_[next_chunk_] > end_) {
+                return false;
+            }
+            const ChunkInfo &info = chunks_[next_chunk_++];
+            if (info.end < begin_ || info.start > end_) {
+                continue;
+            }
+            if (!load_chunk(next_chunk_ - 1)) {
+                return false;
+            }
+        }
+
+        int64_t ns = 0;
+        uint32_t size = 0;
+        size_t offset = offset_;
+        if (!deserialize_number(ns, bytes.data(), chunk_end_, offset) ||
+            !deserialize_number(record.hash[0], bytes.data(), chunk_end_, offset) ||
+            !deserialize_number(record.hash[1], bytes.data(), chunk_end_, offset) ||
+            !deserialize_number(size, bytes.data(), chunk_end_, offset) || offset + size > chunk_end_) {
+            offset_ = chunk_end_;
+            return false;
+        }
+        offset_ = offset + size;
+        if (ns < begin_ || ns > end_) {
+            continue;
+        }
+        record.stamp = util::Time(util::Time::Type(std::chrono::nanoseconds(ns)));
+        record.data = bytes.subspan(offset, size);
+        return true;
+    }
+}
+
+bool Reader::seek(const util::Time &begin, const util::Time &end) {
+    begin_ = begin.to_nanoseconds();
+    end_ = end.to_nanoseconds();
+    offset_ = 0;
+    chunk_end_ = 0;
+    // The first chunk whose records may reach begin; all earlier chunks end
+    // before it
+    next_chunk_ = std::lower_bound(max_end_.begin(), max_end_.end(), begin_) - max_end_.begin();
+    return next_chunk_ < chunks_.size() && min_start_[next_chunk_] <= end_;
+}
+
+void Reader::rewind() {
+    begin_ = NS_MIN;
+    end_ = NS_MAX;
+    next_chunk_ = 0;
+    offset_ = 0;
+    chunk_end_ = 0;
+}
+
+const std::vector<ChunkInfo> &Reader::chunks() const { return chunks_; }
+
+size_t Reader::size() const { return count_; }
+
+util::Time Reader::start() const {
+    return min_start_.empty() ? util::Time::max() : util::Time(util::Time::Type(std::chrono::nanoseconds(min_start_[0])));
+}
+
+util::Time Reader::end() const {
+    return max_end_.empty() ? util::Time::min() : util::Time(util::Time::Type(std::chrono::nanoseconds(max_end_.back())));
+}
+
+bool Reader::indexed() const { return indexed_; }
+
+bool Reader::ok() const { return ok_; }
+
+}  // namespace bag
+}  // namespace rix
@@ -0,0 +1,246 @@
+#include "rix/bag/writer.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "rix/msg/serialization.hpp"
+
+namespace rix {
+namespace bag {
+
+using rix::msg::detail::serialize_number;
+
+namespace {
+
+size_t round_up(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+Writer::Writer(const std::string &pathname, size_t chunk_size, size_t max_pending, const util::Duration &max_age)
+    : file_(pathname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644),
+      chunk_size_(round_up(std::max(chunk_size, format::CHUNK_HEADER_SIZE + format::RECORD_HEADER_SIZE),
+                           format::ALIGNMENT)),
+      max_pending_(std::max<size_t>(max_pending, 1)),
+      max_age_(max_age),
+      allocated_(0),
+      next_offset_(format::FILE_HEADER_SIZE),
+      count_(0),
+      dropped_(0),
+      open_(false),
+      current_(),
+      index_(),
+      mutex_(),
+      cv_(),
+      full_(),
+      free_(),
+      stopping_(false),
+      failed_(false),
+      flusher_() {
+    if (!file_.ok()) {
+        return;
+    }
+    std::vector<uint8_t> header(format::FILE_HEADER_SIZE, 0);
+    std::memcpy(header.data(), format::FILE_MAGIC.data(), format::FILE_MAGIC.size());
+    size_t offset = format::FILE_MAGIC.size();
+    serialize_number<uint32_t>(header.data(), offset, format::VERSION);
+    serialize_number<uint32_t>(header.data(), offset, format::ALIGNMENT);
+    if (!write_at(header.data(), header.size(), 0)) {
+        return;
+    }
+    open_ = true;
+    flusher_ = std::thread(&Writer::flush_loop, this);
+}
+
+Writer::~Writer() { close(); }
+
+bool Writer::write(const uint8_t *data, size_t size, const std::array<uint64_t, 2> &hash, const util::Time &stamp) {
+    uint8_t *dst = reserve(size, hash, stamp);
+    if (dst == nullptr) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(dst, data, size);
+    }
+    return true;
+}
+
+uint8_t *Writer::reserve(size_t size, const std::array<uint64_t, 2> &hash, const util::Time &stamp) {
+    if (!open_) {
+        errno = EBADF;
+        return nullptr;
+    }
+    const size_t record_size = format::RECORD_HEADER_SIZE + size;
+    if (format::CHUNK_HEADER_SIZE + record_size > chunk_size_) {
+        errno = EMSGSIZE;
+        return nullptr;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (current_ != nullptr && current_->count > 0 &&
+        (current_->used + record_size > chunk_size_ || now - current_->opened >= max_age_.get())) {
+        seal();
+    }
+    if (current_ == nullptr) {
+        current_ = acquire();
+        if (current_ == nullptr) {
+            dropped_++;
+            errno = ENOBUFS;
+            return nullptr;
+        }
+    }
+
+    Chunk &chunk = *current_;
+    const int64_t ns = stamp.to_nanoseconds();
+    uint8_t *base = chunk.data.get();
+    size_t offset = chunk.used;
+    serialize_number<int64_t>(base, offset, ns);
+    serialize_number<uint64_t>(base, offset, hash[0]);
+    serialize_number<uint64_t>(base, offset, hash[1]);
+    serialize_number<uint32_t>(base, offset, static_cast<uint32_t>(size));
+
+    // Stamps are not required to increase, so keep the chunk's time range
+    chunk.start = (chunk.count == 0) ? ns : std::min(chunk.start, ns);
+    chunk.end = (chunk.count == 0) ? ns : std::max(chunk.end, ns);
+    if (chunk.count == 0) {
+        chunk.opened = now;
+    }
+    chunk.count++;
+    chunk.used = offset + size;
+    count_++;
+    return base + offset;
+}
+
+std::unique_ptr<Writer::Chunk> Writer::acquire() {
+    std::unique_ptr<Chunk> chunk;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            chunk = std::move(free_.back());
+            free_.pop_back();
+        }
+    }
+    if (chunk == nullptr) {
+        // Only allocate a new buffer while fewer than max_pending exist
+        void *data = nullptr;
+        if (allocated_ >= max_pending_ || ::posix_memalign(&data, format::ALIGNMENT, chunk_size_) != 0) {
+            return nullptr;
+        }
+        allocated_++;
+        chunk.reset(new Chunk{{static_cast<uint8_t *>(data), std::free}, 0, 0, 0, 0, 0, 0, {}});
+    }
+    chunk->used = format::CHUNK_HEADER_SIZE;
+    chunk->count = 0;
+    chunk->start = 0;
+    chunk->end = 0;
+    return chunk;
+}
+
+void Writer::seal() {
+    Chunk &chunk = *current_;
+    const size_t padded = round_up(chunk.used, format::ALIGNMENT);
+    uint8_t *base = chunk.data.get();
+    std::memset(base + chunk.used, 0, padded - chunk.used);
+
+    size_t offset = 0;
+    serialize_number<uint32_t>(base, offset, format::CHUNK_MAGIC);
+    serialize_number<uint32_t>(base, offset, static_cast<uint32_t>(chunk.used - format::CHUNK_HEADER_SIZE));
+    serialize_number<uint32_t>(base, offset, chunk.count);
+    serialize_number<uint32_t>(base, offset, static_cast<uint32_t>(padded));
+    serialize_number<int64_t>(base, offset, chunk.start);
+    serialize_number<int64_t>(base, offset, chunk.end);
+
+    chunk.offset = next_offset_;
+    chunk.size = static_cast<uint32_t>(padded);
+    next_offset_ += padded;
+    index_.push_back({chunk.offset, chunk.count, chunk.size, chunk.start, chunk.end});
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        full_.push_back(std::move(current_));
+    }
+    cv_.notify_one();
+}
+
+void Writer::flush_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stopping_ || !full_.empty(); });
+        if (full_.empty()) {
+            return;
+        }
+        std::unique_ptr<Chunk> chunk = std::move(full_.front());
+        full_.pop_front();
+
+        lock.unlock();
+        bool written = write_at(chunk->data.get(), chunk->size, chunk->offset);
+        lock.lock();
+
+        failed_ = failed_ || !written;
+        free_.push_back(std::move(chunk));
+    }
+}
+
+bool Writer::write_at(const uint8_t *src, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t w = ::pwrite(file_.fd(), src, size, static_cast<off_t>(offset));
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        src += w;
+        size -= static_cast<size_t>(w);
+        offset += static_cast<uint64_t>(w);
+    }
+    return true;
+}
+
+bool Writer::close() {
+    if (!open_) {
+        return file_.ok() && !failed_;
+    }
+    if (current_ != nullptr && current_->count > 0) {
+        seal();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    flusher_.join();
+    open_ = false;
+
+    std::vector<uint8_t> tail(index_.size() * format::INDEX_ENTRY_SIZE + format::FOOTER_SIZE);
+    size_t offset = 0;
+    for (const auto &info : index_) {
+        serialize_number<uint64_t>(tail.data(), offset, info.offset);
+        serialize_number<uint32_t>(tail.data(), offset, info.count);
+        serialize_number<uint32_t>(tail.data(), offset, info.size);
+        serialize_number<int64_t>(tail.data(), offset, info.start);
+        serialize_number<int64_t>(tail.data(), offset, info.end);
+    }
+    serialize_number<uint64_t>(tail.data(), offset, next_offset_);
+    serialize_number<uint64_t>(tail.data(), offset, index_.size());
+    serialize_number<uint64_t>(tail.data(), offset, count_);
+    std::memcpy(tail.data() + offset, format::INDEX_MAGIC.data(), format::INDEX_MAGIC.size());
+
+    if (!write_at(tail.data(), tail.size(), next_offset_)) {
+        failed_ = true;
+    }
+    return !failed_;
+}
+
+bool Writer::ok() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_ && !failed_;
+}
+
+size_t Writer::count() const { return count_; }
+
+size_t Writer::dropped() const { return dropped_; }
+
+}  // namespace bag
+}  // namespace rix
@@ -0,0 +1,78 @@
+#include "rix/ipc/event_notification.hpp"
+
+namespace rix {
+namespace ipc {
+
+EventNotification::EventNotification(Mode mode, uint32_t initial_value) : file_(), mode_(mode) {
+    // Non-blocking so that a waiter that loses a race for the counter returns
+    // instead of blocking in read
+    int flags = EFD_CLOEXEC | EFD_NONBLOCK;
+    if (mode == Mode::SEMAPHORE) {
+        flags |= EFD_SEMAPHORE;
+    }
+    file_ = File(::eventfd(initial_value, flags));
+}
+
+EventNotification::EventNotification(const EventNotification &other) : file_(), mode_(other.mode_) {
+    file_ = other.file_;
+}
+
+EventNotification &EventNotification::operator=(const EventNotification &other) {
+    if (this == &other) {
+        return *this;
+    }
+    file_ = other.file_;
+    mode_ = other.mode_;
+    return *this;
+}
+
+EventNotification::EventNotification(EventNotification &&other)
+    : file_(std::move(other.file_)), mode_(other.mode_) {}
+
+EventNotification &EventNotification::operator=(EventNotification &&other) {
+    file_ = std::move(other.file_);
+    mode_ = other.mode_;
+    return *this;
+}
+
+EventNotification::~EventNotification() {}
+
+bool EventNotification::raise() const { return post(1); }
+
+bool EventNotification::post(uint64_t value) const {
+    if (!file_.ok() || value == 0) {
+        return false;
+    }
+    ssize_t n = file_.write(reinterpret_cast<const uint8_t *>(&value), sizeof(value));
+    return n == static_cast<ssize_t>(sizeof(value));
+}
+
+bool EventNotification::wait(const rix::util::Duration &d) const {
+    uint64_t value = 0;
+    return wait(d, value);
+}
+
+bool EventNotification::wait(const rix::util::Duration &d, uint64_t &value) const {
+    if (!file_.ok()) {
+        return false;
+    }
+
+    if (!file_.wait_for_readable(d)) {
+        return false;
+    }
+
+    // Another waiter may have consumed the counter between poll and read, in
+    // which case read fails with EAGAIN
+    value = 0;
+    ssize_t n = file_.read(reinterpret_cast<uint8_t *>(&value), sizeof(value));
+    return n == static_cast<ssize_t>(sizeof(value));
+}
+
+int EventNotification::fd() const { return file_.fd(); }
+
+bool EventNotification::ok() const { return file_.ok(); }
+
+EventNotification::Mode EventNotification::mode() const { return mode_; }
+
+}  // namespace ipc
+}  // namespace rix
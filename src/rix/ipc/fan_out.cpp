@@ -0,0 +1,273 @@
+#include "rix/ipc/fan_out.hpp"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+
+namespace rix {
+namespace ipc {
+
+FanOut::FanOut(size_t buffer_limit)
+    : buffer_limit_(buffer_limit), sinks_(), stage_(), null_("/dev/null", O_WRONLY | O_CLOEXEC), scratch_() {}
+
+FanOut::~FanOut() {}
+
+bool FanOut::add(std::shared_ptr<interfaces::IO> sink, Policy policy) {
+    if (sink == nullptr) {
+        errno = EINVAL;
+        return false;
+    }
+    sink->set_nonblocking(true);
+
+    int pipe_fd = -1;
+    const File *file = dynamic_cast<const File *>(sink.get());
+    struct stat st;
+    if (file != nullptr && file->ok() && ::fstat(file->fd(), &st) == 0 && S_ISFIFO(st.st_mode)) {
+        pipe_fd = file->fd();
+        if (!stage_[0].ok()) {
+            stage_ = Pipe::create();
+            stage_[0].set_nonblocking(true);
+            stage_[1].set_nonblocking(true);
+        }
+    }
+    sinks_.push_back({std::move(sink), policy, pipe_fd, {}, 0, 0, true});
+    return true;
+}
+
+ssize_t FanOut::read(uint8_t *, size_t) const {
+    errno = EBADF;
+    return -1;
+}
+
+ssize_t FanOut::readv(const struct iovec *, int) const {
+    errno = EBADF;
+    return -1;
+}
+
+bool FanOut::drain(Sink &sink) const {
+    while (sink.pending_offset < sink.pending.size()) {
+        ssize_t w = sink.io->write(sink.pending.data() + sink.pending_offset, sink.pending.size() - sink.pending_offset);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                sink.enabled = false;
+                sink.pending.clear();
+                sink.pending_offset = 0;
+            }
+            return false;
+        }
+        if (w == 0) {
+            // No progress; keep the data pending as if the sink were full
+            return false;
+        }
+        sink.pending_offset += static_cast<size_t>(w);
+    }
+    sink.pending.clear();
+    sink.pending_offset = 0;
+    return true;
+}
+
+void FanOut::defer(Sink &sink, const uint8_t *src, size_t size) const {
+    const size_t buffered = sink.pending.size() - sink.pending_offset;
+    if (sink.policy == Policy::BUFFER && buffered + size <= buffer_limit_) {
+        sink.pending.insert(sink.pending.end(), src, src + size);
+    } else {
+        sink.dropped++;
+    }
+}
+
+bool FanOut::reset_stage() const {
+    stage_ = Pipe::create();
+    if (!stage_[0].ok()) {
+        return false;
+    }
+    stage_[0].set_nonblocking(true);
+    stage_[1].set_nonblocking(true);
+    return true;
+}
+
+bool FanOut::stage(const uint8_t *src, size_t size) const {
+    if (!stage_[1].ok()) {
+        return false;
+    }
+    // `tee` copies everything in the pipe, so leftovers of an earlier frame
+    // would be sent to every pipe sink ahead of this one
+    int queued = 0;
+    if ((::ioctl(stage_[0].fd(), FIONREAD, &queued) != 0 || queued != 0) && !reset_stage()) {
+        return false;
+    }
+    // A frame that does not fit in the internal pipe is written directly
+    const ssize_t capacity = stage_[0].capacity();
+    if (capacity < 0 || size > static_cast<size_t>(capacity)) {
+        return false;
+    }
+    ssize_t w;
+    do {
+        w = stage_[1].write(src, size);
+    } while (w < 0 && errno == EINTR);
+    if (w != static_cast<ssize_t>(size)) {
+        if (w > 0) {
+            reset_stage();
+        }
+        return false;
+    }
+    return true;
+}
+
+void FanOut::unstage(size_t size) const {
+    // Discard the staged frame without copying it to user space if possible
+    while (size > 0) {
+        ssize_t n = null_.ok() ? stage_[0].splice_to(null_, size) : -1;
+        if (n <= 0) {
+            scratch_.resize(size);
+            n = stage_[0].read(scratch_.data(), size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                // The pipe can not be emptied, so replace it
+                reset_stage();
+                return;
+            }
+        }
+        size -= static_cast<size_t>(n);
+    }
+}
+
+ssize_t FanOut::write(const uint8_t *src, size_t size) const {
+    bool any_enabled = false;
+    bool staged = false;
+    bool tried_stage = false;
+
+    // Staging only pays off when the frame is large and goes to several pipes
+    size_t pipe_sinks = 0;
+    if (size >= TEE_MIN_SIZE) {
+        for (const auto &sink : sinks_) {
+            if (sink.enabled && sink.pipe_fd >= 0) {
+                pipe_sinks++;
+            }
+        }
+    }
+    const bool use_tee = pipe_sinks >= 2;
+
+    for (auto &sink : sinks_) {
+        if (!sink.enabled) {
+            continue;
+        }
+        // Older data must go first; a sink that is still behind takes the
+        // frame according to its policy
+        if (!drain(sink)) {
+            if (sink.enabled) {
+                any_enabled = true;
+                defer(sink, src, size);
+            }
+            continue;
+        }
+        any_enabled = true;
+        if (size == 0) {
+            continue;
+        }
+
+        ssize_t w;
+        if (use_tee && sink.pipe_fd >= 0) {
+            if (!tried_stage) {
+                staged = stage(src, size);
+                tried_stage = true;
+            }
+            if (staged) {
+                do {
+                    w = ::tee(stage_[0].fd(), sink.pipe_fd, size, SPLICE_F_NONBLOCK);
+                } while (w < 0 && errno == EINTR);
+            } else {
+                do {
+                    w = sink.io->write(src, size);
+                } while (w < 0 && errno == EINTR);
+            }
+        } else {
+            do {
+                w = sink.io->write(src, size);
+            } while (w < 0 && errno == EINTR);
+        }
+
+        if (w < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                defer(sink, src, size);
+            } else {
+                sink.enabled = false;
+            }
+            continue;
+        }
+        if (static_cast<size_t>(w) < size) {
+            // Keep the rest of a partially written frame regardless of the
+            // policy so the sink's stream stays framed
+            sink.pending.assign(src + w, src + size);
+            sink.pending_offset = 0;
+        }
+    }
+
+    if (staged) {
+        unstage(size);
+    }
+    if (!any_enabled) {
+        errno = EPIPE;
+        return -1;
+    }
+    return static_cast<ssize_t>(size);
+}
+
+ssize_t FanOut::writev(const struct iovec *iov, int iovcnt) const {
+    if (iovcnt == 1) {
+        return write(static_cast<const uint8_t *>(iov[0].iov_base), iov[0].iov_len);
+    }
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    std::vector<uint8_t> frame;
+    frame.reserve(total);
+    for (int i = 0; i < iovcnt; i++) {
+        const uint8_t *base = static_cast<const uint8_t *>(iov[i].iov_base);
+        frame.insert(frame.end(), base, base + iov[i].iov_len);
+    }
+    return write(frame.data(), frame.size());
+}
+
+bool FanOut::wait_for_readable(const util::Duration &) const { return false; }
+
+bool FanOut::wait_for_writable(const util::Duration &) const {
+    for (const auto &sink : sinks_) {
+        if (sink.enabled) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FanOut::set_nonblocking(bool) {}
+
+bool FanOut::is_nonblocking() const { return true; }
+
+bool FanOut::flush() const {
+    bool empty = true;
+    for (auto &sink : sinks_) {
+        if (sink.enabled && !drain(sink)) {
+            empty = empty && sink.pending.empty();
+        }
+    }
+    return empty;
+}
+
+size_t FanOut::size() const { return sinks_.size(); }
+
+size_t FanOut::dropped(size_t index) const { return index < sinks_.size() ? sinks_[index].dropped : 0; }
+
+size_t FanOut::buffered(size_t index) const {
+    return index < sinks_.size() ? sinks_[index].pending.size() - sinks_[index].pending_offset : 0;
+}
+
+bool FanOut::enabled(size_t index) const { return index < sinks_.size() && sinks_[index].enabled; }
+
+}  // namespace ipc
+}  // namespace rix
@@ -27,6 +27,8 @@ Fifo::Fifo(const std::string &pathname, Mode mode, bool nonblocking)
 
 Fifo::Fifo() {}
 
+Fifo::Fifo(int fd, const std::string &pathname, Mode mode) : File(fd), mode_(mode), pathname_(pathname) {}
+
 /**< TODO */
 Fifo::Fifo(const Fifo &other) 
     : File(), mode_(other.mode_), pathname_(other.pathname_) {
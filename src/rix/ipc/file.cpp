@@ -82,6 +82,20 @@ ssize_t File::write(const uint8_t *buffer, size_t size) const {
     return ::write(fd_, buffer, size);
 }
 
+ssize_t File::readv(const struct iovec *iov, int iovcnt) const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    return ::readv(fd_, iov, iovcnt);
+}
+
+ssize_t File::writev(const struct iovec *iov, int iovcnt) const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    return ::writev(fd_, iov, iovcnt);
+}
+
 int File::fd() const { return fd_; }
 
 /**< TODO */
@@ -125,66 +139,38 @@ bool File::is_nonblocking() const {
 
 /**< TODO */
 bool File::wait_for_writable(const util::Duration &duration) const {
-    if (fd_ < 0) {
-        return false;
-    }
-
-    int timeout_ms = 0;
-    auto ns = duration.to_nanoseconds();
-    if (ns < 0) {
-        timeout_ms = 0;
-    } else {
-        // poll() takes milliseconds 
-        // -> so rounding up avoids timing out "too early" for small non-zero durations
-        int64_t ms = duration.to_milliseconds(util::Time::RoundType::CEIL);
-        if (ms > static_cast<int64_t>(std::numeric_limits<int>::max())) {
-            timeout_ms = std::numeric_limits<int>::max();
-        } else {
-            timeout_ms = static_cast<int>(ms);
-        }
-    }
-
-    struct pollfd pfd;
-    pfd.fd = fd_;
-    pfd.events = POLLOUT;
-    pfd.revents = 0;
-
-    int ret = ::poll(&pfd, 1, timeout_ms);
-    if (ret <= 0) {
-        return false;
-    }
-    return (pfd.revents & POLLOUT) != 0;
+    return wait_for(POLLOUT, duration);
 }
 
 /**< TODO */
 bool File::wait_for_readable(const util::Duration &duration) const {
+    return wait_for(POLLIN, duration);
+}
+
+bool File::wait_for(short events, const util::Duration &duration) const {
     if (fd_ < 0) {
         return false;
     }
 
-    int timeout_ms = 0;
+    // ppoll() takes a timespec, so sub-millisecond timeouts are not rounded
+    // up to a full millisecond like they would be with poll()
+    struct timespec timeout = {0, 0};
     auto ns = duration.to_nanoseconds();
-    if (ns < 0) {
-        timeout_ms = 0;
-    } else {
-        int64_t ms = duration.to_milliseconds(util::Time::RoundType::CEIL);
-        if (ms > static_cast<int64_t>(std::numeric_limits<int>::max())) {
-            timeout_ms = std::numeric_limits<int>::max();
-        } else {
-            timeout_ms = static_cast<int>(ms);
-        }
+    if (ns > 0) {
+        timeout.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+        timeout.tv_nsec = static_cast<long>(ns % 1'000'000'000);
     }
 
     struct pollfd pfd;
     pfd.fd = fd_;
-    pfd.events = POLLIN;
+    pfd.events = events;
     pfd.revents = 0;
 
-    int ret = ::poll(&pfd, 1, timeout_ms);
+    int ret = ::ppoll(&pfd, 1, &timeout, nullptr);
     if (ret <= 0) {
         return false;
     }
-    return (pfd.revents & POLLIN) != 0;
+    return (pfd.revents & events) != 0;
 }
 
 }  // namespace ipc
@@ -0,0 +1,228 @@
+#include "rix/ipc/framed_fifo.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace rix {
+namespace ipc {
+
+namespace {
+
+constexpr size_t READ_SIZE = 64 * 1024;
+
+struct ChunkHeader {
+    uint32_t producer;
+    uint32_t size;
+    uint16_t length;
+    uint16_t flags;
+};
+
+static_assert(sizeof(ChunkHeader) == FramedFifo::HEADER_SIZE, "Unexpected chunk header padding");
+
+}  // namespace
+
+FramedFifo::FramedFifo()
+    : Fifo(), producer_id_(0), chunking_(true), rx_(), rx_offset_(0), partial_(), malformed_(0) {}
+
+FramedFifo::FramedFifo(const std::string &pathname, Mode mode, uint32_t producer_id, bool nonblocking,
+                       bool chunking)
+    : Fifo(pathname, mode, nonblocking),
+      producer_id_(producer_id),
+      chunking_(chunking),
+      rx_(),
+      rx_offset_(0),
+      partial_(),
+      malformed_(0) {}
+
+FramedFifo::FramedFifo(int fd, const std::string &pathname, uint32_t producer_id)
+    : Fifo(fd, pathname, Mode::WRITE),
+      producer_id_(producer_id),
+      chunking_(true),
+      rx_(),
+      rx_offset_(0),
+      partial_(),
+      malformed_(0) {}
+
+FramedFifo FramedFifo::open_existing(const std::string &pathname, uint32_t producer_id) {
+    // Open for reading as well, like Fifo, so that writes never raise SIGPIPE
+    // if the reader goes away
+    const int fd = ::open(pathname.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) {
+        return FramedFifo();
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISFIFO(st.st_mode)) {
+        ::close(fd);
+        errno = ENXIO;
+        return FramedFifo();
+    }
+    return FramedFifo(fd, pathname, producer_id);
+}
+
+ssize_t FramedFifo::write_frame(const uint8_t *src, size_t size, const util::Duration &timeout) const {
+    if (fd_ < 0) {
+        errno = EBADF;
+        return -1;
+    }
+    if (size > UINT32_MAX || (!chunking_ && size > MAX_CHUNK_SIZE)) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    uint8_t chunk[PIPE_BUF];
+    size_t sent = 0;
+    do {
+        const size_t length = std::min(size - sent, MAX_CHUNK_SIZE);
+        ChunkHeader header;
+        header.producer = producer_id_;
+        header.size = static_cast<uint32_t>(size);
+        header.length = static_cast<uint16_t>(length);
+        header.flags = static_cast<uint16_t>((sent == 0 ? FIRST : 0) | (sent + length < size ? MORE : 0));
+        std::memcpy(chunk, &header, HEADER_SIZE);
+        if (length > 0) {
+            std::memcpy(chunk + HEADER_SIZE, src + sent, length);
+        }
+
+        // Writes of at most PIPE_BUF bytes are all-or-nothing, so a chunk is
+        // never torn or interleaved with another producer's chunk
+        const ssize_t n = static_cast<ssize_t>(HEADER_SIZE + length);
+        while (true) {
+            ssize_t w = write(chunk, n);
+            if (w == n) {
+                break;
+            }
+            if (w < 0 && errno == EINTR) {
+                continue;
+            }
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && sent > 0) {
+                // The frame has been started, so it is finished unless the
+                // reader does not make room in time. The reader discards the
+                // partial frame when the next frame from this producer starts
+                if (wait_for_writable(timeout)) {
+                    continue;
+                }
+                errno = EAGAIN;
+            }
+            return -1;
+        }
+        sent += length;
+    } while (sent < size);
+
+    return static_cast<ssize_t>(size);
+}
+
+int FramedFifo::next_chunk(Frame &frame, bool &complete) {
+    complete = false;
+    const size_t available = rx_.size() - rx_offset_;
+    if (available < HEADER_SIZE) {
+        return 0;
+    }
+    ChunkHeader header;
+    std::memcpy(&header, rx_.data() + rx_offset_, HEADER_SIZE);
+    if (header.length > MAX_CHUNK_SIZE) {
+        // Chunks are written atomically, so this stream can not be realigned
+        rx_.clear();
+        rx_offset_ = 0;
+        partial_.clear();
+        errno = EPROTO;
+        return -1;
+    }
+    if (available < HEADER_SIZE + header.length) {
+        return 0;
+    }
+
+    // From here on the chunk is consumed and the stream stays aligned, so a
+    // chunk that does not fit the producer's frame is dropped (with the frame)
+    // instead of failing the reads of every other producer
+    const uint8_t *payload = rx_.data() + rx_offset_ + HEADER_SIZE;
+    rx_offset_ += HEADER_SIZE + header.length;
+
+    if (header.flags & FIRST) {
+        // A new frame replaces the partial frame of a producer that died in
+        // the middle of writing it (and whose id has been reused)
+        partial_.erase(header.producer);
+        if (!(header.flags & MORE)) {
+            // Single-chunk frame: no reassembly needed
+            if (header.length != header.size) {
+                malformed_++;
+                return 1;
+            }
+            frame.producer = header.producer;
+            frame.data.assign(payload, payload + header.length);
+            complete = true;
+            return 1;
+        }
+        partial_[header.producer].assign(payload, payload + header.length);
+        return 1;
+    }
+
+    auto it = partial_.find(header.producer);
+    if (it == partial_.end()) {
+        // A continuation of a frame whose first chunk was never seen
+        malformed_++;
+        return 1;
+    }
+    std::vector<uint8_t> &data = it->second;
+    data.insert(data.end(), payload, payload + header.length);
+    if (data.size() > header.size) {
+        partial_.erase(header.producer);
+        malformed_++;
+        return 1;
+    }
+    if (!(header.flags & MORE)) {
+        if (data.size() != header.size) {
+            partial_.erase(header.producer);
+            malformed_++;
+            return 1;
+        }
+        frame.producer = header.producer;
+        frame.data = std::move(data);
+        partial_.erase(header.producer);
+        complete = true;
+    }
+    return 1;
+}
+
+bool FramedFifo::read_frame(Frame &frame) {
+    if (fd_ < 0) {
+        errno = EBADF;
+        return false;
+    }
+
+    while (true) {
+        bool complete = false;
+        int ret;
+        while ((ret = next_chunk(frame, complete)) > 0) {
+            if (complete) {
+                return true;
+            }
+        }
+        if (ret < 0) {
+            return false;
+        }
+
+        // Keep the unparsed tail at the start of the buffer and read more
+        if (rx_offset_ > 0) {
+            rx_.erase(rx_.begin(), rx_.begin() + rx_offset_);
+            rx_offset_ = 0;
+        }
+        const size_t old_size = rx_.size();
+        rx_.resize(old_size + READ_SIZE);
+        ssize_t n = read(rx_.data() + old_size, READ_SIZE);
+        rx_.resize(old_size + std::max<ssize_t>(n, 0));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+    }
+}
+
+uint32_t FramedFifo::producer_id() const { return producer_id_; }
+
+uint64_t FramedFifo::malformed() const { return malformed_; }
+
+}  // namespace ipc
+}  // namespace rix
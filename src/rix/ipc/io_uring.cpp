@@ -0,0 +1,372 @@
+#include "rix/ipc/io_uring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace rix {
+namespace ipc {
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int sys_io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T *ring_ptr(void *base, uint32_t offset) {
+    return reinterpret_cast<T *>(static_cast<uint8_t *>(base) + offset);
+}
+
+}  // namespace
+
+IOUring::IOUring(unsigned entries)
+    : ring_(),
+      sq_ring_(MAP_FAILED),
+      sq_ring_size_(0),
+      cq_ring_(MAP_FAILED),
+      cq_ring_size_(0),
+      sqes_(static_cast<struct io_uring_sqe *>(MAP_FAILED)),
+      sqes_size_(0),
+      sq_head_(nullptr),
+      sq_tail_(nullptr),
+      sq_mask_(nullptr),
+      sq_array_(nullptr),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(nullptr),
+      cqes_(nullptr),
+      sq_entries_(0),
+      sqe_tail_(0),
+      sqe_head_(0),
+      files_registered_(false),
+      buffers_registered_(false) {
+    if (entries == 0) {
+        return;
+    }
+
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0) {
+        return;
+    }
+    ring_ = File(fd);
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // With IORING_FEAT_SINGLE_MMAP both rings live in one mapping
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = sq_ring_size_;
+    }
+
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        release();
+        return;
+    }
+
+    if (single_mmap) {
+        cq_ring_ = sq_ring_;
+    } else {
+        cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                          IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            release();
+            return;
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        release();
+        return;
+    }
+    sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+    sq_head_ = ring_ptr<unsigned>(sq_ring_, params.sq_off.head);
+    sq_tail_ = ring_ptr<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = ring_ptr<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = ring_ptr<unsigned>(sq_ring_, params.sq_off.array);
+    cq_head_ = ring_ptr<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = ring_ptr<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = ring_ptr<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = ring_ptr<struct io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+    sq_entries_ = params.sq_entries;
+    sqe_tail_ = *sq_tail_;
+    sqe_head_ = sqe_tail_;
+}
+
+IOUring::IOUring(IOUring &&other) : IOUring(0) { *this = std::move(other); }
+
+IOUring &IOUring::operator=(IOUring &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    release();
+
+    ring_ = std::move(other.ring_);
+    sq_ring_ = other.sq_ring_;
+    sq_ring_size_ = other.sq_ring_size_;
+    cq_ring_ = other.cq_ring_;
+    cq_ring_size_ = other.cq_ring_size_;
+    sqes_ = other.sqes_;
+    sqes_size_ = other.sqes_size_;
+    sq_head_ = other.sq_head_;
+    sq_tail_ = other.sq_tail_;
+    sq_mask_ = other.sq_mask_;
+    sq_array_ = other.sq_array_;
+    cq_head_ = other.cq_head_;
+    cq_tail_ = other.cq_tail_;
+    cq_mask_ = other.cq_mask_;
+    cqes_ = other.cqes_;
+    sq_entries_ = other.sq_entries_;
+    sqe_tail_ = other.sqe_tail_;
+    sqe_head_ = other.sqe_head_;
+    files_registered_ = other.files_registered_;
+    buffers_registered_ = other.buffers_registered_;
+
+    // The source no longer owns the mappings
+    other.sq_ring_ = MAP_FAILED;
+    other.cq_ring_ = MAP_FAILED;
+    other.sqes_ = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+    other.release();
+    return *this;
+}
+
+IOUring::~IOUring() { release(); }
+
+void IOUring::release() {
+    if (sqes_ != MAP_FAILED) {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+        ::munmap(sq_ring_, sq_ring_size_);
+    }
+    sq_ring_ = MAP_FAILED;
+    cq_ring_ = MAP_FAILED;
+    sqes_ = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+    sq_head_ = sq_tail_ = sq_mask_ = sq_array_ = nullptr;
+    cq_head_ = cq_tail_ = cq_mask_ = nullptr;
+    cqes_ = nullptr;
+    sq_entries_ = 0;
+    sqe_tail_ = sqe_head_ = 0;
+    files_registered_ = false;
+    buffers_registered_ = false;
+    ring_ = File();
+}
+
+bool IOUring::ok() const { return ring_.ok() && sqes_ != MAP_FAILED; }
+
+int IOUring::fd() const { return ring_.fd(); }
+
+bool IOUring::register_files(const std::vector<const File *> &files) {
+    if (!ok() || files_registered_ || files.empty()) {
+        return false;
+    }
+    std::vector<int> fds;
+    fds.reserve(files.size());
+    for (const File *f : files) {
+        fds.push_back(f != nullptr ? f->fd() : -1);
+    }
+    if (sys_io_uring_register(ring_.fd(), IORING_REGISTER_FILES, fds.data(), fds.size()) < 0) {
+        return false;
+    }
+    files_registered_ = true;
+    return true;
+}
+
+bool IOUring::unregister_files() {
+    if (!ok() || !files_registered_) {
+        return false;
+    }
+    if (sys_io_uring_register(ring_.fd(), IORING_UNREGISTER_FILES, nullptr, 0) < 0) {
+        return false;
+    }
+    files_registered_ = false;
+    return true;
+}
+
+bool IOUring::register_buffers(const std::vector<struct iovec> &buffers) {
+    if (!ok() || buffers_registered_ || buffers.empty()) {
+        return false;
+    }
+    if (sys_io_uring_register(ring_.fd(), IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) < 0) {
+        return false;
+    }
+    buffers_registered_ = true;
+    return true;
+}
+
+bool IOUring::unregister_buffers() {
+    if (!ok() || !buffers_registered_) {
+        return false;
+    }
+    if (sys_io_uring_register(ring_.fd(), IORING_UNREGISTER_BUFFERS, nullptr, 0) < 0) {
+        return false;
+    }
+    buffers_registered_ = false;
+    return true;
+}
+
+struct io_uring_sqe *IOUring::next_sqe() {
+    if (!ok()) {
+        return nullptr;
+    }
+    const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_) {
+        return nullptr;  // Submission queue is full
+    }
+    const unsigned index = sqe_tail_ & *sq_mask_;
+    struct io_uring_sqe *sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    sqe_tail_++;
+    return sqe;
+}
+
+bool IOUring::prepare_rw(uint8_t opcode, int fd, uint64_t addr, size_t size, uint64_t user_data, int64_t offset,
+                         uint8_t sqe_flags, int buffer_index) {
+    if (fd < 0 || size > UINT32_MAX) {
+        return false;
+    }
+    struct io_uring_sqe *sqe = next_sqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    sqe->opcode = opcode;
+    sqe->flags = sqe_flags;
+    sqe->fd = fd;
+    sqe->addr = addr;
+    sqe->len = static_cast<uint32_t>(size);
+    // An offset of -1 means "use the current file position", which is required
+    // for non-seekable files such as pipes
+    sqe->off = static_cast<uint64_t>(offset);
+    sqe->user_data = user_data;
+    if (buffer_index >= 0) {
+        sqe->buf_index = static_cast<uint16_t>(buffer_index);
+    }
+    return true;
+}
+
+bool IOUring::prepare_read(const File &file, uint8_t *dst, size_t size, uint64_t user_data, int64_t offset) {
+    return prepare_rw(IORING_OP_READ, file.fd(), reinterpret_cast<uint64_t>(dst), size, user_data, offset, 0, -1);
+}
+
+bool IOUring::prepare_write(const File &file, const uint8_t *src, size_t size, uint64_t user_data,
+                            int64_t offset) {
+    return prepare_rw(IORING_OP_WRITE, file.fd(), reinterpret_cast<uint64_t>(src), size, user_data, offset, 0,
+                      -1);
+}
+
+bool IOUring::prepare_read_fixed(unsigned file_index, uint8_t *dst, size_t size, int buffer_index,
+                                 uint64_t user_data, int64_t offset) {
+    if (!files_registered_ || (buffer_index >= 0 && !buffers_registered_)) {
+        return false;
+    }
+    const uint8_t opcode = buffer_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    return prepare_rw(opcode, static_cast<int>(file_index), reinterpret_cast<uint64_t>(dst), size, user_data,
+                      offset, IOSQE_FIXED_FILE, buffer_index);
+}
+
+bool IOUring::prepare_write_fixed(unsigned file_index, const uint8_t *src, size_t size, int buffer_index,
+                                  uint64_t user_data, int64_t offset) {
+    if (!files_registered_ || (buffer_index >= 0 && !buffers_registered_)) {
+        return false;
+    }
+    const uint8_t opcode = buffer_index >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    return prepare_rw(opcode, static_cast<int>(file_index), reinterpret_cast<uint64_t>(src), size, user_data,
+                      offset, IOSQE_FIXED_FILE, buffer_index);
+}
+
+unsigned IOUring::pending() const { return sqe_tail_ - sqe_head_; }
+
+int IOUring::submit(unsigned wait_nr) {
+    if (!ok()) {
+        return -1;
+    }
+    const unsigned to_submit = pending();
+    if (to_submit == 0 && wait_nr == 0) {
+        return 0;
+    }
+
+    // Publish the prepared SQEs before telling the kernel about them
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+
+    const unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    do {
+        ret = sys_io_uring_enter(ring_.fd(), to_submit, wait_nr, flags);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        return -1;
+    }
+    sqe_head_ += static_cast<unsigned>(ret);
+    return ret;
+}
+
+bool IOUring::pop_completion(Completion &completion) {
+    const unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    const struct io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+    completion.user_data = cqe.user_data;
+    completion.result = cqe.res;
+    completion.flags = cqe.flags;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+size_t IOUring::peek(std::vector<Completion> &out, size_t max) {
+    if (!ok()) {
+        return 0;
+    }
+    size_t count = 0;
+    Completion completion;
+    while (count < max && pop_completion(completion)) {
+        out.push_back(completion);
+        count++;
+    }
+    return count;
+}
+
+bool IOUring::wait(Completion &completion, const rix::util::Duration &duration) {
+    if (!ok()) {
+        return false;
+    }
+    if (pending() > 0 && submit() < 0) {
+        return false;
+    }
+    if (pop_completion(completion)) {
+        return true;
+    }
+    // The io_uring descriptor polls readable while the completion queue is
+    // not empty
+    if (!ring_.wait_for_readable(duration)) {
+        return false;
+    }
+    return pop_completion(completion);
+}
+
+}  // namespace ipc
+}  // namespace rix
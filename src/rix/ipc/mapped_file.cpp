@@ -0,0 +1,224 @@
+#include "rix/ipc/mapped_file.hpp"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+
+namespace rix {
+namespace ipc {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+size_t page_size() { return static_cast<size_t>(::sysconf(_SC_PAGESIZE)); }
+
+bool file_size(int fd, size_t &size) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+// Maps `size` bytes of `fd` at an address that is a multiple of the huge page
+// size by over-reserving address space and trimming the unaligned ends
+void *map_aligned(size_t size, int prot, int fd) {
+    const size_t reserved = size + HUGE_PAGE_SIZE;
+    void *base = ::mmap(nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    void *addr = ::mmap(reinterpret_cast<void *>(aligned), size, prot, MAP_SHARED | MAP_FIXED, fd, 0);
+    if (addr == MAP_FAILED) {
+        ::munmap(base, reserved);
+        return MAP_FAILED;
+    }
+
+    const size_t end = aligned + ((size + page_size() - 1) & ~(page_size() - 1));
+    if (aligned > start) {
+        ::munmap(base, aligned - start);
+    }
+    if (start + reserved > end) {
+        ::munmap(reinterpret_cast<void *>(end), start + reserved - end);
+    }
+    return addr;
+}
+
+}  // namespace
+
+MappedFile::MappedFile() : file_(), mode_(Mode::READ), huge_pages_(false), data_(nullptr), size_(0) {}
+
+MappedFile::MappedFile(const std::string &pathname, Mode mode, size_t size, bool huge_pages) : MappedFile() {
+    mode_ = mode;
+    huge_pages_ = huge_pages;
+    if (mode == Mode::READ) {
+        file_ = File(pathname, O_RDONLY | O_CLOEXEC);
+    } else {
+        file_ = File(pathname, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    }
+    if (!file_.ok()) {
+        return;
+    }
+
+    size_t current = 0;
+    if (!file_size(file_.fd(), current)) {
+        file_ = File();
+        return;
+    }
+    if (mode == Mode::READ_WRITE && current < size) {
+        if (::ftruncate(file_.fd(), static_cast<off_t>(size)) != 0) {
+            file_ = File();
+            return;
+        }
+        current = size;
+    }
+    if (!map(current)) {
+        file_ = File();
+    }
+}
+
+MappedFile::MappedFile(MappedFile &&other) : MappedFile() { *this = std::move(other); }
+
+MappedFile &MappedFile::operator=(MappedFile &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    unmap();
+    file_ = std::move(other.file_);
+    mode_ = other.mode_;
+    huge_pages_ = other.huge_pages_;
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    return *this;
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+int MappedFile::protection() const { return mode_ == Mode::READ ? PROT_READ : PROT_READ | PROT_WRITE; }
+
+bool MappedFile::map(size_t size) {
+    // A zero-length mapping is not allowed, but an empty file is still valid
+    if (size == 0) {
+        return true;
+    }
+
+    void *addr;
+    if (huge_pages_) {
+        addr = map_aligned(size, protection(), file_.fd());
+    } else {
+        addr = ::mmap(nullptr, size, protection(), MAP_SHARED, file_.fd(), 0);
+    }
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<uint8_t *>(addr);
+    size_ = size;
+    if (huge_pages_) {
+        // Best effort: fails with EINVAL if transparent huge pages are
+        // unavailable for this mapping
+        ::madvise(data_, size_, MADV_HUGEPAGE);
+    }
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    file_ = File();
+}
+
+std::span<const uint8_t> MappedFile::data() const { return {data_, size_}; }
+
+std::span<uint8_t> MappedFile::writable_data() {
+    if (mode_ != Mode::READ_WRITE) {
+        return {};
+    }
+    return {data_, size_};
+}
+
+size_t MappedFile::size() const { return size_; }
+
+bool MappedFile::resize(size_t size) {
+    if (!file_.ok() || mode_ != Mode::READ_WRITE) {
+        errno = EBADF;
+        return false;
+    }
+    if (::ftruncate(file_.fd(), static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+    return remap();
+}
+
+bool MappedFile::remap() {
+    if (!file_.ok()) {
+        errno = EBADF;
+        return false;
+    }
+    size_t size = 0;
+    if (!file_size(file_.fd(), size)) {
+        return false;
+    }
+    if (size == size_) {
+        return true;
+    }
+
+    if (data_ == nullptr || size == 0) {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+        return map(size);
+    }
+
+    // Let the kernel grow the mapping in place, or move it if the adjacent
+    // address space is taken
+    void *addr = ::mremap(data_, size_, size, MREMAP_MAYMOVE);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<uint8_t *>(addr);
+    size_ = size;
+    if (huge_pages_) {
+        ::madvise(data_, size_, MADV_HUGEPAGE);
+    }
+    return true;
+}
+
+bool MappedFile::advise(Advice advice, size_t offset, size_t length) const {
+    if (data_ == nullptr || offset >= size_) {
+        errno = EINVAL;
+        return false;
+    }
+    // madvise requires a page-aligned start address
+    const size_t aligned = offset & ~(page_size() - 1);
+    if (length == 0 || offset + length > size_) {
+        length = size_ - offset;
+    }
+    return ::madvise(data_ + aligned, length + (offset - aligned), static_cast<int>(advice)) == 0;
+}
+
+bool MappedFile::sync(bool blocking) const {
+    if (data_ == nullptr) {
+        return file_.ok();
+    }
+    return ::msync(data_, size_, blocking ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+bool MappedFile::ok() const { return file_.ok(); }
+
+MappedFile::Mode MappedFile::mode() const { return mode_; }
+
+int MappedFile::fd() const { return file_.fd(); }
+
+}  // namespace ipc
+}  // namespace rix
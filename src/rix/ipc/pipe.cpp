@@ -1,10 +1,35 @@
 #include "rix/ipc/pipe.hpp"
 
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <limits>
+
 namespace rix {
 namespace ipc {
 
+namespace {
+
+// How long staged bytes wait for a non-blocking dst to become writable
+const util::Duration STAGE_TIMEOUT(1.0);
+
+bool is_pipe(const File &file) {
+    struct stat st;
+    return ::fstat(file.fd(), &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+unsigned int splice_flags(const File &file) {
+    unsigned int flags = SPLICE_F_MOVE;
+    if (file.is_nonblocking()) {
+        flags |= SPLICE_F_NONBLOCK;
+    }
+    return flags;
+}
+
+}  // namespace
+
 /**< TODO */
-std::array<Pipe, 2> Pipe::create() {
+std::array<Pipe, 2> Pipe::create(size_t capacity) {
     int fds[2] = {-1, -1};
     if (::pipe(fds) != 0) {
         // can't to create; return invalid pipes
@@ -12,7 +37,84 @@ std::array<Pipe, 2> Pipe::create() {
     }
 
     // fds[0] = read end, fds[1] = write end
-    return {Pipe(fds[0], true), Pipe(fds[1], false)};
+    std::array<Pipe, 2> pipe = {Pipe(fds[0], true), Pipe(fds[1], false)};
+    if (capacity > 0) {
+        // Capacity is a property of the pipe, not of one end
+        pipe[1].set_capacity(capacity);
+    }
+    return pipe;
+}
+
+ssize_t Pipe::transfer(const File &src, const File &dst, size_t size) {
+    if (!src.ok() || !dst.ok()) {
+        return -1;
+    }
+    struct stat src_st;
+    if (::fstat(src.fd(), &src_st) != 0) {
+        return -1;
+    }
+    if (S_ISFIFO(src_st.st_mode) || is_pipe(dst)) {
+        ssize_t n;
+        do {
+            n = ::splice(src.fd(), nullptr, dst.fd(), nullptr, size, SPLICE_F_MOVE);
+        } while (n < 0 && errno == EINTR);
+        return n;
+    }
+
+    // splice needs a pipe on one side, so stage the bytes in a kernel buffer.
+    // The staging pipe is kept across calls, and is only ever left empty.
+    thread_local std::array<Pipe, 2> stage;
+    if (!stage[0].ok()) {
+        stage = Pipe::create();
+        if (!stage[0].ok()) {
+            return -1;
+        }
+    }
+    auto &[reader, writer] = stage;
+    // Like read(2), return what is available rather than waiting for `size`
+    // bytes, except from a regular file, which never blocks
+    const bool regular = S_ISREG(src_st.st_mode);
+    size_t moved = 0;
+    while (moved < size) {
+        ssize_t in = writer.splice_from(src, size - moved);
+        if (in < 0 && errno == EINTR) {
+            continue;
+        }
+        if (in < 0 && moved == 0) {
+            return -1;
+        }
+        if (in <= 0) {
+            // End of src, or a failure (errno is left set) after a short
+            // transfer
+            break;
+        }
+        // The staged bytes have already been consumed from src, so they must
+        // all reach dst: wait out EAGAIN on a non-blocking dst for a while,
+        // and report any failure as an error rather than a short transfer
+        size_t staged = static_cast<size_t>(in);
+        while (staged > 0) {
+            ssize_t out = reader.splice_to(dst, staged);
+            if (out < 0 && errno == EINTR) {
+                continue;
+            }
+            if (out < 0 && errno == EAGAIN && dst.wait_for_writable(STAGE_TIMEOUT)) {
+                continue;
+            }
+            if (out <= 0) {
+                // Replace the staging pipe so its bytes are not sent later
+                const int error = (out == 0) ? EIO : errno;
+                stage = {Pipe(), Pipe()};
+                errno = error;
+                return -1;
+            }
+            staged -= static_cast<size_t>(out);
+            moved += static_cast<size_t>(out);
+        }
+        if (!regular) {
+            break;
+        }
+    }
+    return static_cast<ssize_t>(moved);
 }
 
 Pipe::Pipe() : File(), read_end_(false) {}
@@ -68,6 +170,55 @@ bool Pipe::is_read_end() const { return read_end_; }
 
 bool Pipe::is_write_end() const { return !read_end_; }
 
+ssize_t Pipe::capacity() const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    return ::fcntl(fd_, F_GETPIPE_SZ);
+}
+
+bool Pipe::set_capacity(size_t capacity) {
+    if (fd_ < 0 || capacity > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return false;
+    }
+    return ::fcntl(fd_, F_SETPIPE_SZ, static_cast<int>(capacity)) >= 0;
+}
+
+ssize_t Pipe::splice_from(const File &src, size_t size, int64_t offset) const {
+    if (fd_ < 0 || read_end_ || !src.ok()) {
+        return -1;
+    }
+    loff_t off = offset;
+    return ::splice(src.fd(), offset < 0 ? nullptr : &off, fd_, nullptr, size, splice_flags(*this));
+}
+
+ssize_t Pipe::splice_to(const File &dst, size_t size, int64_t offset) const {
+    if (fd_ < 0 || !read_end_ || !dst.ok()) {
+        return -1;
+    }
+    loff_t off = offset;
+    return ::splice(fd_, nullptr, dst.fd(), offset < 0 ? nullptr : &off, size, splice_flags(*this));
+}
+
+ssize_t Pipe::vmsplice(const uint8_t *src, size_t size) const {
+    if (fd_ < 0 || read_end_) {
+        return -1;
+    }
+    struct iovec iov;
+    iov.iov_base = const_cast<uint8_t *>(src);
+    iov.iov_len = size;
+    unsigned int flags = is_nonblocking() ? SPLICE_F_NONBLOCK : 0;
+    return ::vmsplice(fd_, &iov, 1, flags);
+}
+
+ssize_t Pipe::tee(const Pipe &dst, size_t size) const {
+    if (fd_ < 0 || !read_end_ || !dst.ok() || dst.read_end_) {
+        return -1;
+    }
+    unsigned int flags = is_nonblocking() ? SPLICE_F_NONBLOCK : 0;
+    return ::tee(fd_, dst.fd_, size, flags);
+}
+
 Pipe::Pipe(int fd, bool read_end) : File(fd), read_end_(read_end) {}
 
 }  // namespace ipc
@@ -0,0 +1,91 @@
+#include "rix/ipc/selector.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+namespace rix {
+namespace ipc {
+
+Selector::Selector() : pfds_() {}
+
+bool Selector::add(int fd, short events) {
+    if (fd < 0) {
+        errno = EBADF;
+        return false;
+    }
+    for (auto &pfd : pfds_) {
+        if (pfd.fd == fd) {
+            pfd.events = events;
+            return true;
+        }
+    }
+    pfds_.push_back({fd, events, 0});
+    return true;
+}
+
+bool Selector::add(const File &file, short events) { return add(file.fd(), events); }
+
+bool Selector::add(const Signal &signal) { return add(signal.fd(), READABLE); }
+
+bool Selector::add(const EventNotification &notification) { return add(notification.fd(), READABLE); }
+
+bool Selector::remove(int fd) {
+    auto it = std::find_if(pfds_.begin(), pfds_.end(), [fd](const struct pollfd &pfd) { return pfd.fd == fd; });
+    if (it == pfds_.end()) {
+        return false;
+    }
+    pfds_.erase(it);
+    return true;
+}
+
+bool Selector::remove(const File &file) { return remove(file.fd()); }
+
+ssize_t Selector::wait(const util::Duration &duration, std::vector<Ready> &ready) {
+    ready.clear();
+
+    const int64_t ns = std::max<int64_t>(duration.to_nanoseconds(), 0);
+    const auto start = std::chrono::steady_clock::now();
+    int64_t remaining = ns;
+    int ret;
+    while (true) {
+        struct timespec timeout = {static_cast<time_t>(remaining / 1'000'000'000),
+                                   static_cast<long>(remaining % 1'000'000'000)};
+        ret = ::ppoll(pfds_.data(), pfds_.size(), &timeout, nullptr);
+        if (ret >= 0 || errno != EINTR) {
+            break;
+        }
+        // A Signal handler has already written to its pipe by the time ppoll
+        // returns, so a non-blocking second pass picks it up
+        struct timespec zero = {0, 0};
+        ret = ::ppoll(pfds_.data(), pfds_.size(), &zero, nullptr);
+        if (ret != 0) {
+            break;
+        }
+        // Nothing is ready yet, so keep waiting for the rest of the duration
+        // rather than reporting an early timeout
+        remaining = ns - std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        if (remaining <= 0) {
+            break;
+        }
+    }
+    if (ret < 0) {
+        return -1;
+    }
+
+    for (const auto &pfd : pfds_) {
+        if (pfd.revents != 0) {
+            ready.push_back({pfd.fd, pfd.revents});
+        }
+    }
+    return static_cast<ssize_t>(ready.size());
+}
+
+size_t Selector::size() const { return pfds_.size(); }
+
+void Selector::clear() { pfds_.clear(); }
+
+}  // namespace ipc
+}  // namespace rix
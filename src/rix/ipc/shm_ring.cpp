@@ -0,0 +1,510 @@
+#include "rix/ipc/shm_ring.hpp"
+
+#include <linux/futex.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+namespace rix {
+namespace ipc {
+
+namespace {
+
+size_t page_size() { return static_cast<size_t>(::sysconf(_SC_PAGESIZE)); }
+
+size_t round_capacity(size_t capacity) {
+    size_t cap = page_size();
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+std::string shm_name(const std::string &name) { return (!name.empty() && name[0] == '/') ? name : "/" + name; }
+
+// The futex word lives in a MAP_SHARED region, so the (non-private) futex
+// operations work across processes as well as threads
+void futex_wait(std::atomic<uint32_t> &word, uint32_t expected, const struct timespec *timeout) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t> &word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+std::array<ShmRing, 2> ShmRing::create(size_t capacity) {
+    const size_t cap = round_capacity(capacity);
+    File memfd(::memfd_create("rix_shm_ring", MFD_CLOEXEC));
+    if (!memfd.ok() || ::ftruncate(memfd.fd(), static_cast<off_t>(page_size() + cap)) != 0) {
+        return {ShmRing(), ShmRing()};
+    }
+    File dup_fd(memfd.fd() >= 0 ? ::dup(memfd.fd()) : -1);
+
+    ShmRing writer(std::move(memfd), cap, Mode::WRITE, true);
+    ShmRing reader(std::move(dup_fd), cap, Mode::READ, false);
+    if (!writer.ok() || !reader.ok()) {
+        return {ShmRing(), ShmRing()};
+    }
+    return {std::move(reader), std::move(writer)};
+}
+
+bool ShmRing::remove(const std::string &name) { return ::shm_unlink(shm_name(name).c_str()) == 0; }
+
+ShmRing::ShmRing()
+    : file_(), mode_(Mode::READ), nonblocking_(false), control_(nullptr), data_(nullptr), capacity_(0) {}
+
+ShmRing::ShmRing(const std::string &name, size_t capacity, Mode mode, bool nonblocking) : ShmRing() {
+    mode_ = mode;
+    nonblocking_ = nonblocking;
+
+    const std::string path = shm_name(name);
+    size_t cap = round_capacity(capacity);
+    bool created = true;
+    // Only the owner may open the ring, so other users cannot inject or
+    // corrupt its data
+    File shm(::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600));
+    if (!shm.ok()) {
+        if (errno != EEXIST) {
+            return;
+        }
+        created = false;
+        shm = File(::shm_open(path.c_str(), O_RDWR | O_CLOEXEC, 0600));
+        if (!shm.ok()) {
+            return;
+        }
+    }
+
+    if (created) {
+        if (::ftruncate(shm.fd(), static_cast<off_t>(page_size() + cap)) != 0) {
+            ::shm_unlink(path.c_str());
+            return;
+        }
+    } else {
+        // The creator may not have sized the object yet. Since the control
+        // block is valid when zero-filled, the size is all that is needed.
+        struct stat st;
+        for (int attempt = 0; attempt < 1000; attempt++) {
+            if (::fstat(shm.fd(), &st) != 0) {
+                return;
+            }
+            if (st.st_size > 0) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (static_cast<size_t>(st.st_size) <= page_size()) {
+            errno = EINVAL;
+            return;
+        }
+        cap = static_cast<size_t>(st.st_size) - page_size();
+        // Positions are reduced with `& (capacity - 1)`
+        if ((cap & (cap - 1)) != 0) {
+            errno = EINVAL;
+            return;
+        }
+    }
+
+    file_ = std::move(shm);
+    if (!map(cap, created)) {
+        file_ = File();
+        return;
+    }
+    // The creator records the capacity once the ring is mapped; a different
+    // value means the object is not a ring of this size
+    const uint64_t recorded = control_->capacity.load(std::memory_order_acquire);
+    if (recorded != 0 && recorded != cap) {
+        // Not `unmap`, which would mark this end of the foreign ring closed
+        ::munmap(control_, page_size() + 2 * capacity_);
+        control_ = nullptr;
+        data_ = nullptr;
+        capacity_ = 0;
+        file_ = File();
+        errno = EINVAL;
+        return;
+    }
+    // Reopen this end if a previous user of the ring closed it
+    if (mode_ == Mode::WRITE) {
+        control_->writer_closed.store(0, std::memory_order_seq_cst);
+    } else {
+        control_->reader_closed.store(0, std::memory_order_seq_cst);
+    }
+}
+
+ShmRing::ShmRing(File &&file, size_t capacity, Mode mode, bool initialize) : ShmRing() {
+    mode_ = mode;
+    file_ = std::move(file);
+    if (!map(capacity, initialize)) {
+        file_ = File();
+    }
+}
+
+ShmRing::ShmRing(ShmRing &&other) : ShmRing() { *this = std::move(other); }
+
+ShmRing &ShmRing::operator=(ShmRing &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    unmap();
+    file_ = std::move(other.file_);
+    mode_ = other.mode_;
+    nonblocking_ = other.nonblocking_;
+    control_ = other.control_;
+    data_ = other.data_;
+    capacity_ = other.capacity_;
+    other.control_ = nullptr;
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+    return *this;
+}
+
+ShmRing::~ShmRing() { unmap(); }
+
+bool ShmRing::map(size_t capacity, bool initialize) {
+    if (!file_.ok()) {
+        return false;
+    }
+    const size_t header = page_size();
+    const size_t total = header + 2 * capacity;
+
+    // Reserve address space for the control page and two copies of the data,
+    // then map the data region a second time directly after the first one
+    void *base = ::mmap(nullptr, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    uint8_t *bytes = static_cast<uint8_t *>(base);
+    if (::mmap(bytes, header + capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file_.fd(), 0) ==
+            MAP_FAILED ||
+        ::mmap(bytes + header + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file_.fd(),
+               static_cast<off_t>(header)) == MAP_FAILED) {
+        ::munmap(base, total);
+        return false;
+    }
+
+    control_ = reinterpret_cast<Control *>(bytes);
+    data_ = bytes + header;
+    capacity_ = capacity;
+    if (initialize) {
+        control_->capacity.store(capacity, std::memory_order_release);
+    }
+    return true;
+}
+
+void ShmRing::unmap() {
+    if (control_ == nullptr) {
+        return;
+    }
+    // Behave like closing one end of a pipe: the peer sees EOF or EPIPE
+    if (mode_ == Mode::WRITE) {
+        control_->writer_closed.store(1, std::memory_order_seq_cst);
+        control_->tail_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(control_->tail_seq);
+    } else {
+        control_->reader_closed.store(1, std::memory_order_seq_cst);
+        control_->head_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(control_->head_seq);
+    }
+    ::munmap(control_, page_size() + 2 * capacity_);
+    control_ = nullptr;
+    data_ = nullptr;
+    capacity_ = 0;
+    file_ = File();
+}
+
+size_t ShmRing::readable_bytes() const {
+    return control_->tail.load(std::memory_order_acquire) - control_->head.load(std::memory_order_acquire);
+}
+
+size_t ShmRing::writable_bytes() const { return capacity_ - readable_bytes(); }
+
+bool ShmRing::wait_on(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiting, bool readable,
+                      const util::Duration &duration) const {
+    auto ready = [&]() -> bool {
+        if (readable) {
+            return readable_bytes() > 0 || control_->writer_closed.load(std::memory_order_acquire);
+        }
+        return writable_bytes() > 0 || control_->reader_closed.load(std::memory_order_acquire);
+    };
+
+    if (ready()) {
+        return true;
+    }
+    if (duration.to_nanoseconds() <= 0) {
+        return false;
+    }
+
+    const bool forever = duration >= util::Duration::safe_forever();
+    const auto deadline = std::chrono::steady_clock::now() + (forever ? util::Duration::Type(0) : duration.get());
+    while (true) {
+        // Announce that we are about to sleep before re-checking, so that the
+        // peer either sees the flag or we see its update
+        waiting.store(1, std::memory_order_seq_cst);
+        const uint32_t expected = seq.load(std::memory_order_seq_cst);
+        if (ready()) {
+            waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (forever) {
+            futex_wait(seq, expected, nullptr);
+        } else {
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds(0)) {
+                waiting.store(0, std::memory_order_relaxed);
+                return ready();
+            }
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            struct timespec ts;
+            ts.tv_sec = ns / 1'000'000'000;
+            ts.tv_nsec = ns % 1'000'000'000;
+            futex_wait(seq, expected, &ts);
+        }
+        waiting.store(0, std::memory_order_relaxed);
+        if (ready()) {
+            return true;
+        }
+    }
+}
+
+ssize_t ShmRing::read(uint8_t *dst, size_t size) const {
+    if (!ok() || mode_ != Mode::READ) {
+        errno = EBADF;
+        return -1;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    while (true) {
+        size_t available = 0;
+        const uint8_t *src = peek(available);
+        if (src != nullptr) {
+            const size_t n = std::min(available, size);
+            std::memcpy(dst, src, n);
+            release(n);
+            return static_cast<ssize_t>(n);
+        }
+        if (control_->writer_closed.load(std::memory_order_acquire)) {
+            // Data committed before the writer closed is still readable
+            if (readable_bytes() == 0) {
+                return 0;
+            }
+            continue;
+        }
+        if (nonblocking_) {
+            errno = EAGAIN;
+            return -1;
+        }
+        wait_for_readable(util::Duration::max());
+    }
+}
+
+ssize_t ShmRing::write(const uint8_t *src, size_t size) const {
+    if (!ok() || mode_ != Mode::WRITE) {
+        errno = EBADF;
+        return -1;
+    }
+    size_t written = 0;
+    while (written < size) {
+        if (control_->reader_closed.load(std::memory_order_acquire)) {
+            if (written > 0) {
+                return static_cast<ssize_t>(written);
+            }
+            errno = EPIPE;
+            return -1;
+        }
+        const size_t space = writable_bytes();
+        if (space > 0) {
+            const size_t n = std::min(space, size - written);
+            std::memcpy(reserve(n), src + written, n);
+            commit(n);
+            written += n;
+            continue;
+        }
+        if (nonblocking_) {
+            if (written > 0) {
+                return static_cast<ssize_t>(written);
+            }
+            errno = EAGAIN;
+            return -1;
+        }
+        wait_for_writable(util::Duration::max());
+    }
+    return static_cast<ssize_t>(written);
+}
+
+ssize_t ShmRing::readv(const struct iovec *iov, int iovcnt) const {
+    if (!ok() || mode_ != Mode::READ || iovcnt < 0) {
+        errno = EBADF;
+        return -1;
+    }
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    while (true) {
+        size_t available = 0;
+        const uint8_t *src = peek(available);
+        if (src != nullptr) {
+            const size_t n = std::min(available, total);
+            size_t copied = 0;
+            for (int i = 0; i < iovcnt && copied < n; i++) {
+                const size_t chunk = std::min(iov[i].iov_len, n - copied);
+                std::memcpy(iov[i].iov_base, src + copied, chunk);
+                copied += chunk;
+            }
+            release(n);
+            return static_cast<ssize_t>(n);
+        }
+        if (control_->writer_closed.load(std::memory_order_acquire)) {
+            if (readable_bytes() == 0) {
+                return 0;
+            }
+            continue;
+        }
+        if (nonblocking_) {
+            errno = EAGAIN;
+            return -1;
+        }
+        wait_for_readable(util::Duration::max());
+    }
+}
+
+ssize_t ShmRing::writev(const struct iovec *iov, int iovcnt) const {
+    if (!ok() || mode_ != Mode::WRITE || iovcnt < 0) {
+        errno = EBADF;
+        return -1;
+    }
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+
+    // Position in the source buffers
+    int index = 0;
+    size_t index_offset = 0;
+    size_t written = 0;
+    while (written < total) {
+        if (control_->reader_closed.load(std::memory_order_acquire)) {
+            if (written > 0) {
+                return static_cast<ssize_t>(written);
+            }
+            errno = EPIPE;
+            return -1;
+        }
+        const size_t space = writable_bytes();
+        if (space == 0) {
+            if (nonblocking_) {
+                if (written > 0) {
+                    return static_cast<ssize_t>(written);
+                }
+                errno = EAGAIN;
+                return -1;
+            }
+            wait_for_writable(util::Duration::max());
+            continue;
+        }
+
+        const size_t n = std::min(space, total - written);
+        uint8_t *dst = reserve(n);
+        size_t copied = 0;
+        while (copied < n) {
+            const size_t chunk = std::min(iov[index].iov_len - index_offset, n - copied);
+            std::memcpy(dst + copied, static_cast<const uint8_t *>(iov[index].iov_base) + index_offset, chunk);
+            copied += chunk;
+            index_offset += chunk;
+            if (index_offset == iov[index].iov_len) {
+                index++;
+                index_offset = 0;
+            }
+        }
+        commit(n);
+        written += n;
+    }
+    return static_cast<ssize_t>(written);
+}
+
+bool ShmRing::wait_for_readable(const util::Duration &duration) const {
+    if (!ok()) {
+        return false;
+    }
+    return wait_on(control_->tail_seq, control_->reader_waiting, true, duration);
+}
+
+bool ShmRing::wait_for_writable(const util::Duration &duration) const {
+    if (!ok()) {
+        return false;
+    }
+    return wait_on(control_->head_seq, control_->writer_waiting, false, duration);
+}
+
+void ShmRing::set_nonblocking(bool status) { nonblocking_ = status; }
+
+bool ShmRing::is_nonblocking() const { return nonblocking_; }
+
+uint8_t *ShmRing::reserve(size_t size) const {
+    if (!ok() || mode_ != Mode::WRITE || size > writable_bytes()) {
+        return nullptr;
+    }
+    const uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    return data_ + (tail & (capacity_ - 1));
+}
+
+void ShmRing::commit(size_t size) const {
+    if (!ok() || mode_ != Mode::WRITE || size == 0) {
+        return;
+    }
+    // Never publish more than fits, or the reader would see overwritten data
+    control_->tail.fetch_add(std::min(size, writable_bytes()), std::memory_order_seq_cst);
+    control_->tail_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (control_->reader_waiting.load(std::memory_order_seq_cst)) {
+        futex_wake(control_->tail_seq);
+    }
+}
+
+const uint8_t *ShmRing::peek(size_t &size) const {
+    size = 0;
+    if (!ok() || mode_ != Mode::READ) {
+        return nullptr;
+    }
+    size = readable_bytes();
+    if (size == 0) {
+        return nullptr;
+    }
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    return data_ + (head & (capacity_ - 1));
+}
+
+void ShmRing::release(size_t size) const {
+    if (!ok() || mode_ != Mode::READ || size == 0) {
+        return;
+    }
+    control_->head.fetch_add(std::min(size, readable_bytes()), std::memory_order_seq_cst);
+    control_->head_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (control_->writer_waiting.load(std::memory_order_seq_cst)) {
+        futex_wake(control_->head_seq);
+    }
+}
+
+size_t ShmRing::capacity() const { return capacity_; }
+
+size_t ShmRing::size() const { return ok() ? readable_bytes() : 0; }
+
+int ShmRing::fd() const { return file_.fd(); }
+
+bool ShmRing::ok() const { return control_ != nullptr; }
+
+ShmRing::Mode ShmRing::mode() const { return mode_; }
+
+}  // namespace ipc
+}  // namespace rix
@@ -80,6 +80,13 @@ int Signal::signum() const {
     return signum_ + 1;
 }
 
+int Signal::fd() const {
+    if (signum_ < 0 || signum_ >= 32 || !notifier[signum_].is_init) {
+        return -1;
+    }
+    return notifier[signum_].pipe[0].fd();
+}
+
 /**< TODO */
 bool Signal::wait(const rix::util::Duration &d) const {
     if (signum_ < 0 || signum_ >= 32) {
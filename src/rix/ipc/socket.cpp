@@ -0,0 +1,199 @@
+#include "rix/ipc/socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+namespace rix {
+namespace ipc {
+
+std::array<Socket, 2> Socket::create_pair(Type type) {
+    int fds[2] = {-1, -1};
+    if (::socketpair(AF_UNIX, static_cast<int>(type) | SOCK_CLOEXEC, 0, fds) != 0) {
+        return {Socket(), Socket()};
+    }
+    return {Socket(fds[0], type), Socket(fds[1], type)};
+}
+
+Socket::Socket() : File(), type_(Type::SEQPACKET) {}
+
+Socket::Socket(Type type, bool nonblocking) : File(), type_(type) {
+    int flags = static_cast<int>(type) | SOCK_CLOEXEC;
+    if (nonblocking) {
+        flags |= SOCK_NONBLOCK;
+    }
+    fd_ = ::socket(AF_UNIX, flags, 0);
+}
+
+Socket::Socket(const Socket &src) : File(), type_(src.type_), pathname_(src.pathname_) {
+    if (src.fd_ >= 0) {
+        fd_ = ::dup(src.fd_);
+    } else {
+        fd_ = -1;
+    }
+}
+
+Socket &Socket::operator=(const Socket &src) {
+    if (this == &src) {
+        return *this;
+    }
+
+    if (fd_ > 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    type_ = src.type_;
+    pathname_ = src.pathname_;
+
+    if (src.fd_ >= 0) {
+        fd_ = ::dup(src.fd_);
+    } else {
+        fd_ = -1;
+    }
+
+    return *this;
+}
+
+Socket::Socket(Socket &&src)
+    : File(std::move(src)), type_(src.type_), pathname_(std::move(src.pathname_)) {}
+
+Socket &Socket::operator=(Socket &&src) {
+    if (fd_ > 0) {
+        ::close(fd_);
+        fd_ = -1;
+        pathname_ = "";
+    }
+    std::swap(fd_, src.fd_);
+    type_ = src.type_;
+    pathname_ = std::move(src.pathname_);
+    return *this;
+}
+
+Socket::~Socket() {}
+
+Socket::Socket(int fd, Type type) : File(fd), type_(type) {}
+
+bool Socket::make_address(const std::string &pathname, struct sockaddr_un &addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (pathname.empty() || pathname.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    std::memcpy(addr.sun_path, pathname.c_str(), pathname.size() + 1);
+    return true;
+}
+
+bool Socket::bind(const std::string &pathname) {
+    struct sockaddr_un addr;
+    if (fd_ < 0 || !make_address(pathname, addr)) {
+        return false;
+    }
+    if (::bind(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+        return false;
+    }
+    pathname_ = pathname;
+    return true;
+}
+
+bool Socket::listen(int backlog) const {
+    if (fd_ < 0) {
+        return false;
+    }
+    return ::listen(fd_, backlog) == 0;
+}
+
+Socket Socket::accept() const {
+    if (fd_ < 0) {
+        return Socket();
+    }
+    int fd;
+    do {
+        fd = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return Socket();
+    }
+    return Socket(fd, type_);
+}
+
+bool Socket::connect(const std::string &pathname) const {
+    struct sockaddr_un addr;
+    if (fd_ < 0 || !make_address(pathname, addr)) {
+        return false;
+    }
+    return ::connect(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0;
+}
+
+ssize_t Socket::write(const uint8_t *src, size_t size) const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    return ::send(fd_, src, size, MSG_NOSIGNAL);
+}
+
+ssize_t Socket::writev(const struct iovec *iov, int iovcnt) const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec *>(iov);
+    msg.msg_iovlen = static_cast<size_t>(iovcnt);
+    return ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+}
+
+ssize_t Socket::send_batch(const std::vector<struct iovec> &frames) const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    if (frames.empty()) {
+        return 0;
+    }
+    std::vector<struct mmsghdr> msgs(frames.size());
+    for (size_t i = 0; i < frames.size(); i++) {
+        std::memset(&msgs[i], 0, sizeof(struct mmsghdr));
+        msgs[i].msg_hdr.msg_iov = const_cast<struct iovec *>(&frames[i]);
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int ret;
+    do {
+        ret = ::sendmmsg(fd_, msgs.data(), static_cast<unsigned int>(msgs.size()), MSG_NOSIGNAL);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+ssize_t Socket::recv_batch(std::vector<struct iovec> &frames) const {
+    if (fd_ < 0) {
+        return -1;
+    }
+    if (frames.empty()) {
+        return 0;
+    }
+    std::vector<struct mmsghdr> msgs(frames.size());
+    for (size_t i = 0; i < frames.size(); i++) {
+        std::memset(&msgs[i], 0, sizeof(struct mmsghdr));
+        msgs[i].msg_hdr.msg_iov = &frames[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    // MSG_WAITFORONE: block (if blocking) for the first message only, then
+    // return whatever else is already queued
+    int ret;
+    do {
+        ret = ::recvmmsg(fd_, msgs.data(), static_cast<unsigned int>(msgs.size()), MSG_WAITFORONE, nullptr);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        return -1;
+    }
+    for (int i = 0; i < ret; i++) {
+        frames[i].iov_len = msgs[i].msg_len;
+    }
+    return ret;
+}
+
+Socket::Type Socket::type() const { return type_; }
+
+std::string Socket::pathname() const { return pathname_; }
+
+}  // namespace ipc
+}  // namespace rix
@@ -0,0 +1,172 @@
+#include "rix/ipc/topic.hpp"
+
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+namespace rix {
+namespace ipc {
+
+namespace {
+
+std::atomic<uint32_t> endpoint_counter(0);
+
+bool valid_name(const std::string &name) {
+    if (name.empty() || name[0] == '/' || name.find("..") != std::string::npos) {
+        return false;
+    }
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-' && c != '/') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool owned_directory(const std::string &path) {
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode) || st.st_uid != ::geteuid()) {
+        errno = EACCES;
+        return false;
+    }
+    return true;
+}
+
+// Creates `path` (which starts with `root`) and any missing parents. Missing
+// directories are created 0700, and `root` and every directory below it must
+// be owned by the current user, so other users can neither publish to a topic
+// nor create it in advance
+bool make_directories(const std::string &root, const std::string &path) {
+    size_t pos = 0;
+    while (pos != std::string::npos) {
+        pos = path.find('/', pos + 1);
+        const std::string prefix = path.substr(0, pos);
+        if (::mkdir(prefix.c_str(), 0700) != 0 && errno != EEXIST) {
+            return false;
+        }
+        if (prefix.size() >= root.size() && !owned_directory(prefix)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Endpoint names are "<hash>.<pid>.<counter>"
+bool parse_endpoint(const std::string &filename, std::string &hash, pid_t &pid) {
+    size_t first = filename.find('.');
+    size_t second = filename.find('.', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+        return false;
+    }
+    hash = filename.substr(0, first);
+    pid = static_cast<pid_t>(std::strtol(filename.c_str() + first + 1, nullptr, 10));
+    return pid > 0;
+}
+
+}  // namespace
+
+std::string Topic::default_root() {
+    const char *runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime != nullptr && runtime[0] == '/') {
+        return std::string(runtime) + "/rix_topics";
+    }
+    return "/tmp/rix_topics_" + std::to_string(::geteuid());
+}
+
+Topic::Topic() : name_(), path_(), hash_(), mtime_{0, 0}, listed_{0, 0}, ok_(false) {}
+
+Topic::Topic(const std::string &name, const std::array<uint64_t, 2> &hash, const std::string &root) : Topic() {
+    if (!valid_name(name) || root.empty()) {
+        errno = EINVAL;
+        return;
+    }
+    char hex[33];
+    std::snprintf(hex, sizeof(hex), "%016" PRIx64 "%016" PRIx64, hash[0], hash[1]);
+    name_ = name;
+    hash_ = hex;
+    path_ = root + "/" + name;
+    ok_ = make_directories(root, path_);
+}
+
+std::string Topic::create_endpoint() const {
+    if (!ok_) {
+        return "";
+    }
+    std::string endpoint = path_ + "/" + hash_ + "." + std::to_string(::getpid()) + "." +
+                           std::to_string(endpoint_counter.fetch_add(1));
+    if (::mkfifo(endpoint.c_str(), 0600) != 0) {
+        return "";
+    }
+    return endpoint;
+}
+
+std::vector<std::string> Topic::endpoints() const {
+    std::vector<std::string> result;
+    if (!ok_) {
+        return result;
+    }
+    DIR *dir = ::opendir(path_.c_str());
+    if (dir == nullptr) {
+        return result;
+    }
+    struct dirent *entry;
+    while ((entry = ::readdir(dir)) != nullptr) {
+        std::string hash;
+        pid_t pid;
+        if (entry->d_type == DT_DIR || !parse_endpoint(entry->d_name, hash, pid)) {
+            continue;
+        }
+        std::string endpoint = path_ + "/" + entry->d_name;
+        if (::kill(pid, 0) != 0 && errno == ESRCH) {
+            ::unlink(endpoint.c_str());
+            continue;
+        }
+        if (hash == hash_) {
+            result.push_back(endpoint);
+        }
+    }
+    ::closedir(dir);
+    return result;
+}
+
+bool Topic::changed() {
+    struct stat st;
+    if (!ok_ || ::stat(path_.c_str(), &st) != 0) {
+        return false;
+    }
+    // Without multigrain timestamps, the modification time only advances
+    // once per coarse clock tick, so an endpoint added in the tick of the
+    // last listing leaves it unchanged. List again until a listing happens in
+    // a later tick than the last modification.
+    struct timespec now;
+    ::clock_gettime(CLOCK_REALTIME_COARSE, &now);
+    const bool same = st.st_mtim.tv_sec == mtime_.tv_sec && st.st_mtim.tv_nsec == mtime_.tv_nsec;
+    const bool settled = listed_.tv_sec > mtime_.tv_sec ||
+                         (listed_.tv_sec == mtime_.tv_sec && listed_.tv_nsec > mtime_.tv_nsec);
+    if (same && settled) {
+        return false;
+    }
+    mtime_ = st.st_mtim;
+    listed_ = now;
+    return true;
+}
+
+const std::string &Topic::name() const { return name_; }
+
+const std::string &Topic::path() const { return path_; }
+
+bool Topic::ok() const { return ok_; }
+
+}  // namespace ipc
+}  // namespace rix
@@ -0,0 +1,400 @@
+#include "rix/util/binary_log.hpp"
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <mutex>
+
+#include "rix/ipc/file.hpp"
+#include "rix/msg/serialization.hpp"
+
+namespace rix {
+namespace util {
+
+using rix::msg::detail::deserialize_number;
+using BinaryCore = detail::AsyncCore<BinaryLog>;
+
+namespace {
+
+struct FormatInfo {
+    Log::Level level;
+    std::string format;
+    std::string file;
+    int line;
+};
+
+/**
+ * @brief State shared by the logging threads and the background writer. The
+ * formats are registered by logging threads under `mutex`; everything else is
+ * only touched by the background writer while a log is open.
+ *
+ */
+struct State {
+    std::mutex mutex;
+    std::vector<FormatInfo> formats;
+    size_t formats_written = 0;  /**< Formats already written to the current file */
+    ipc::File file;
+    std::vector<uint8_t> buffer;
+};
+
+State &state() {
+    static State s;
+    return s;
+}
+
+template <typename T>
+void append_number(std::vector<uint8_t> &dst, const T &value) {
+    const size_t offset = dst.size();
+    dst.resize(offset + sizeof(T));
+    std::memcpy(dst.data() + offset, &value, sizeof(T));
+}
+
+void append_string(std::vector<uint8_t> &dst, std::string_view value) {
+    const uint16_t size = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+    append_number(dst, size);
+    dst.insert(dst.end(), value.begin(), value.begin() + size);
+}
+
+// Writes the formats registered since the last call, so every entry in the
+// file follows the format it refers to
+void write_formats(State &s, uint32_t id) {
+    std::lock_guard<std::mutex> guard(s.mutex);
+    for (; s.formats_written < s.formats.size() && s.formats_written <= id; s.formats_written++) {
+        const FormatInfo &info = s.formats[s.formats_written];
+        s.buffer.push_back(binary_log::FORMAT);
+        append_number(s.buffer, static_cast<uint32_t>(s.formats_written));
+        s.buffer.push_back(static_cast<uint8_t>(info.level));
+        append_string(s.buffer, info.format);
+        append_string(s.buffer, info.file);
+        append_number(s.buffer, static_cast<uint32_t>(info.line));
+    }
+}
+
+void write_entry(uint32_t id, int64_t ns, std::string_view args) {
+    State &s = state();
+    if (id >= s.formats_written) {
+        write_formats(s, id);
+    }
+    s.buffer.push_back(binary_log::ENTRY);
+    append_number(s.buffer, id);
+    append_number(s.buffer, ns);
+    append_string(s.buffer, args);
+}
+
+void flush() {
+    State &s = state();
+    size_t sent = 0;
+    while (sent < s.buffer.size()) {
+        ssize_t w = s.file.write(s.buffer.data() + sent, s.buffer.size() - sent);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        sent += static_cast<size_t>(w);
+    }
+    s.buffer.clear();
+}
+
+/**
+ * @brief A decoded argument. Numbers are kept in every representation so any
+ * conversion in the format can be applied to them.
+ *
+ */
+struct Arg {
+    uint8_t type = 0;
+    int64_t i = 0;
+    uint64_t u = 0;
+    double d = 0.0;
+    std::string s;
+};
+
+bool decode_arg(const uint8_t *src, size_t size, size_t &offset, Arg &arg) {
+    if (offset >= size) {
+        return false;
+    }
+    arg.type = src[offset++];
+    switch (arg.type) {
+        case binary_log::INT:
+            if (!deserialize_number(arg.i, src, size, offset)) return false;
+            arg.u = static_cast<uint64_t>(arg.i);
+            arg.d = static_cast<double>(arg.i);
+            return true;
+        case binary_log::UINT:
+        case binary_log::POINTER:
+            if (!deserialize_number(arg.u, src, size, offset)) return false;
+            arg.i = static_cast<int64_t>(arg.u);
+            arg.d = static_cast<double>(arg.u);
+            return true;
+        case binary_log::DOUBLE:
+            if (!deserialize_number(arg.d, src, size, offset)) return false;
+            arg.i = static_cast<int64_t>(arg.d);
+            arg.u = static_cast<uint64_t>(arg.i);
+            return true;
+        case binary_log::CHAR:
+        case binary_log::BOOL: {
+            uint8_t value = 0;
+            if (!deserialize_number(value, src, size, offset)) return false;
+            arg.i = arg.type == binary_log::CHAR ? static_cast<char>(value) : value;
+            arg.u = static_cast<uint64_t>(arg.i);
+            arg.d = static_cast<double>(arg.i);
+            return true;
+        }
+        case binary_log::STRING: {
+            uint16_t length = 0;
+            if (!deserialize_number(length, src, size, offset) || offset + length > size) return false;
+            arg.s.assign(reinterpret_cast<const char *>(src + offset), length);
+            offset += length;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+void append_printf(std::string &dst, const std::string &spec, T value) {
+    char buffer[128];
+    int n = std::snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+    if (n < 0) {
+        return;
+    }
+    if (static_cast<size_t>(n) < sizeof(buffer)) {
+        dst.append(buffer, n);
+        return;
+    }
+    const size_t offset = dst.size();
+    dst.resize(offset + n + 1);
+    std::snprintf(dst.data() + offset, n + 1, spec.c_str(), value);
+    dst.resize(offset + n);
+}
+
+// Text of an argument printed with %s
+std::string to_text(const Arg &arg) {
+    std::string text;
+    switch (arg.type) {
+        case binary_log::STRING:
+            return arg.s;
+        case binary_log::INT:
+            return std::to_string(arg.i);
+        case binary_log::UINT:
+            return std::to_string(arg.u);
+        case binary_log::DOUBLE:
+            append_printf(text, "%g", arg.d);
+            return text;
+        case binary_log::CHAR:
+            return std::string(1, static_cast<char>(arg.i));
+        case binary_log::BOOL:
+            return arg.i ? "true" : "false";
+        case binary_log::POINTER:
+            append_printf(text, "%p", reinterpret_cast<void *>(static_cast<uintptr_t>(arg.u)));
+            return text;
+        default:
+            return text;
+    }
+}
+
+}  // namespace
+
+bool BinaryLog::open(const std::string &pathname, size_t ring_size) {
+    if (is_open()) {
+        close();
+    }
+    State &s = state();
+    s.file = ipc::File(pathname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (!s.file.ok()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        s.formats_written = 0;
+    }
+    s.buffer.assign(binary_log::MAGIC.begin(), binary_log::MAGIC.end());
+    flush();
+    BinaryCore::start(ring_size, write_entry, flush);
+    return true;
+}
+
+void BinaryLog::close() {
+    BinaryCore::stop();
+    state().file = ipc::File();
+}
+
+bool BinaryLog::is_open() { return BinaryCore::enabled.load(std::memory_order_relaxed); }
+
+size_t BinaryLog::dropped() { return BinaryCore::dropped.load(); }
+
+uint32_t BinaryLog::define(Log::Level level, const char *format, const char *file, int line) {
+    State &s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    s.formats.push_back({level, format, file, line});
+    return static_cast<uint32_t>(s.formats.size() - 1);
+}
+
+void BinaryLog::push(uint32_t id, const uint8_t *args, size_t size) {
+    thread_local std::shared_ptr<detail::LogRing> ring = BinaryCore::add_ring();
+    if (!ring->push(id, Time::now().to_nanoseconds(), reinterpret_cast<const char *>(args), size)) {
+        BinaryCore::dropped++;
+    }
+}
+
+std::string binary_log::format(std::string_view format, const uint8_t *args, size_t size) {
+    std::string result;
+    size_t offset = 0;
+    size_t i = 0;
+    while (i < format.size()) {
+        const char c = format[i++];
+        if (c != '%') {
+            result.push_back(c);
+            continue;
+        }
+        if (i < format.size() && format[i] == '%') {
+            result.push_back('%');
+            i++;
+            continue;
+        }
+
+        // Flags, width and precision are kept; length modifiers are dropped
+        std::string spec = "%";
+        while (i < format.size() && std::string_view("-+ #0").find(format[i]) != std::string_view::npos) {
+            spec.push_back(format[i++]);
+        }
+        while (i < format.size() && (std::isdigit(static_cast<unsigned char>(format[i])) || format[i] == '.')) {
+            spec.push_back(format[i++]);
+        }
+        while (i < format.size() && std::string_view("hljztLq").find(format[i]) != std::string_view::npos) {
+            i++;
+        }
+        if (i >= format.size()) {
+            result.append(spec);
+            break;
+        }
+        const char conversion = format[i++];
+
+        Arg arg;
+        if (!decode_arg(args, size, offset, arg)) {
+            result.append("<missing>");
+            offset = size;
+            continue;
+        }
+        switch (conversion) {
+            case 'd':
+            case 'i':
+                append_printf(result, spec + "ll" + conversion, static_cast<long long>(arg.i));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                append_printf(result, spec + "ll" + conversion, static_cast<unsigned long long>(arg.u));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                append_printf(result, spec + conversion, arg.d);
+                break;
+            case 'c':
+                append_printf(result, spec + conversion, static_cast<int>(arg.i));
+                break;
+            case 'p':
+                append_printf(result, spec + conversion, reinterpret_cast<void *>(static_cast<uintptr_t>(arg.u)));
+                break;
+            default:
+                append_printf(result, spec + 's', to_text(arg).c_str());
+                break;
+        }
+    }
+    return result;
+}
+
+BinaryLogReader::BinaryLogReader(const std::string &pathname)
+    : map_(pathname, ipc::MappedFile::Mode::READ), offset_(binary_log::MAGIC.size()), formats_(), ok_(false) {
+    if (!map_.ok()) {
+        return;
+    }
+    auto bytes = map_.data();
+    if (bytes.size() < binary_log::MAGIC.size() ||
+        std::memcmp(bytes.data(), binary_log::MAGIC.data(), binary_log::MAGIC.size()) != 0) {
+        errno = EINVAL;
+        return;
+    }
+    map_.advise(ipc::MappedFile::Advice::SEQUENTIAL);
+    ok_ = true;
+}
+
+bool BinaryLogReader::next(Entry &entry) {
+    if (!ok_) {
+        return false;
+    }
+    const auto bytes = map_.data();
+    const uint8_t *src = bytes.data();
+    const size_t size = bytes.size();
+    while (offset_ < size) {
+        size_t offset = offset_;
+        const uint8_t type = src[offset++];
+        uint32_t id = 0;
+        if (!deserialize_number(id, src, size, offset)) {
+            return false;
+        }
+
+        if (type == binary_log::FORMAT) {
+            uint8_t level = 0;
+            uint16_t format_size = 0, file_size = 0;
+            uint32_t line = 0;
+            if (!deserialize_number(level, src, size, offset) || level > static_cast<uint8_t>(Log::Level::FATAL) ||
+                !deserialize_number(format_size, src, size, offset) || offset + format_size > size) {
+                return false;
+            }
+            Format &format = formats_[id];
+            format.level = static_cast<Log::Level>(level);
+            format.format.assign(reinterpret_cast<const char *>(src + offset), format_size);
+            offset += format_size;
+            if (!deserialize_number(file_size, src, size, offset) || offset + file_size > size) {
+                return false;
+            }
+            format.file.assign(reinterpret_cast<const char *>(src + offset), file_size);
+            offset += file_size;
+            if (!deserialize_number(line, src, size, offset)) {
+                return false;
+            }
+            format.line = static_cast<int>(line);
+            offset_ = offset;
+            continue;
+        }
+        if (type != binary_log::ENTRY) {
+            return false;
+        }
+
+        int64_t ns = 0;
+        uint16_t args_size = 0;
+        if (!deserialize_number(ns, src, size, offset) || !deserialize_number(args_size, src, size, offset) ||
+            offset + args_size > size) {
+            return false;
+        }
+        offset_ = offset + args_size;
+        auto it = formats_.find(id);
+        if (it == formats_.end()) {
+            continue;
+        }
+        const Format &format = it->second;
+        entry.level = format.level;
+        entry.stamp = Time(Time::Type(std::chrono::nanoseconds(ns)));
+        entry.text = binary_log::format(format.format, src + offset, args_size);
+        entry.file = format.file;
+        entry.line = format.line;
+        return true;
+    }
+    return false;
+}
+
+bool BinaryLogReader::ok() const { return ok_; }
+
+}  // namespace util
+}  // namespace rix
@@ -1,13 +1,151 @@
 #include "rix/util/time.hpp"
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 #include <thread>
 
+// The TSC conversion multiplies with unsigned __int128, which 32-bit x86 lacks
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
 namespace rix {
 namespace util {
 
+namespace {
+
+int64_t read_clock(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Conversion from time stamp counter ticks to monotonic nanoseconds:
+ * ns = ns0 + ((tsc - tsc0) * mult) >> 32.
+ *
+ */
+struct TscCalibration {
+    bool available = false;
+    uint64_t tsc0 = 0;
+    int64_t ns0 = 0;
+    uint64_t mult = 0;
+    double frequency = 0.0;
+};
+
+#if defined(__x86_64__)
+bool invariant_tsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007 || !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return edx & (1u << 8);
+}
+
+TscCalibration calibrate_tsc() {
+    TscCalibration calibration;
+    if (!invariant_tsc()) {
+        return calibration;
+    }
+    // Pair each counter read with the closest clock read to bound the error
+    auto sample = [](uint64_t &tsc, int64_t &ns) {
+        uint64_t best = UINT64_MAX;
+        for (int i = 0; i < 5; i++) {
+            const uint64_t before = __rdtsc();
+            const int64_t now = read_clock(CLOCK_MONOTONIC);
+            const uint64_t after = __rdtsc();
+            if (after - before < best) {
+                best = after - before;
+                tsc = before + (after - before) / 2;
+                ns = now;
+            }
+        }
+    };
+    uint64_t tsc0, tsc1;
+    int64_t ns0, ns1;
+    sample(tsc0, ns0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    sample(tsc1, ns1);
+    if (tsc1 <= tsc0 || ns1 <= ns0) {
+        return calibration;
+    }
+    calibration.available = true;
+    calibration.tsc0 = tsc0;
+    calibration.ns0 = ns0;
+    calibration.mult = static_cast<uint64_t>((static_cast<unsigned __int128>(ns1 - ns0) << 32) / (tsc1 - tsc0));
+    calibration.frequency = (tsc1 - tsc0) * 1e9 / (ns1 - ns0);
+    return calibration;
+}
+#else
+TscCalibration calibrate_tsc() { return TscCalibration(); }
+#endif
+
+const TscCalibration &tsc_calibration() {
+    static const TscCalibration calibration = calibrate_tsc();
+    return calibration;
+}
+
+}  // namespace
+
+SteadyClock::time_point SteadyClock::now() noexcept {
+    return time_point(std::chrono::nanoseconds(read_clock(CLOCK_MONOTONIC)));
+}
+
+CoarseSteadyClock::time_point CoarseSteadyClock::now() noexcept {
+    return time_point(std::chrono::nanoseconds(read_clock(CLOCK_MONOTONIC_COARSE)));
+}
+
+CoarseSystemClock::time_point CoarseSystemClock::now() noexcept {
+    return time_point(std::chrono::nanoseconds(read_clock(CLOCK_REALTIME_COARSE)));
+}
+
+TscClock::time_point TscClock::now() noexcept {
+#if defined(__x86_64__)
+    const TscCalibration &calibration = tsc_calibration();
+    if (calibration.available) {
+        const uint64_t ticks = __rdtsc() - calibration.tsc0;
+        const int64_t ns = calibration.ns0 + static_cast<int64_t>((static_cast<unsigned __int128>(ticks) * calibration.mult) >> 32);
+        return time_point(std::chrono::nanoseconds(ns));
+    }
+#endif
+    return time_point(std::chrono::nanoseconds(read_clock(CLOCK_MONOTONIC)));
+}
+
+bool TscClock::available() { return tsc_calibration().available; }
+
+double TscClock::frequency() { return tsc_calibration().frequency; }
+
+namespace detail {
+
+int64_t epoch_offset(Epoch from, Epoch to) {
+    if (from == to) {
+        return 0;
+    }
+    // Bracket the realtime read with monotonic reads and use their midpoint
+    const int64_t before = read_clock(CLOCK_MONOTONIC);
+    const int64_t realtime = read_clock(CLOCK_REALTIME);
+    const int64_t after = read_clock(CLOCK_MONOTONIC);
+    const int64_t offset = realtime - (before + (after - before) / 2);
+    return from == Epoch::MONOTONIC ? offset : -offset;
+}
+
+void sleep_until(clockid_t clock, int64_t ns) {
+    if (ns <= 0) {
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    while (clock_nanosleep(clock, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+}  // namespace detail
+
 std::string Time::to_string(bool local_time) const {
     auto time = Clock::to_time_t(std::chrono::time_point_cast<std::chrono::seconds>(tp));
     std::stringstream ss;
@@ -20,11 +158,7 @@ std::string Time::to_string(bool local_time) const {
 
     ss << std::put_time(timeinfo, "%D %T");
     int64_t us = to_microseconds() % 1'000'000;
-    if (us == 0) {
-        ss << ".000000";
-    } else {
-        ss << "." << us;
-    }
+    ss << "." << std::setw(6) << std::setfill('0') << us;
 
     if (local_time) {
         ss << " " << std::put_time(timeinfo, "%Z");
@@ -296,20 +430,27 @@ Timer &Timer::operator=(const Timer &other) {
     return *this;
 }
 
-void Timer::start() { start_ = Time::now(); }
+void Timer::start() { start_ = SteadyTime::now(); }
 
-void Timer::stop() { end_ = Time::now(); }
+void Timer::stop() { end_ = SteadyTime::now(); }
 
 Duration Timer::get() const { return end_ - start_; }
 
-Rate::Rate() : period_(0), start_(Time::now()) {}
+Duration Rate::Stats::mean_jitter() const {
+    const uint64_t met = cycles - overruns;
+    return met == 0 ? Duration() : Duration(std::chrono::nanoseconds(total_jitter.to_nanoseconds() / static_cast<int64_t>(met)));
+}
+
+Duration Rate::Stats::bucket_limit(size_t i) { return Duration(std::chrono::microseconds(int64_t(1) << i)); }
 
-Rate::Rate(double frequency)
-    : period_((frequency <= min_frequency()) ? max_period() : Duration(1.0 / frequency)), start_(Time::now()) {}
+Rate::Rate() : period_(0), start_(SteadyTime::now()), mode_(Mode::DEADLINE), spin_(0), stats_{} {}
 
-Rate::Rate(Duration period) : period_((period <= min_period()) ? min_period() : period), start_(Time::now()) {}
+Rate::Rate(double frequency) : Rate() { set_frequency(frequency); }
 
-Rate::Rate(const Rate &other) : period_(other.period_), start_(other.start_) {}
+Rate::Rate(Duration period) : Rate() { period_ = (period <= min_period()) ? min_period() : period; }
+
+Rate::Rate(const Rate &other)
+    : period_(other.period_), start_(other.start_), mode_(other.mode_), spin_(other.spin_), stats_(other.stats_) {}
 
 Rate &Rate::operator=(const Rate &other) {
     if (this == &other) {
@@ -318,20 +459,65 @@ Rate &Rate::operator=(const Rate &other) {
     Rate tmp(other);
     std::swap(period_, tmp.period_);
     std::swap(start_, tmp.start_);
+    std::swap(mode_, tmp.mode_);
+    std::swap(spin_, tmp.spin_);
+    std::swap(stats_, tmp.stats_);
     return *this;
 }
 
 bool Rate::sleep() {
-    auto now = Time::now();
-    if (start_ + period_ > now) {
-        sleep_until(start_ + period_);
-        start_ = Time::now();
-        return true;
-    } else {
-        start_ = now;
+    stats_.cycles++;
+    auto now = SteadyTime::now();
+    // An infinite period would overflow the deadline
+    const SteadyTime deadline = (period_ == max_period()) ? SteadyTime::max() : start_ + period_;
+
+    if (deadline <= now) {
+        stats_.overruns++;
+        if (mode_ == Mode::RELATIVE || period_ <= Duration()) {
+            start_ = now;
+            return false;
+        }
+        // Skip to the last deadline that has passed, keeping the phase
+        const int64_t missed = (now - deadline).to_nanoseconds() / period_.to_nanoseconds();
+        stats_.missed += static_cast<uint64_t>(missed);
+        start_ = deadline + Duration(std::chrono::nanoseconds(missed * period_.to_nanoseconds()));
         return false;
     }
+
+    if (spin_ <= Duration()) {
+        sleep_until(deadline);
+    } else if (deadline - spin_ > now) {
+        sleep_until(deadline - spin_);
+    }
+    // Spin through the rest of the window (or an early wakeup)
+    now = SteadyTime::now();
+    while (now < deadline) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+        now = SteadyTime::now();
+    }
+
+    record(now - deadline);
+    start_ = (mode_ == Mode::DEADLINE) ? deadline : now;
+    return true;
+}
+
+void Rate::record(const Duration &lateness) {
+    stats_.total_jitter += lateness;
+    stats_.max_jitter = std::max(stats_.max_jitter, lateness);
+    size_t bucket = 0;
+    while (bucket + 1 < Stats::BUCKETS && lateness >= Stats::bucket_limit(bucket)) {
+        bucket++;
+    }
+    stats_.histogram[bucket]++;
+}
+
+void Rate::reset() {
+    start_ = SteadyTime::now();
+    stats_ = Stats{};
 }
+
 Duration Rate::period() const { return period_; }
 
 void Rate::set_period(const Duration &period) { period_ = period; }
@@ -352,5 +538,15 @@ void Rate::set_frequency(double frequency) {
     }
 }
 
+Rate::Mode Rate::mode() const { return mode_; }
+
+void Rate::set_mode(Mode mode) { mode_ = mode; }
+
+void Rate::set_spin(const Duration &window) { spin_ = std::max(window, Duration()); }
+
+Duration Rate::spin() const { return spin_; }
+
+const Rate::Stats &Rate::stats() const { return stats_; }
+
 }  // namespace util
 }  // namespace rix
\ No newline at end of file
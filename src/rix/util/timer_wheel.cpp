@@ -0,0 +1,286 @@
+#include "rix/util/timer_wheel.hpp"
+
+#include <sys/timerfd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace rix {
+namespace util {
+
+TimerWheel::TimerWheel(const Duration &resolution)
+    : file_(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+      resolution_(std::max(resolution, Duration(std::chrono::microseconds(1)))),
+      origin_(SteadyTime::now()),
+      current_(0),
+      armed_(NEVER),
+      nodes_(),
+      free_(),
+      slots_(),
+      occupied_(),
+      size_(0),
+      firing_(NONE),
+      firing_cancelled_(false) {
+    slots_.fill(NONE);
+}
+
+TimerWheel::Id TimerWheel::add(const Duration &delay, Callback callback) {
+    return insert(tick_at(SteadyTime::now() + delay, true), 0, std::move(callback));
+}
+
+TimerWheel::Id TimerWheel::add_periodic(const Duration &period, Callback callback, const Duration &delay) {
+    const uint64_t period_ticks = std::max<uint64_t>(ticks(period), 1);
+    const Duration first =
+        delay < Duration() ? Duration(std::chrono::nanoseconds(period_ticks * resolution_.to_nanoseconds())) : delay;
+    return insert(tick_at(SteadyTime::now() + first, true), period_ticks, std::move(callback));
+}
+
+TimerWheel::Id TimerWheel::insert(uint64_t expiry, uint64_t period, Callback callback) {
+    if (!ok()) {
+        errno = EBADF;
+        return INVALID_ID;
+    }
+    uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(Node{0, 0, nullptr, 1, NONE, NONE, NONE});
+    }
+    Node &node = nodes_[index];
+    node.expiry = std::max(expiry, current_ + 1);
+    node.period = period;
+    node.callback = std::move(callback);
+    link(index);
+    size_++;
+    // process rearms the timerfd once all callbacks have run
+    if (firing_ == NONE && node.expiry < armed_) {
+        arm();
+    }
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(Id id) {
+    const uint32_t index = static_cast<uint32_t>(id);
+    if (index >= nodes_.size() || nodes_[index].generation != static_cast<uint32_t>(id >> 32) ||
+        nodes_[index].slot == NONE) {
+        return false;
+    }
+    unlink(index);
+    size_--;
+    if (index == firing_) {
+        // Released once its callback returns
+        firing_cancelled_ = true;
+    } else {
+        release(index);
+    }
+    return true;
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node &node = nodes_[index];
+    // Timers beyond the range of the wheel wait in the last slot of the top
+    // level and are placed again when it is cascaded
+    const uint64_t range = uint64_t(1) << (LEVELS * SLOT_BITS);
+    const uint64_t expiry = std::min(node.expiry, current_ + range - 1);
+    const uint64_t delta = expiry - current_;
+    size_t level = 0;
+    while (level + 1 < LEVELS && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+    const uint32_t slot = static_cast<uint32_t>(level * SLOTS + ((expiry >> (level * SLOT_BITS)) & (SLOTS - 1)));
+
+    node.slot = slot;
+    node.prev = NONE;
+    node.next = slots_[slot];
+    if (node.next != NONE) {
+        nodes_[node.next].prev = index;
+    }
+    slots_[slot] = index;
+    occupied_[slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node &node = nodes_[index];
+    if (node.prev != NONE) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[node.slot] = node.next;
+        if (node.next == NONE) {
+            occupied_[node.slot / 64] &= ~(uint64_t(1) << (node.slot % 64));
+        }
+    }
+    if (node.next != NONE) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.slot = NONE;
+    node.prev = NONE;
+    node.next = NONE;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node &node = nodes_[index];
+    node.callback = nullptr;
+    // Invalidates the ids of the timer; 0 is skipped so no id equals INVALID_ID
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    free_.push_back(index);
+}
+
+void TimerWheel::cascade(size_t level) {
+    const uint32_t slot = static_cast<uint32_t>(level * SLOTS + ((current_ >> (level * SLOT_BITS)) & (SLOTS - 1)));
+    uint32_t index = slots_[slot];
+    slots_[slot] = NONE;
+    occupied_[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    while (index != NONE) {
+        const uint32_t next = nodes_[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+size_t TimerWheel::expire() {
+    size_t fired = 0;
+    const uint32_t slot = static_cast<uint32_t>(current_ & (SLOTS - 1));
+    // Timers added by callbacks are always due after the current tick, so the
+    // slot empties
+    while (slots_[slot] != NONE) {
+        const uint32_t index = slots_[slot];
+        Node &node = nodes_[index];
+        unlink(index);
+        if (node.period > 0) {
+            node.expiry += node.period;
+            if (node.expiry <= current_) {
+                node.expiry += (current_ - node.expiry) / node.period * node.period + node.period;
+            }
+            link(index);
+        } else {
+            size_--;
+        }
+
+        firing_ = index;
+        firing_cancelled_ = false;
+        node.callback();
+        firing_ = NONE;
+        fired++;
+        if (node.period == 0 || firing_cancelled_) {
+            release(index);
+        }
+    }
+    return fired;
+}
+
+size_t TimerWheel::advance(uint64_t target) {
+    size_t fired = 0;
+    while (current_ < target) {
+        // Skip the ticks at which there is nothing to cascade or expire
+        const uint64_t next = next_tick();
+        if (next > target) {
+            current_ = target;
+            break;
+        }
+        current_ = next;
+        for (size_t level = LEVELS - 1; level > 0; level--) {
+            const uint64_t mask = (uint64_t(1) << (level * SLOT_BITS)) - 1;
+            if ((current_ & mask) == 0) {
+                cascade(level);
+            }
+        }
+        fired += expire();
+    }
+    return fired;
+}
+
+size_t TimerWheel::distance(size_t level, size_t from) const {
+    for (size_t j = 1; j <= SLOTS;) {
+        const size_t slot = (from + j) & (SLOTS - 1);
+        const uint64_t bits = occupied_[(level * SLOTS + slot) / 64] >> (slot % 64);
+        if (bits != 0) {
+            const size_t found = j + static_cast<size_t>(__builtin_ctzll(bits));
+            return found <= SLOTS ? found : 0;
+        }
+        j += 64 - slot % 64;
+    }
+    return 0;
+}
+
+uint64_t TimerWheel::next_tick() const {
+    if (size_ == 0) {
+        return NEVER;
+    }
+    uint64_t best = NEVER;
+    for (size_t level = 0; level < LEVELS; level++) {
+        const size_t shift = level * SLOT_BITS;
+        const uint64_t base = current_ >> shift;
+        // Higher levels only act at later ticks
+        if (((base + 1) << shift) >= best) {
+            break;
+        }
+        const size_t j = distance(level, base & (SLOTS - 1));
+        if (j > 0) {
+            best = std::min(best, (base + j) << shift);
+        }
+    }
+    return best;
+}
+
+void TimerWheel::arm() {
+    const uint64_t next = next_tick();
+    if (next == armed_) {
+        return;
+    }
+    armed_ = next;
+    struct itimerspec spec = {};
+    if (next != NEVER) {
+        const int64_t ns = origin_.to_nanoseconds() + static_cast<int64_t>(next) * resolution_.to_nanoseconds();
+        spec.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+        spec.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    }
+    ::timerfd_settime(file_.fd(), TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+size_t TimerWheel::process() {
+    if (!ok()) {
+        return 0;
+    }
+    uint64_t expirations;
+    file_.read(reinterpret_cast<uint8_t *>(&expirations), sizeof(expirations));
+    // The timerfd expired, so it must be armed again even for the same tick
+    armed_ = NEVER;
+    const size_t fired = advance(tick_at(SteadyTime::now(), false));
+    arm();
+    return fired;
+}
+
+size_t TimerWheel::wait(const Duration &duration) {
+    file_.wait_for_readable(duration);
+    return process();
+}
+
+int TimerWheel::fd() const { return file_.fd(); }
+
+bool TimerWheel::ok() const { return file_.ok(); }
+
+size_t TimerWheel::size() const { return size_; }
+
+Duration TimerWheel::resolution() const { return resolution_; }
+
+uint64_t TimerWheel::ticks(const Duration &duration) const {
+    const int64_t ns = std::max<int64_t>(duration.to_nanoseconds(), 0);
+    const int64_t res = resolution_.to_nanoseconds();
+    return static_cast<uint64_t>((ns + res / 2) / res);
+}
+
+uint64_t TimerWheel::tick_at(const SteadyTime &time, bool round_up) const {
+    const int64_t ns = (time - origin_).to_nanoseconds();
+    const int64_t res = resolution_.to_nanoseconds();
+    if (ns <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(round_up ? (ns + res - 1) / res : ns / res);
+}
+
+}  // namespace util
+}  // namespace rix
@@ -0,0 +1,52 @@
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "rix/util/argument_parser.hpp"
+#include "rix/util/binary_log.hpp"
+#include "rix/util/log.hpp"
+
+using namespace rix::util;
+
+int main(int argc, char **argv) {
+    ArgumentParser parser("rix_logcat", "Prints the entries of a binary log written with RIX_BLOG as text.");
+    parser.add<std::string>("log", "Path of the binary log");
+    parser.add<int>("level", "Minimum level to print (0 DEBUG, 1 INFO, 2 WARN, 3 ERROR, 4 FATAL)", 'l', 0);
+    parser.add<bool>("source", "Print the source file and line of each entry", 's', false);
+
+    if (!parser.parse(argc, argv)) {
+        std::cerr << parser.help() << std::endl;
+        return 1;
+    }
+
+    std::string path;
+    int level;
+    bool source;
+    if (!parser.get<std::string>("log", path) || !parser.get<int>("level", level) ||
+        !parser.get<bool>("source", source)) {
+        std::cerr << "Failed to get arguments." << std::endl;
+        return 1;
+    }
+
+    BinaryLogReader reader(path);
+    if (!reader.ok()) {
+        std::cerr << "Failed to open binary log: " << path << std::endl;
+        return 1;
+    }
+
+    const std::array<std::string, 5> suffixes = {"[DEBUG] ", "[INFO]  ", "[WARN]  ", "[ERROR] ", "[FATAL] "};
+    detail::HeaderFormatter formatter;
+    BinaryLogReader::Entry entry;
+    while (reader.next(entry)) {
+        if (entry.level < level) {
+            continue;
+        }
+        std::cout << formatter.format(entry.stamp.to_nanoseconds(), suffixes[entry.level]);
+        if (source) {
+            std::cout << "[" << entry.file << ":" << entry.line << "] ";
+        }
+        std::cout << entry.text << '\n';
+    }
+    std::cout.flush();
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+
+#include "rix/bag/player.hpp"
+#include "rix/bag/reader.hpp"
+#include "rix/ipc/file.hpp"
+#include "rix/ipc/signal.hpp"
+#include "rix/util/argument_parser.hpp"
+#include "rix/util/time.hpp"
+
+using namespace rix::bag;
+using namespace rix::ipc;
+using namespace rix::util;
+
+int main(int argc, char **argv) {
+    ArgumentParser parser("rix_replay",
+                          "Replays the frames recorded in a bag to stdout (or a file or FIFO) with their original timing.");
+    parser.add<std::string>("bag", "Path of the bag to replay");
+    parser.add<std::string>("output", "File or FIFO to write frames to, or - for stdout", 'o', std::string("-"));
+    parser.add<double>("scale", "Time-scale factor (2 is twice as fast, 0 is as fast as possible)", 's', 1.0);
+    parser.add<double>("start", "Seconds from the beginning of the bag at which to start", 'b', 0.0);
+    parser.add<double>("duration", "Seconds of the bag to replay (0 replays to the end)", 'd', 0.0);
+
+    if (!parser.parse(argc, argv)) {
+        std::cerr << parser.help() << std::endl;
+        return 1;
+    }
+
+    std::string path, output_path;
+    double scale, start, duration;
+    if (!parser.get<std::string>("bag", path) || !parser.get<std::string>("output", output_path) ||
+        !parser.get<double>("scale", scale) || !parser.get<double>("start", start) ||
+        !parser.get<double>("duration", duration)) {
+        std::cerr << "Failed to get arguments." << std::endl;
+        return 1;
+    }
+    if (scale < 0.0 || start < 0.0 || duration < 0.0) {
+        std::cerr << "scale, start and duration must not be negative." << std::endl;
+        return 1;
+    }
+
+    Reader reader(path);
+    if (!reader.ok()) {
+        std::cerr << "Failed to open bag: " << path << std::endl;
+        return 1;
+    }
+    // An empty bag has no start time to offset from
+    if (reader.size() > 0 && (start > 0.0 || duration > 0.0)) {
+        Time begin = reader.start() + Duration(start);
+        reader.seek(begin, duration > 0.0 ? begin + Duration(duration) : Time::max());
+    }
+
+    std::unique_ptr<File> output;
+    if (output_path == "-") {
+        output = std::make_unique<File>(STDOUT_FILENO);
+    } else {
+        output = std::make_unique<File>(output_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (!output->ok()) {
+        std::cerr << "Failed to open output: " << output_path << std::endl;
+        return 1;
+    }
+
+    Signal sig(SIGINT);
+    Player player(reader, *output, scale);
+    bool complete = player.play([&sig]() { return sig.wait(Duration(0.0)); });
+
+    const auto &stats = player.stats();
+    std::cerr << "Replayed " << stats.frames << " of " << reader.size() << " frames in "
+              << stats.elapsed.to_nanoseconds() * 1e-9 << " s (" << stats.rate() << " frames/s)" << std::endl;
+    if (scale > 0.0) {
+        std::cerr << "Timing error: mean " << stats.mean_error.to_nanoseconds() * 1e-3 << " us, max "
+                  << stats.max_error.to_nanoseconds() * 1e-3 << " us" << std::endl;
+    }
+    return complete ? 0 : 1;
+}
@@ -16,6 +16,9 @@ int main(int argc, char **argv) {
                           "Sends drive commands to stdout corresponding to characters written to FIFO.");
     parser.add<double>("linear_speed", "Linear speed to drive the MBot (m/s)", 'l', 0.25);
     parser.add<double>("angular_speed", "Angular speed to drive the MBot (rad/s)", 'a', 1.570796);
+    parser.add<int>("queue_size", "Maximum number of commands waiting for a slow consumer", 'q', 64);
+    parser.add<std::string>("overflow", "Policy when the queue is full (drop_oldest, drop_newest, latest)", 'o',
+                            std::string("drop_oldest"));
 
     if (!parser.parse(argc, argv)) {
         std::cerr << parser.help() << std::endl;
@@ -34,9 +37,33 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    int queue_size;
+    if (!parser.get<int>("queue_size", queue_size) || queue_size < 1) {
+        std::cerr << "Failed to get queue_size argument." << std::endl;
+        return 1;
+    }
+
+    std::string overflow;
+    if (!parser.get<std::string>("overflow", overflow)) {
+        std::cerr << "Failed to get overflow argument." << std::endl;
+        return 1;
+    }
+    TeleopKeyboard::OverflowPolicy policy;
+    if (overflow == "drop_oldest") {
+        policy = TeleopKeyboard::OverflowPolicy::DROP_OLDEST;
+    } else if (overflow == "drop_newest") {
+        policy = TeleopKeyboard::OverflowPolicy::DROP_NEWEST;
+    } else if (overflow == "latest") {
+        policy = TeleopKeyboard::OverflowPolicy::COLLAPSE_TO_LATEST;
+    } else {
+        std::cerr << "Invalid overflow policy: " << overflow << std::endl;
+        return 1;
+    }
+
     auto input = std::make_unique<Fifo>("teleop", Fifo::Mode::READ);
     auto output = std::make_unique<File>(STDOUT_FILENO);
-    TeleopKeyboard teleop_keyboard(std::move(input), std::move(output), linear_speed, angular_speed);
+    TeleopKeyboard teleop_keyboard(std::move(input), std::move(output), linear_speed, angular_speed,
+                                   static_cast<size_t>(queue_size), policy);
 
     auto notif = std::make_unique<Signal>(SIGINT);
     teleop_keyboard.spin(std::move(notif));
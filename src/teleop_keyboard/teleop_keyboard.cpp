@@ -1,9 +1,102 @@
 #include <teleop_keyboard/teleop_keyboard.hpp>
 
+#include <limits.h>
+
+#include <array>
+
 TeleopKeyboard::TeleopKeyboard(std::unique_ptr<rix::ipc::interfaces::IO> input,
                                std::unique_ptr<rix::ipc::interfaces::IO> output, double linear_speed,
-                               double angular_speed)
-    : input(std::move(input)), output(std::move(output)), linear_speed(linear_speed), angular_speed(angular_speed) {}
+                               double angular_speed, size_t queue_capacity, OverflowPolicy policy)
+    : input(std::move(input)),
+      output(std::move(output)),
+      linear_speed(linear_speed),
+      angular_speed(angular_speed),
+      queue_capacity(std::max<size_t>(queue_capacity, 1)),
+      policy(policy),
+      pending(),
+      pending_offset(0),
+      dropped_frames(0) {}
+
+size_t TeleopKeyboard::dropped() const { return dropped_frames; }
+
+void TeleopKeyboard::enqueue(std::vector<uint8_t> &&frame, bool stop) {
+    // A partially written frame must be finished, or the stream loses framing
+    const size_t in_flight = pending_offset > 0 ? 1 : 0;
+    if (stop && policy == OverflowPolicy::DROP_NEWEST && pending.size() >= queue_capacity) {
+        // A stop command is never the one dropped: it replaces the oldest
+        // command instead, and only exceeds the capacity if that command is
+        // being written
+        if (pending.size() > in_flight) {
+            pending.erase(pending.begin() + in_flight);
+            dropped_frames++;
+        }
+        pending.push_back(std::move(frame));
+        return;
+    }
+    switch (policy) {
+        case OverflowPolicy::COLLAPSE_TO_LATEST:
+            dropped_frames += pending.size() - in_flight;
+            pending.erase(pending.begin() + in_flight, pending.end());
+            break;
+        case OverflowPolicy::DROP_OLDEST:
+            if (pending.size() >= queue_capacity && pending.size() > in_flight) {
+                pending.erase(pending.begin() + in_flight);
+                dropped_frames++;
+            }
+            break;
+        case OverflowPolicy::DROP_NEWEST:
+            if (pending.size() >= queue_capacity) {
+                dropped_frames++;
+                return;
+            }
+            break;
+    }
+    pending.push_back(std::move(frame));
+}
+
+bool TeleopKeyboard::flush() {
+    while (!pending.empty()) {
+        if (!output->wait_for_writable(rix::util::Duration(0.0))) {
+            return true;
+        }
+
+        // Gather queued frames into one write of at most PIPE_BUF bytes, which
+        // a writable pipe takes without blocking
+        std::array<struct iovec, 16> iov;
+        int iovcnt = 0;
+        size_t total = 0;
+        for (auto it = pending.begin(); it != pending.end() && iovcnt < static_cast<int>(iov.size()); ++it) {
+            const size_t skip = (iovcnt == 0) ? pending_offset : 0;
+            const size_t len = it->size() - skip;
+            if (iovcnt > 0 && total + len > PIPE_BUF) {
+                break;
+            }
+            iov[iovcnt++] = {it->data() + skip, len};
+            total += len;
+        }
+
+        ssize_t w = output->writev(iov.data(), iovcnt);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            return false;
+        }
+        if (w == 0) return false;
+
+        size_t sent = static_cast<size_t>(w);
+        while (sent > 0) {
+            const size_t remaining = pending.front().size() - pending_offset;
+            if (sent < remaining) {
+                pending_offset += sent;
+                break;
+            }
+            sent -= remaining;
+            pending.pop_front();
+            pending_offset = 0;
+        }
+    }
+    return true;
+}
 
 void TeleopKeyboard::spin(std::unique_ptr<rix::ipc::interfaces::Notification> notif) {
     /* TODO */
@@ -14,21 +107,25 @@ void TeleopKeyboard::spin(std::unique_ptr<rix::ipc::interfaces::Notification> no
         return (notif != nullptr) && notif->wait(rix::util::Duration(0.0));
     };
 
-    auto write_exact = [&](const uint8_t* src, size_t nbytes) -> bool {
-        size_t sent = 0;
-        while (sent < nbytes) {
-            ssize_t w = output->write(src + sent, nbytes - sent);
-            if (w < 0) {
-                if (errno == EINTR) continue;
-                return false;
-            }
-            if (w == 0) return false;
-            sent += static_cast<size_t>(w);
+    auto *channel = dynamic_cast<rix::ipc::IntraChannel<rix::msg::geometry::Twist2DStamped> *>(output.get());
+
+    // Writes never block the input loop: commands are queued and written
+    // whenever the output is writable, subject to the overflow policy. The
+    // output is left in its own mode, since O_NONBLOCK on a shared descriptor
+    // such as stdout would also affect other processes.
+
+    // Write out whatever is still queued once the input has ended
+    auto drain = [&]() {
+        while (!pending.empty()) {
+            if (notif_ready()) return;
+            if (!flush()) return;
+            if (!pending.empty()) output->wait_for_writable(rix::util::Duration(0.001));
         }
-        return true;
     };
 
     while (true) {
+        if (!flush()) return;
+
         // Wait a tiny amount for input; if no input, then check notification.
         if (!input->wait_for_readable(rix::util::Duration(0.001))) {  // 1ms
             if (notif_ready()) return;
@@ -40,6 +137,7 @@ void TeleopKeyboard::spin(std::unique_ptr<rix::ipc::interfaces::Notification> no
 
         if (r == 0) {
             // EOF
+            drain();
             return;
         }
         if (r < 0) {
@@ -83,7 +181,7 @@ void TeleopKeyboard::spin(std::unique_ptr<rix::ipc::interfaces::Notification> no
         // Must not output after notification
         if (notif_ready()) return;
 
-        rix::msg::geometry::Twist2DStamped msg{};
+        rix::msg::geometry::Twist2DStamped msg;
         msg.header.seq = seq++;
         msg.header.frame_id = "mbot";
         msg.header.stamp = rix::util::Time::now().to_msg();
@@ -92,16 +190,28 @@ void TeleopKeyboard::spin(std::unique_ptr<rix::ipc::interfaces::Notification> no
         msg.twist.vy = vy;
         msg.twist.wz = wz;
 
-        const uint32_t n = msg.size();
-        std::vector<uint8_t> payload(n);
-        size_t off = 0;
-        msg.serialize(payload.data(), off);
+        const bool stop = (c == ' ');
+
+        // A colocated driver gets the message itself, without serialization
+        if (channel != nullptr) {
+            auto cmd = std::make_shared<const rix::msg::geometry::Twist2DStamped>(std::move(msg));
+            while (!channel->push(cmd)) {
+                if (errno != EAGAIN) return;
+                if (!stop) {
+                    dropped_frames++;
+                    break;
+                }
+                // A stop command waits for space instead of being dropped
+                if (notif_ready()) return;
+                channel->wait_for_writable(rix::util::Duration(0.001));
+            }
+            continue;
+        }
 
-        uint8_t size_buf[4];
-        size_t off2 = 0;
-        ::rix::msg::detail::serialize_number<uint32_t>(size_buf, off2, n);
+        std::vector<uint8_t> frame;
+        rix::ipc::Channel<rix::msg::geometry::Twist2DStamped>::encode(msg, frame);
 
-        if (!write_exact(size_buf, 4)) return;
-        if (n > 0 && !write_exact(payload.data(), payload.size())) return;
+        enqueue(std::move(frame), stop);
+        if (!flush()) return;
     }
 }
\ No newline at end of file
@@ -0,0 +1,432 @@
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "rix/bag/player.hpp"
+#include "rix/bag/reader.hpp"
+#include "rix/bag/writer.hpp"
+#include "rix/ipc/channel.hpp"
+#include "rix/ipc/mapped_file.hpp"
+#include "rix/ipc/pipe.hpp"
+#include "rix/msg/geometry/Twist2DStamped.hpp"
+#include "rix/msg/standard/UInt32.hpp"
+
+using namespace rix::bag;
+using rix::msg::geometry::Twist2DStamped;
+
+class BagTest : public ::testing::Test {
+   protected:
+    std::string path = "/tmp/test_bag.bag";
+
+    void SetUp() override { unlink(path.c_str()); }
+
+    void TearDown() override { unlink(path.c_str()); }
+
+    static Twist2DStamped make_twist(uint32_t seq) {
+        Twist2DStamped msg;
+        msg.header.seq = seq;
+        msg.header.frame_id = "mbot";
+        msg.twist.vx = seq * 0.25f;
+        return msg;
+    }
+
+    static rix::util::Time stamp(uint32_t seq) { return rix::util::Time(1000 + seq, 0); }
+};
+
+// Test default constructor and invalid files
+TEST_F(BagTest, InvalidFiles) {
+    Reader empty;
+    EXPECT_FALSE(empty.ok());
+
+    Reader missing("/tmp/does_not_exist.bag");
+    EXPECT_FALSE(missing.ok());
+
+    {
+        rix::ipc::File file(path, O_WRONLY | O_CREAT, 0644);
+        std::vector<uint8_t> junk(8192, 'x');
+        file.write(junk.data(), junk.size());
+    }
+    Reader junk(path);
+    EXPECT_FALSE(junk.ok());
+}
+
+// Test writing and reading back messages with their stamps
+TEST_F(BagTest, RoundTrip) {
+    {
+        Writer writer(path);
+        ASSERT_TRUE(writer.ok());
+        for (uint32_t i = 0; i < 10; i++) {
+            ASSERT_TRUE(writer.write(make_twist(i), stamp(i)));
+        }
+        EXPECT_EQ(writer.count(), 10);
+        EXPECT_TRUE(writer.close());
+        EXPECT_FALSE(writer.write(make_twist(10)));
+        EXPECT_EQ(errno, EBADF);
+    }
+
+    Reader reader(path);
+    ASSERT_TRUE(reader.ok());
+    EXPECT_TRUE(reader.indexed());
+    EXPECT_EQ(reader.size(), 10);
+    ASSERT_EQ(reader.chunks().size(), 1);
+    EXPECT_EQ(reader.chunks()[0].start, stamp(0).to_nanoseconds());
+    EXPECT_EQ(reader.chunks()[0].end, stamp(9).to_nanoseconds());
+
+    Twist2DStamped msg;
+    rix::util::Time t;
+    for (uint32_t i = 0; i < 10; i++) {
+        ASSERT_TRUE(reader.next(msg, t));
+        EXPECT_EQ(msg.header.seq, i);
+        EXPECT_EQ(msg.header.frame_id, "mbot");
+        EXPECT_EQ(msg.twist.vx, i * 0.25f);
+        EXPECT_EQ(t, stamp(i));
+    }
+    EXPECT_FALSE(reader.next(msg, t));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(msg, t));
+    EXPECT_EQ(msg.header.seq, 0);
+}
+
+// Test many chunks, each aligned and flushed by the background thread
+TEST_F(BagTest, ManyChunks) {
+    const uint32_t count = 5000;
+    {
+        Writer writer(path, 4096, 2);
+        for (uint32_t i = 0; i < count; i++) {
+            writer.write(make_twist(i), stamp(i));
+        }
+        EXPECT_EQ(writer.count() + writer.dropped(), count);
+        EXPECT_TRUE(writer.close());
+    }
+
+    Reader reader(path);
+    ASSERT_TRUE(reader.ok());
+    ASSERT_GT(reader.chunks().size(), 1);
+    for (const auto &chunk : reader.chunks()) {
+        EXPECT_EQ(chunk.offset % format::ALIGNMENT, 0);
+        EXPECT_LE(chunk.start, chunk.end);
+    }
+
+    Twist2DStamped msg;
+    rix::util::Time t;
+    size_t read = 0;
+    uint32_t last = 0;
+    while (reader.next(msg, t)) {
+        if (read > 0) {
+            EXPECT_GT(msg.header.seq, last);
+        }
+        last = msg.header.seq;
+        read++;
+    }
+    EXPECT_EQ(read, reader.size());
+}
+
+// Test raw records and skipping records of other types
+TEST_F(BagTest, MixedTypes) {
+    {
+        Writer writer(path);
+        rix::msg::standard::UInt32 number;
+        number.data = 7;
+        ASSERT_TRUE(writer.write(number, stamp(0)));
+        ASSERT_TRUE(writer.write(make_twist(1), stamp(1)));
+        const uint8_t raw[] = {1, 2, 3};
+        ASSERT_TRUE(writer.write(raw, sizeof(raw), {1, 2}, stamp(2)));
+
+        std::vector<uint8_t> huge(2 << 20);
+        EXPECT_FALSE(writer.write(huge.data(), huge.size(), {1, 2}));
+        EXPECT_EQ(errno, EMSGSIZE);
+    }
+
+    Reader reader(path);
+    Record record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.hash, rix::msg::standard::UInt32().hash());
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.hash, (std::array<uint64_t, 2>{1, 2}));
+    ASSERT_EQ(record.data.size(), 3);
+    EXPECT_EQ(record.data[2], 3);
+
+    reader.rewind();
+    Twist2DStamped msg;
+    rix::util::Time t;
+    ASSERT_TRUE(reader.next(msg, t));
+    EXPECT_EQ(msg.header.seq, 1);
+    EXPECT_FALSE(reader.next(msg, t));
+}
+
+// Test recovering the chunks of a bag that was never closed
+TEST_F(BagTest, RecoversWithoutIndex) {
+    uint64_t chunks_end = 0;
+    {
+        Writer writer(path, 4096, 1024);
+        for (uint32_t i = 0; i < 500; i++) {
+            writer.write(make_twist(i), stamp(i));
+        }
+        writer.close();
+        Reader reader(path);
+        chunks_end = reader.chunks().back().offset + reader.chunks().back().size;
+    }
+    // Drop the index and footer, and leave half of an extra chunk behind
+    ASSERT_EQ(truncate(path.c_str(), chunks_end + 2048), 0);
+
+    Reader reader(path);
+    ASSERT_TRUE(reader.ok());
+    EXPECT_FALSE(reader.indexed());
+    EXPECT_EQ(reader.size(), 500);
+
+    Twist2DStamped msg;
+    rix::util::Time t;
+    size_t read = 0;
+    while (reader.next(msg, t)) {
+        read++;
+    }
+    EXPECT_EQ(read, 500);
+}
+
+// Test that chunks older than the maximum age reach the disk before the
+// writer dies without closing the bag
+TEST_F(BagTest, AgedChunksSurviveCrash) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        Writer writer(path, 1 << 20, 8, rix::util::Duration(0.01));
+        for (uint32_t i = 0; i < 5; i++) {
+            writer.write(make_twist(i), stamp(i));
+            usleep(20000);
+        }
+        // Give the flush thread time to write the sealed chunks
+        usleep(100000);
+        kill(getpid(), SIGKILL);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status));
+
+    Reader reader(path);
+    ASSERT_TRUE(reader.ok());
+    EXPECT_FALSE(reader.indexed());
+    // Only the last record is still in memory when the writer dies
+    EXPECT_EQ(reader.size(), 4);
+    Twist2DStamped msg;
+    rix::util::Time t;
+    uint32_t seq = 0;
+    while (reader.next(msg, t)) {
+        EXPECT_EQ(msg.header.seq, seq);
+        seq++;
+    }
+    EXPECT_EQ(seq, 4);
+}
+
+// Test that an index pointing outside the file or disagreeing with the
+// chunk headers is not trusted
+TEST_F(BagTest, CorruptIndex) {
+    {
+        Writer writer(path, 4096, 16);
+        for (uint32_t i = 0; i < 200; i++) {
+            writer.write(make_twist(i), stamp(i));
+        }
+        writer.close();
+    }
+    ASSERT_GT(Reader(path).chunks().size(), 1u);
+    std::vector<uint8_t> original;
+    {
+        rix::ipc::MappedFile map(path, rix::ipc::MappedFile::Mode::READ);
+        original.assign(map.data().begin(), map.data().end());
+    }
+    auto rewrite = [this](const std::vector<uint8_t> &bytes) {
+        rix::ipc::File file(path, O_WRONLY | O_TRUNC);
+        ASSERT_EQ(file.write(bytes.data(), bytes.size()), bytes.size());
+    };
+    auto read_all = [this]() {
+        Reader reader(path);
+        EXPECT_TRUE(reader.ok());
+        Twist2DStamped msg;
+        rix::util::Time t;
+        size_t read = 0;
+        while (reader.next(msg, t)) {
+            read++;
+        }
+        return read;
+    };
+    const size_t footer = original.size() - format::FOOTER_SIZE;
+    uint64_t index_offset = 0;
+    std::memcpy(&index_offset, original.data() + footer, sizeof(index_offset));
+
+    // An index offset that wraps around falls back to scanning the chunks
+    std::vector<uint8_t> bytes = original;
+    const uint64_t huge = ~uint64_t(0) - 100;
+    std::memcpy(bytes.data() + footer, &huge, sizeof(huge));
+    rewrite(bytes);
+    {
+        Reader reader(path);
+        ASSERT_TRUE(reader.ok());
+        EXPECT_FALSE(reader.indexed());
+    }
+    EXPECT_EQ(read_all(), 200);
+
+    // A chunk inside the file header, or one whose size disagrees with its
+    // header, is not read past the end of the chunk
+    bytes = original;
+    const uint64_t inside_header = 8;
+    std::memcpy(bytes.data() + index_offset, &inside_header, sizeof(inside_header));
+    rewrite(bytes);
+    {
+        Reader reader(path);
+        ASSERT_TRUE(reader.ok());
+        EXPECT_FALSE(reader.indexed());
+    }
+
+    // Several chunks, so the first one can grow without reaching the index
+    bytes = original;
+    uint32_t chunk_size = 0;
+    std::memcpy(&chunk_size, bytes.data() + index_offset + 12, sizeof(chunk_size));
+    chunk_size += format::ALIGNMENT;
+    std::memcpy(bytes.data() + index_offset + 12, &chunk_size, sizeof(chunk_size));
+    rewrite(bytes);
+    EXPECT_EQ(read_all(), 0);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+// Test seeking to and iterating over a time range
+TEST_F(BagTest, SeekTimeRange) {
+    auto ms = [](uint32_t i) { return rix::util::Time(100, 0) + rix::util::Duration(i * 0.001); };
+    {
+        Writer writer(path, 4096, 1024);
+        for (uint32_t i = 0; i < 5000; i++) {
+            ASSERT_TRUE(writer.write(make_twist(i), ms(i)));
+        }
+    }
+
+    Reader reader(path);
+    ASSERT_TRUE(reader.ok());
+    EXPECT_EQ(reader.start(), ms(0));
+    EXPECT_EQ(reader.end(), ms(4999));
+
+    ASSERT_TRUE(reader.seek(ms(2000), ms(2099)));
+    Twist2DStamped msg;
+    rix::util::Time t;
+    uint32_t expected = 2000;
+    while (reader.next(msg, t)) {
+        EXPECT_EQ(msg.header.seq, expected++);
+        EXPECT_EQ(t, ms(msg.header.seq));
+    }
+    EXPECT_EQ(expected, 2100);
+
+    // Open-ended seek reads to the end of the bag
+    ASSERT_TRUE(reader.seek(ms(4990)));
+    size_t read = 0;
+    while (reader.next(msg, t)) {
+        read++;
+    }
+    EXPECT_EQ(read, 10);
+
+    EXPECT_FALSE(reader.seek(ms(6000)));
+    EXPECT_FALSE(reader.next(msg, t));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(msg, t));
+    EXPECT_EQ(msg.header.seq, 0);
+}
+
+// Test time ranges when stamps do not increase through the bag
+TEST_F(BagTest, SeekOutOfOrderStamps) {
+    // Every tenth message arrives with an old stamp
+    auto stamp_of = [](uint32_t i) { return rix::util::Time(100 + (i % 10 == 0 ? 0 : i), 0); };
+    {
+        Writer writer(path, 4096, 1024);
+        for (uint32_t i = 1; i <= 1000; i++) {
+            ASSERT_TRUE(writer.write(make_twist(i), stamp_of(i)));
+        }
+    }
+
+    Reader reader(path);
+    ASSERT_TRUE(reader.seek(rix::util::Time(100, 0), rix::util::Time(100, 0)));
+    Twist2DStamped msg;
+    rix::util::Time t;
+    size_t read = 0;
+    while (reader.next(msg, t)) {
+        EXPECT_EQ(msg.header.seq % 10, 0);
+        read++;
+    }
+    EXPECT_EQ(read, 100);
+
+    ASSERT_TRUE(reader.seek(rix::util::Time(600, 0), rix::util::Time(649, 0)));
+    read = 0;
+    while (reader.next(msg, t)) {
+        EXPECT_NE(msg.header.seq % 10, 0);
+        read++;
+    }
+    EXPECT_EQ(read, 45);
+}
+
+// Test replaying frames with their recorded timing, scaled
+TEST_F(BagTest, PlayerReplaysWithTiming) {
+    auto at = [](uint32_t i) { return rix::util::Time(100, 0) + rix::util::Duration(i * 0.01); };
+    {
+        Writer writer(path);
+        for (uint32_t i = 0; i < 20; i++) {
+            ASSERT_TRUE(writer.write(make_twist(i), at(i)));
+        }
+    }
+
+    auto [out, in] = rix::ipc::Pipe::create();
+    Reader reader(path);
+    Player player(reader, in, 2.0);
+    ASSERT_TRUE(player.play());
+
+    const auto &stats = player.stats();
+    EXPECT_EQ(stats.frames, 20);
+    EXPECT_GE(stats.elapsed, rix::util::Duration(0.095));
+    EXPECT_LT(stats.elapsed, rix::util::Duration(0.5));
+    EXPECT_GT(stats.rate(), 0.0);
+    EXPECT_GE(stats.max_error, stats.mean_error);
+
+    rix::ipc::Channel<Twist2DStamped> channel(out);
+    Twist2DStamped msg;
+    for (uint32_t i = 0; i < 20; i++) {
+        ASSERT_TRUE(channel.read(msg));
+        EXPECT_EQ(msg.header.seq, i);
+    }
+
+    // A second replay is timed from its own first record
+    reader.rewind();
+    ASSERT_TRUE(player.play());
+    EXPECT_EQ(stats.frames, 20);
+    EXPECT_GE(stats.elapsed, rix::util::Duration(0.095));
+    EXPECT_LT(stats.elapsed, rix::util::Duration(0.5));
+    for (uint32_t i = 0; i < 20; i++) {
+        ASSERT_TRUE(channel.read(msg));
+        EXPECT_EQ(msg.header.seq, i);
+    }
+}
+
+// Test replaying as fast as possible from a seek position, and interrupting
+TEST_F(BagTest, PlayerUnthrottledAndInterrupted) {
+    {
+        Writer writer(path);
+        for (uint32_t i = 0; i < 100; i++) {
+            ASSERT_TRUE(writer.write(make_twist(i), stamp(i)));
+        }
+    }
+
+    auto [out, in] = rix::ipc::Pipe::create();
+    Reader reader(path);
+    ASSERT_TRUE(reader.seek(stamp(90)));
+    Player fast(reader, in, 0.0);
+    ASSERT_TRUE(fast.play());
+    EXPECT_EQ(fast.stats().frames, 10);
+    EXPECT_LT(fast.stats().elapsed, rix::util::Duration(1.0));
+
+    reader.rewind();
+    Player slow(reader, in, 1.0);
+    int calls = 0;
+    EXPECT_FALSE(slow.play([&calls]() { return ++calls > 3; }));
+    EXPECT_EQ(slow.stats().frames, 1);
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rix/util/binary_log.hpp"
+
+using namespace rix::util;
+
+class BinaryLogTest : public ::testing::Test {
+   protected:
+    std::string path = "/tmp/test_binary_log.blog";
+
+    void SetUp() override { unlink(path.c_str()); }
+
+    void TearDown() override {
+        BinaryLog::close();
+        unlink(path.c_str());
+    }
+
+    std::vector<BinaryLogReader::Entry> read_all() {
+        std::vector<BinaryLogReader::Entry> entries;
+        BinaryLogReader reader(path);
+        EXPECT_TRUE(reader.ok());
+        BinaryLogReader::Entry entry;
+        while (reader.next(entry)) {
+            entries.push_back(entry);
+        }
+        return entries;
+    }
+};
+
+// Test that encoded arguments are formatted with their printf conversions
+TEST(BinaryLogFormatTest, Conversions) {
+    // Arguments built by hand in the documented layout
+    std::vector<uint8_t> args;
+    auto add = [&args](uint8_t type, const void *value, size_t n) {
+        args.push_back(type);
+        args.insert(args.end(), static_cast<const uint8_t *>(value), static_cast<const uint8_t *>(value) + n);
+    };
+    int64_t i = -42;
+    uint64_t u = 255;
+    double d = 3.14159;
+    uint16_t length = 5;
+    add(binary_log::INT, &i, sizeof(i));
+    add(binary_log::UINT, &u, sizeof(u));
+    add(binary_log::DOUBLE, &d, sizeof(d));
+    add(binary_log::STRING, &length, sizeof(length));
+    args.insert(args.end(), {'h', 'e', 'l', 'l', 'o'});
+
+    EXPECT_EQ(binary_log::format("i=%d u=%#lx d=%.2f s=%-6s| 100%%", args.data(), args.size()),
+              "i=-42 u=0xff d=3.14 s=hello | 100%");
+    EXPECT_EQ(binary_log::format("%d %d", args.data(), 1 + sizeof(i)), "-42 <missing>");
+}
+
+// Test that entries are written and decoded with their format and source
+TEST_F(BinaryLogTest, WriteAndRead) {
+    ASSERT_TRUE(BinaryLog::open(path));
+    EXPECT_TRUE(BinaryLog::is_open());
+    const std::string name = "left";
+    const Time before = Time::now();
+    for (int i = 0; i < 3; i++) {
+        RIX_BLOG(INFO, "wheel %s speed=%.2f ticks=%u", name, i * 0.5, static_cast<unsigned>(i * 10));
+    }
+    RIX_BLOG(WARN, "flags %c %s %d", 'x', true, static_cast<int16_t>(-7));
+    RIX_BLOG(ERROR, "no arguments");
+    RIX_BLOG(DEBUG, "below the compile-time level %d", 1);
+    const int line = __LINE__ - 1;
+    BinaryLog::close();
+    EXPECT_FALSE(BinaryLog::is_open());
+
+    auto entries = read_all();
+    ASSERT_EQ(entries.size(), 5u);
+    EXPECT_EQ(entries[0].text, "wheel left speed=0.00 ticks=0");
+    EXPECT_EQ(entries[2].text, "wheel left speed=1.00 ticks=20");
+    EXPECT_EQ(entries[0].level, Log::Level::INFO);
+    EXPECT_EQ(entries[3].text, "flags x true -7");
+    EXPECT_EQ(entries[3].level, Log::Level::WARN);
+    EXPECT_EQ(entries[4].text, "no arguments");
+    EXPECT_EQ(entries[4].line, line - 1);
+    EXPECT_NE(entries[4].file.find("binary_log.cpp"), std::string::npos);
+    EXPECT_GE(entries[0].stamp, before);
+    EXPECT_LE(entries[0].stamp, entries[4].stamp);
+    EXPECT_EQ(BinaryLog::dropped(), 0u);
+}
+
+// Test that each file gets the formats of statements registered while
+// writing an earlier file
+TEST_F(BinaryLogTest, Reopen) {
+    auto log = [](int i) { RIX_BLOG(INFO, "iteration %d", i); };
+    ASSERT_TRUE(BinaryLog::open(path));
+    log(1);
+    BinaryLog::close();
+    ASSERT_TRUE(BinaryLog::open(path));
+    log(2);
+    BinaryLog::close();
+
+    auto entries = read_all();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].text, "iteration 2");
+
+    // Nothing is recorded while closed
+    log(3);
+    EXPECT_EQ(read_all().size(), 1u);
+}
+
+// Test that entries from several threads are all recorded
+TEST_F(BinaryLogTest, Threads) {
+    constexpr int THREADS = 4;
+    constexpr int ENTRIES = 1000;
+    ASSERT_TRUE(BinaryLog::open(path, 1 << 20));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < ENTRIES; i++) {
+                RIX_BLOG(INFO, "thread %d entry %d", t, i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    BinaryLog::close();
+
+    auto entries = read_all();
+    EXPECT_EQ(entries.size() + BinaryLog::dropped(), static_cast<size_t>(THREADS * ENTRIES));
+    EXPECT_EQ(BinaryLog::dropped(), 0u);
+}
+
+// Test that a format record with an unknown level is rejected
+TEST_F(BinaryLogTest, InvalidLevel) {
+    std::vector<uint8_t> bytes(binary_log::MAGIC.begin(), binary_log::MAGIC.end());
+    auto append = [&bytes](const auto &value) {
+        const auto *p = reinterpret_cast<const uint8_t *>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(value));
+    };
+    bytes.push_back(binary_log::FORMAT);
+    append(uint32_t(0));
+    bytes.push_back(static_cast<uint8_t>(Log::Level::FATAL) + 1);
+    append(uint16_t(2));
+    bytes.insert(bytes.end(), {'h', 'i'});
+    append(uint16_t(0));
+    append(uint32_t(1));
+    bytes.push_back(binary_log::ENTRY);
+    append(uint32_t(0));
+    append(int64_t(0));
+    append(uint16_t(0));
+    FILE *file = fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+
+    BinaryLogReader reader(path);
+    ASSERT_TRUE(reader.ok());
+    BinaryLogReader::Entry entry;
+    EXPECT_FALSE(reader.next(entry));
+}
+
+// Test that pending entries are written at exit without close
+TEST_F(BinaryLogTest, WritesAtExit) {
+    testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT(
+        {
+            BinaryLog::open(path);
+            RIX_BLOG(INFO, "entry before exit %d", 1);
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0), "");
+
+    auto entries = read_all();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].text, "entry before exit 1");
+}
+
+// Test that a file that is not a binary log is rejected
+TEST_F(BinaryLogTest, NotABinaryLog) {
+    {
+        BinaryLogReader reader("/nonexistent/file.blog");
+        EXPECT_FALSE(reader.ok());
+    }
+    FILE *file = fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    fputs("plain text log\n", file);
+    fclose(file);
+    BinaryLogReader reader(path);
+    EXPECT_FALSE(reader.ok());
+    BinaryLogReader::Entry entry;
+    EXPECT_FALSE(reader.next(entry));
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "rix/ipc/channel.hpp"
+#include "rix/ipc/pipe.hpp"
+#include "rix/msg/geometry/Twist2DStamped.hpp"
+
+using namespace rix::ipc;
+using rix::msg::geometry::Twist2D;
+using rix::msg::geometry::Twist2DStamped;
+
+static_assert(!Channel<Twist2DStamped>::IS_FIXED, "Twist2DStamped contains a string");
+static_assert(Channel<Twist2D>::FIXED_SIZE == 12, "Twist2D is three floats");
+
+// Test a variable-size message round trip through a pipe
+TEST(ChannelTest, VariableSizeRoundTrip) {
+    auto [reader, writer] = Pipe::create();
+    Channel<Twist2DStamped> out(writer);
+    Channel<Twist2DStamped> in(reader);
+
+    Twist2DStamped sent;
+    for (uint32_t i = 0; i < 3; i++) {
+        sent.header.seq = i;
+        sent.header.frame_id = std::string(i + 1, 'a');
+        sent.twist.vx = i * 0.5f;
+        ASSERT_TRUE(out.write(sent));
+    }
+
+    Twist2DStamped received;
+    for (uint32_t i = 0; i < 3; i++) {
+        ASSERT_TRUE(in.read(received));
+        EXPECT_EQ(received.header.seq, i);
+        EXPECT_EQ(received.header.frame_id, std::string(i + 1, 'a'));
+        EXPECT_EQ(received.twist.vx, i * 0.5f);
+    }
+
+    { Pipe closed(std::move(writer)); }
+    EXPECT_FALSE(in.read(received));
+    EXPECT_EQ(errno, 0);
+}
+
+// Test that encode produces the same frame as the hand-written framing
+TEST(ChannelTest, EncodeMatchesFraming) {
+    Twist2D twist;
+    twist.vx = 1.0f;
+    twist.wz = -2.0f;
+
+    std::vector<uint8_t> expected(4 + twist.size());
+    size_t offset = 0;
+    rix::msg::detail::serialize_number<uint32_t>(expected.data(), offset, twist.size());
+    twist.serialize(expected.data(), offset);
+
+    std::vector<uint8_t> frame;
+    Channel<Twist2D>::encode(twist, frame);
+    EXPECT_EQ(frame, expected);
+
+    Twist2DStamped stamped;
+    stamped.header.frame_id = "mbot";
+    Channel<Twist2DStamped>::encode(stamped, frame);
+    EXPECT_EQ(frame.size(), 4 + stamped.size());
+}
+
+// Test the fixed-size path, including a frame of the wrong size
+TEST(ChannelTest, FixedSizeRejectsWrongSize) {
+    auto [reader, writer] = Pipe::create();
+    Channel<Twist2D> out(writer);
+    Channel<Twist2D> in(reader);
+
+    std::vector<uint8_t> bad(4 + 5);
+    size_t offset = 0;
+    rix::msg::detail::serialize_number<uint32_t>(bad.data(), offset, 5);
+    ASSERT_EQ(writer.write(bad.data(), bad.size()), bad.size());
+
+    Twist2D sent;
+    sent.vy = 3.0f;
+    ASSERT_TRUE(out.write(sent));
+
+    Twist2D received;
+    EXPECT_FALSE(in.read(received));
+    EXPECT_EQ(errno, EBADMSG);
+    ASSERT_TRUE(in.read(received)) << "The bad frame should have been consumed.";
+    EXPECT_EQ(received.vy, 3.0f);
+}
+
+// Test frames that arrive in pieces on a non-blocking IO
+TEST(ChannelTest, PartialFrames) {
+    auto [reader, writer] = Pipe::create();
+    reader.set_nonblocking(true);
+
+    Twist2DStamped sent;
+    sent.header.frame_id = "split";
+    sent.header.seq = 42;
+    std::vector<uint8_t> frame;
+    Channel<Twist2DStamped>::encode(sent, frame);
+
+    std::thread producer([&writer, &frame]() {
+        for (uint8_t byte : frame) {
+            writer.write(&byte, 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    Channel<Twist2DStamped> in(reader);
+    Twist2DStamped received;
+    ASSERT_TRUE(in.read(received));
+    producer.join();
+    EXPECT_EQ(received.header.seq, 42);
+    EXPECT_EQ(received.header.frame_id, "split");
+}
+
+// Test that the interrupt callback is only called when the read would block
+TEST(ChannelTest, Interrupted) {
+    auto [reader, writer] = Pipe::create();
+    reader.set_nonblocking(true);
+    Channel<Twist2D> out(writer);
+    Channel<Twist2D> in(reader);
+
+    int calls = 0;
+    auto interrupted = [&calls]() { return ++calls > 2; };
+
+    Twist2D twist;
+    ASSERT_TRUE(out.write(twist));
+    EXPECT_TRUE(in.read(twist, interrupted));
+    EXPECT_EQ(calls, 0);
+
+    EXPECT_FALSE(in.read(twist, interrupted));
+    EXPECT_EQ(errno, ECANCELED);
+    EXPECT_EQ(calls, 3);
+}
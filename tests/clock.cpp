@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+#include "rix/util/time.hpp"
+
+using namespace rix::util;
+
+// Test that each clock advances and the steady clocks agree with each other
+TEST(ClockTest, ClocksAdvance) {
+    const SteadyTime steady = SteadyTime::now();
+    const TscTime tsc = TscTime::now();
+    const CoarseSteadyTime coarse = CoarseSteadyTime::now();
+    const CoarseTime coarse_wall = CoarseTime::now();
+    sleep_for(Duration(0.02));
+
+    EXPECT_GE(SteadyTime::now() - steady, Duration(0.02));
+    EXPECT_GE(TscTime::now() - tsc, Duration(0.019));
+    // Coarse clocks only advance once per tick
+    EXPECT_GE(CoarseSteadyTime::now() - coarse, Duration(0.01));
+    EXPECT_GE(CoarseTime::now() - coarse_wall, Duration(0.01));
+
+    // Monotonic clocks share an epoch
+    EXPECT_LT(std::abs((time_cast<SteadyTime>(TscTime::now()) - SteadyTime::now()).to_nanoseconds()), 1'000'000);
+    EXPECT_LT(std::abs((time_cast<SteadyTime>(CoarseSteadyTime::now()) - SteadyTime::now()).to_nanoseconds()),
+              50'000'000);
+}
+
+// Test explicit conversion between the wall clock and the monotonic clock
+TEST(ClockTest, TimeCast) {
+    const Time wall = Time::now();
+    const SteadyTime steady = SteadyTime::now();
+    const SteadyTime converted = time_cast<SteadyTime>(wall);
+    EXPECT_LT(std::abs((converted - steady).to_nanoseconds()), 1'000'000);
+    const Time back = time_cast<Time>(converted);
+    EXPECT_LT(std::abs((back - wall).to_nanoseconds()), 1'000);
+
+    // Durations are kept across domains
+    const SteadyTime later = steady + Duration(2.5);
+    EXPECT_EQ(time_cast<TscTime>(later) - time_cast<TscTime>(steady), Duration(2.5));
+
+    EXPECT_EQ(time_cast<SteadyTime>(Time::max()), SteadyTime::max());
+    EXPECT_EQ(time_cast<Time>(SteadyTime::min()), Time::min());
+}
+
+// Test that the counter is calibrated when it is used
+TEST(ClockTest, TscCalibration) {
+    if (!TscClock::available()) {
+        EXPECT_EQ(TscClock::frequency(), 0.0);
+        GTEST_SKIP() << "No invariant time stamp counter";
+    }
+    EXPECT_GT(TscClock::frequency(), 1e8);
+    TscTime previous = TscTime::now();
+    for (int i = 0; i < 10000; i++) {
+        TscTime now = TscTime::now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+}
+
+// Test that sleeping until a monotonic time, Timer and Rate use the monotonic clock
+TEST(ClockTest, SleepTimerAndRate) {
+    const SteadyTime deadline = SteadyTime::now() + Duration(0.01);
+    sleep_until(deadline);
+    EXPECT_GE(SteadyTime::now(), deadline);
+
+    Timer timer;
+    timer.start();
+    sleep_for(Duration(0.005));
+    timer.stop();
+    EXPECT_GE(timer.get(), Duration(0.005));
+    EXPECT_LT(timer.get(), Duration(0.1));
+
+    Rate rate(200.0);
+    const SteadyTime start = SteadyTime::now();
+    for (int i = 0; i < 5; i++) {
+        rate.sleep();
+    }
+    EXPECT_GE(SteadyTime::now() - start, Duration(0.02));
+}
+
+// Test that deadline scheduling does not accumulate wakeup latency as drift
+TEST(RateTest, DeadlineDoesNotDrift) {
+    constexpr int CYCLES = 100;
+    Rate rate(500.0);
+    EXPECT_EQ(rate.mode(), Rate::Mode::DEADLINE);
+    const SteadyTime start = SteadyTime::now();
+    for (int i = 0; i < CYCLES; i++) {
+        sleep_for(Duration(0.0005));  // Work
+        rate.sleep();
+    }
+    const Duration elapsed = SteadyTime::now() - start;
+    const auto &stats = rate.stats();
+    // Within one period of the ideal regardless of the number of cycles (a
+    // loaded machine may miss some deadlines, which are skipped)
+    const int periods = CYCLES + static_cast<int>(stats.missed);
+    EXPECT_GE(elapsed, Duration(0.002) * (periods - 1));
+    EXPECT_LT(elapsed, Duration(0.002) * (periods + 1));
+
+    EXPECT_EQ(stats.cycles, static_cast<uint64_t>(CYCLES));
+    EXPECT_LE(stats.overruns, static_cast<uint64_t>(CYCLES / 10));
+    uint64_t total = 0;
+    for (auto count : stats.histogram) {
+        total += count;
+    }
+    EXPECT_EQ(total, stats.cycles - stats.overruns);
+    EXPECT_LE(stats.mean_jitter(), stats.max_jitter);
+}
+
+// Test that an overrun is counted and the schedule keeps its phase
+TEST(RateTest, Overrun) {
+    Rate rate(Duration(0.01));
+    ASSERT_TRUE(rate.sleep());
+    const SteadyTime phase = SteadyTime::now();
+    sleep_for(Duration(0.035));  // Misses three deadlines
+    EXPECT_FALSE(rate.sleep());
+    EXPECT_TRUE(rate.sleep());
+    const Duration offset = SteadyTime::now() - phase;
+
+    const auto &stats = rate.stats();
+    EXPECT_EQ(stats.cycles, 3u);
+    EXPECT_EQ(stats.overruns, 1u);
+    // A loaded machine may oversleep past another deadline
+    EXPECT_GE(stats.missed, 2u);
+    // The wakeup after the overrun is on the original grid (40 ms after the
+    // first deadline unless more were missed). Both wakeups are late by at most
+    // the worst jitter
+    const Duration expected = Duration(0.01) * static_cast<int>(stats.missed + 2);
+    EXPECT_GE(offset, expected - stats.max_jitter);
+    EXPECT_LE(offset, expected + stats.max_jitter);
+
+    rate.reset();
+    EXPECT_EQ(rate.stats().cycles, 0u);
+}
+
+// Test that the spin window wakes up at the deadline
+TEST(RateTest, Spin) {
+    Rate rate(1000.0);
+    rate.set_spin(Duration(0.0002));
+    EXPECT_EQ(rate.spin(), Duration(0.0002));
+    for (int i = 0; i < 50; i++) {
+        rate.sleep();
+    }
+    const auto &stats = rate.stats();
+    EXPECT_EQ(stats.cycles, 50u);
+    // Generous bound for a loaded machine; typically a few microseconds
+    EXPECT_LT(stats.mean_jitter(), Duration(0.001));
+}
+
+// Test that relative mode starts each period when the previous sleep returned
+TEST(RateTest, Relative) {
+    Rate rate(Duration(0.005));
+    rate.set_mode(Rate::Mode::RELATIVE);
+    const SteadyTime start = SteadyTime::now();
+    for (int i = 0; i < 4; i++) {
+        sleep_for(Duration(0.002));
+        rate.sleep();
+    }
+    // Only a loaded machine stretches 2 ms of work past the period
+    EXPECT_LE(rate.stats().overruns, 1u);
+    EXPECT_GE(SteadyTime::now() - start, Duration(0.02));
+}
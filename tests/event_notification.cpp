@@ -0,0 +1,109 @@
+#include "rix/ipc/event_notification.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace rix::ipc;
+
+TEST(EventNotificationTest, TestConstructor) {
+    EventNotification notif;
+    EXPECT_TRUE(notif.ok());
+    EXPECT_GE(notif.fd(), 0);
+    EXPECT_EQ(notif.mode(), EventNotification::Mode::COUNTER);
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0)));
+    EXPECT_TRUE(notif.raise());
+    EXPECT_TRUE(notif.wait(rix::util::Duration(0)));
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0)));
+}
+
+TEST(EventNotificationTest, TestInitialValue) {
+    EventNotification notif(EventNotification::Mode::COUNTER, 3);
+    uint64_t value = 0;
+    EXPECT_TRUE(notif.wait(rix::util::Duration(0), value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0)));
+}
+
+TEST(EventNotificationTest, TestCounterMode) {
+    EventNotification notif;
+    EXPECT_TRUE(notif.raise());
+    EXPECT_TRUE(notif.raise());
+    EXPECT_TRUE(notif.post(5));
+    EXPECT_FALSE(notif.post(0));
+
+    uint64_t value = 0;
+    EXPECT_TRUE(notif.wait(rix::util::Duration(0), value));
+    EXPECT_EQ(value, 7);
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0)));
+}
+
+TEST(EventNotificationTest, TestSemaphoreMode) {
+    EventNotification notif(EventNotification::Mode::SEMAPHORE);
+    EXPECT_EQ(notif.mode(), EventNotification::Mode::SEMAPHORE);
+    EXPECT_TRUE(notif.post(3));
+
+    uint64_t value = 0;
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(notif.wait(rix::util::Duration(0), value));
+        EXPECT_EQ(value, 1);
+    }
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0)));
+}
+
+TEST(EventNotificationTest, TestCopySharesCounter) {
+    EventNotification notif;
+    EventNotification copy(notif);
+    EXPECT_TRUE(copy.ok());
+    EXPECT_NE(copy.fd(), notif.fd());
+
+    EXPECT_TRUE(copy.raise());
+    EXPECT_TRUE(notif.wait(rix::util::Duration(0)));
+    EXPECT_FALSE(copy.wait(rix::util::Duration(0)));
+
+    EventNotification assigned;
+    assigned = notif;
+    EXPECT_TRUE(notif.raise());
+    EXPECT_TRUE(assigned.wait(rix::util::Duration(0)));
+}
+
+TEST(EventNotificationTest, TestMove) {
+    EventNotification notif;
+    int fd = notif.fd();
+
+    EventNotification moved(std::move(notif));
+    EXPECT_FALSE(notif.ok());
+    EXPECT_FALSE(notif.raise()) << "EventNotification::raise should fail immediately when invalid.";
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0))) << "EventNotification::wait should fail immediately when invalid.";
+    EXPECT_TRUE(moved.ok());
+    EXPECT_EQ(moved.fd(), fd);
+
+    EventNotification assigned;
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved.ok());
+    EXPECT_EQ(assigned.fd(), fd);
+    EXPECT_TRUE(assigned.raise());
+    EXPECT_TRUE(assigned.wait(rix::util::Duration(0)));
+}
+
+TEST(EventNotificationTest, TestWaitNonzeroTimed) {
+    EventNotification notif;
+
+    rix::util::Duration wait_time(0);
+    bool status = false;
+    std::thread thr([&notif, &status, &wait_time]() {
+        rix::util::Timer timer;
+        timer.start();
+        status = notif.wait(rix::util::Duration(10));
+        timer.stop();
+        wait_time = timer.get();
+    });
+
+    rix::util::sleep_for(rix::util::Duration(0.2));
+
+    EXPECT_TRUE(notif.raise());
+    thr.join();
+    EXPECT_TRUE(status);
+    EXPECT_NEAR(wait_time.to_milliseconds(), 200, 100);
+    EXPECT_FALSE(notif.wait(rix::util::Duration(0)));
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "rix/ipc/fan_out.hpp"
+#include "rix/ipc/pipe.hpp"
+#include "rix/ipc/shm_ring.hpp"
+
+using namespace rix::ipc;
+
+namespace {
+
+std::shared_ptr<Pipe> share(Pipe &pipe) { return std::make_shared<Pipe>(std::move(pipe)); }
+
+std::string read_all(const interfaces::IO &io) {
+    std::string result;
+    std::vector<uint8_t> buffer(4096);
+    while (io.wait_for_readable(rix::util::Duration(0))) {
+        ssize_t n = io.read(buffer.data(), buffer.size());
+        if (n <= 0) break;
+        result.append(buffer.begin(), buffer.begin() + n);
+    }
+    return result;
+}
+
+// A sink that accepts `limit` bytes, then makes no progress
+class StalledSink : public interfaces::IO {
+   public:
+    explicit StalledSink(size_t limit) : limit(limit) {}
+
+    ssize_t read(uint8_t *, size_t) const override { return -1; }
+    ssize_t write(const uint8_t *, size_t len) const override {
+        const size_t n = std::min(len, limit - written);
+        written += n;
+        return static_cast<ssize_t>(n);
+    }
+    ssize_t readv(const struct iovec *, int) const override { return -1; }
+    ssize_t writev(const struct iovec *iov, int) const override {
+        return write(static_cast<const uint8_t *>(iov[0].iov_base), iov[0].iov_len);
+    }
+    bool wait_for_writable(const rix::util::Duration &) const override { return written < limit; }
+    bool wait_for_readable(const rix::util::Duration &) const override { return false; }
+    void set_nonblocking(bool) override {}
+    bool is_nonblocking() const override { return true; }
+
+    size_t limit;
+    mutable size_t written = 0;
+};
+
+}  // namespace
+
+// Test that FanOut is write-only and rejects writes without sinks
+TEST(FanOutTest, Empty) {
+    FanOut fan_out;
+    EXPECT_EQ(fan_out.size(), 0);
+    uint8_t byte = 0;
+    EXPECT_EQ(fan_out.read(&byte, 1), -1);
+    EXPECT_EQ(fan_out.write(&byte, 1), -1);
+    EXPECT_FALSE(fan_out.wait_for_readable(rix::util::Duration(0)));
+    EXPECT_FALSE(fan_out.wait_for_writable(rix::util::Duration(0)));
+    EXPECT_FALSE(fan_out.add(nullptr));
+}
+
+// Test that every frame reaches every pipe and non-pipe sink
+TEST(FanOutTest, WritesToAllSinks) {
+    auto a = Pipe::create();
+    auto b = Pipe::create();
+    auto [ring_reader, ring_writer] = ShmRing::create(4096);
+
+    FanOut fan_out;
+    ASSERT_TRUE(fan_out.add(share(a[1])));
+    ASSERT_TRUE(fan_out.add(share(b[1])));
+    ASSERT_TRUE(fan_out.add(std::make_shared<ShmRing>(std::move(ring_writer))));
+    EXPECT_EQ(fan_out.size(), 3);
+    EXPECT_TRUE(fan_out.wait_for_writable(rix::util::Duration(0)));
+
+    const std::string first = "frame one", second = "frame two";
+    ASSERT_EQ(fan_out.write(reinterpret_cast<const uint8_t *>(first.data()), first.size()), first.size());
+    struct iovec iov[2] = {{const_cast<char *>("frame "), 6}, {const_cast<char *>("two"), 3}};
+    ASSERT_EQ(fan_out.writev(iov, 2), second.size());
+
+    EXPECT_EQ(read_all(a[0]), first + second);
+    EXPECT_EQ(read_all(b[0]), first + second);
+    EXPECT_EQ(read_all(ring_reader), first + second);
+}
+
+// Test that large frames for several pipe sinks, which are sent with tee,
+// reach every sink intact
+TEST(FanOutTest, LargeFramesToManyPipes) {
+    auto a = Pipe::create(1 << 20);
+    auto b = Pipe::create(1 << 20);
+    auto c = Pipe::create(1 << 20);
+    FanOut fan_out;
+    fan_out.add(share(a[1]));
+    fan_out.add(share(b[1]));
+    fan_out.add(share(c[1]));
+
+    std::vector<uint8_t> frame(3 * FanOut::TEE_MIN_SIZE);
+    std::string expected;
+    for (int i = 0; i < 4; i++) {
+        std::iota(frame.begin(), frame.end(), static_cast<uint8_t>(i));
+        ASSERT_EQ(fan_out.write(frame.data(), frame.size()), frame.size());
+        expected.append(frame.begin(), frame.end());
+    }
+    EXPECT_EQ(read_all(a[0]), expected);
+    EXPECT_EQ(read_all(b[0]), expected);
+    EXPECT_EQ(read_all(c[0]), expected);
+}
+
+// Test that a full DROP sink loses whole frames without slowing the others
+TEST(FanOutTest, SlowSinkDropsFrames) {
+    auto slow = Pipe::create(4096);
+    auto fast = Pipe::create();
+    FanOut fan_out;
+    fan_out.add(share(slow[1]), FanOut::Policy::DROP);
+    fan_out.add(share(fast[1]), FanOut::Policy::DROP);
+
+    std::vector<uint8_t> frame(1000);
+    for (int i = 0; i < 20; i++) {
+        std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(i));
+        ASSERT_EQ(fan_out.write(frame.data(), frame.size()), frame.size());
+        std::vector<uint8_t> received(frame.size());
+        ASSERT_EQ(fast[0].read(received.data(), received.size()), received.size());
+        EXPECT_EQ(received, frame);
+    }
+    EXPECT_GT(fan_out.dropped(0), 0);
+    EXPECT_EQ(fan_out.dropped(1), 0);
+
+    // Every frame that reached the slow sink is whole
+    std::string data = read_all(slow[0]);
+    ASSERT_EQ(data.size() % frame.size(), 0);
+    EXPECT_EQ(data.size() / frame.size() + fan_out.dropped(0), 20);
+}
+
+// Test that a BUFFER sink catches up once its consumer reads
+TEST(FanOutTest, SlowSinkBuffersFrames) {
+    auto slow = Pipe::create(4096);
+    FanOut fan_out(64 * 1024);
+    fan_out.add(share(slow[1]), FanOut::Policy::BUFFER);
+
+    std::vector<uint8_t> data(20 * 1000);
+    std::iota(data.begin(), data.end(), 0);
+    for (int i = 0; i < 20; i++) {
+        ASSERT_EQ(fan_out.write(data.data() + i * 1000, 1000), 1000);
+    }
+    EXPECT_EQ(fan_out.dropped(0), 0);
+    EXPECT_GT(fan_out.buffered(0), 0);
+
+    std::vector<uint8_t> received;
+    std::vector<uint8_t> buffer(4096);
+    while (received.size() < data.size()) {
+        fan_out.flush();
+        ssize_t n = slow[0].read(buffer.data(), buffer.size());
+        ASSERT_GT(n, 0);
+        received.insert(received.end(), buffer.begin(), buffer.begin() + n);
+    }
+    EXPECT_TRUE(fan_out.flush());
+    EXPECT_EQ(received, data);
+}
+
+// Test that a sink whose reader has gone away is disabled
+TEST(FanOutTest, BrokenSinkDisabled) {
+    ::signal(SIGPIPE, SIG_IGN);
+    auto broken = Pipe::create();
+    auto healthy = Pipe::create();
+    FanOut fan_out;
+    fan_out.add(share(broken[1]));
+    fan_out.add(share(healthy[1]));
+    broken[0] = Pipe();
+
+    const std::string msg = "still here";
+    ASSERT_EQ(fan_out.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    EXPECT_FALSE(fan_out.enabled(0));
+    EXPECT_TRUE(fan_out.enabled(1));
+    EXPECT_EQ(read_all(healthy[0]), msg);
+    ::signal(SIGPIPE, SIG_DFL);
+}
+
+// Test that a sink whose write returns 0 keeps its data pending
+TEST(FanOutTest, StalledSinkKeepsPending) {
+    auto stalled = std::make_shared<StalledSink>(4);
+    FanOut fan_out;
+    fan_out.add(stalled, FanOut::Policy::BUFFER);
+
+    const std::string msg = "stalled";
+    ASSERT_EQ(fan_out.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    EXPECT_EQ(fan_out.buffered(0), msg.size() - 4);
+    EXPECT_FALSE(fan_out.flush());
+    ASSERT_EQ(fan_out.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    EXPECT_EQ(fan_out.buffered(0), 2 * msg.size() - 4);
+    EXPECT_TRUE(fan_out.enabled(0));
+
+    stalled->limit = 2 * msg.size();
+    EXPECT_TRUE(fan_out.flush());
+    EXPECT_EQ(fan_out.buffered(0), 0);
+}
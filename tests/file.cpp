@@ -139,3 +139,42 @@ TEST_F(FileTest, WaitForWritable) {
     EXPECT_TRUE(f.wait_for_writable(timeout));
     unlink(writable_file.c_str());
 }
+
+// Test scatter read
+TEST_F(FileTest, ReadvFile) {
+    File f(temp_filename, O_RDONLY);
+    std::vector<uint8_t> a(5), b(2), c(5);
+    struct iovec iov[3] = {{a.data(), a.size()}, {b.data(), b.size()}, {c.data(), c.size()}};
+    ssize_t bytes = f.readv(iov, 3);
+    ASSERT_EQ(bytes, 12);
+    EXPECT_EQ(std::string(a.begin(), a.end()), "Hello");
+    EXPECT_EQ(std::string(b.begin(), b.end()), ", ");
+    EXPECT_EQ(std::string(c.begin(), c.end()), "File!");
+}
+
+// Test gather write
+TEST_F(FileTest, WritevFile) {
+    std::string writable_file = "writev_test.tmp";
+    {
+        File f(writable_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        std::string header = "Write", payload = "vTest";
+        struct iovec iov[2] = {{header.data(), header.size()}, {payload.data(), payload.size()}};
+        EXPECT_EQ(f.writev(iov, 2), header.size() + payload.size());
+    }
+
+    std::ifstream in(writable_file);
+    std::string result;
+    in >> result;
+    EXPECT_EQ(result, "WritevTest");
+
+    unlink(writable_file.c_str());
+}
+
+// Test scatter-gather on an invalid file
+TEST_F(FileTest, ReadvWritevInvalid) {
+    File f;
+    uint8_t byte;
+    struct iovec iov = {&byte, 1};
+    EXPECT_EQ(f.readv(&iov, 1), -1);
+    EXPECT_EQ(f.writev(&iov, 1), -1);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "rix/ipc/framed_fifo.hpp"
+
+using namespace rix::ipc;
+
+class FramedFifoTest : public ::testing::Test {
+   protected:
+    std::string fifo_path = "/tmp/test_framed_fifo";
+
+    void SetUp() override { unlink(fifo_path.c_str()); }
+
+    void TearDown() override { unlink(fifo_path.c_str()); }
+};
+
+// Test default constructor
+TEST_F(FramedFifoTest, DefaultConstructor) {
+    FramedFifo fifo;
+    EXPECT_FALSE(fifo.ok());
+    uint8_t byte = 0;
+    EXPECT_EQ(fifo.write_frame(&byte, 1), -1);
+    FramedFifo::Frame frame;
+    EXPECT_FALSE(fifo.read_frame(frame));
+}
+
+// Test a single small frame
+TEST_F(FramedFifoTest, SingleFrame) {
+    FramedFifo reader(fifo_path, Fifo::Mode::READ);
+    FramedFifo writer(fifo_path, Fifo::Mode::WRITE, 42);
+    EXPECT_EQ(writer.producer_id(), 42);
+
+    const std::string msg = "framed";
+    ASSERT_EQ(writer.write_frame(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    ASSERT_EQ(writer.write_frame(nullptr, 0), 0);
+
+    FramedFifo::Frame frame;
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.producer, 42);
+    EXPECT_EQ(std::string(frame.data.begin(), frame.data.end()), msg);
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_TRUE(frame.data.empty());
+}
+
+// Test that open_existing only opens FIFOs that already exist
+TEST_F(FramedFifoTest, OpenExisting) {
+    errno = 0;
+    FramedFifo missing = FramedFifo::open_existing(fifo_path);
+    EXPECT_FALSE(missing.ok());
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_NE(access(fifo_path.c_str(), F_OK), 0);
+
+    FILE *file = fopen(fifo_path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    fclose(file);
+    FramedFifo regular = FramedFifo::open_existing(fifo_path);
+    EXPECT_FALSE(regular.ok());
+    EXPECT_EQ(errno, ENXIO);
+    unlink(fifo_path.c_str());
+
+    FramedFifo reader(fifo_path, Fifo::Mode::READ);
+    FramedFifo writer = FramedFifo::open_existing(fifo_path, 9);
+    ASSERT_TRUE(writer.ok());
+    EXPECT_EQ(writer.pathname(), fifo_path);
+    EXPECT_EQ(writer.mode(), Fifo::Mode::WRITE);
+    const std::string msg = "existing";
+    ASSERT_EQ(writer.write_frame(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    FramedFifo::Frame frame;
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.producer, 9);
+    EXPECT_EQ(std::string(frame.data.begin(), frame.data.end()), msg);
+}
+
+// Test that large frames are chunked or rejected
+TEST_F(FramedFifoTest, LargeFrames) {
+    FramedFifo reader(fifo_path, Fifo::Mode::READ);
+    FramedFifo writer(fifo_path, Fifo::Mode::WRITE, 1);
+    FramedFifo strict(fifo_path, Fifo::Mode::WRITE, 2, false, false);
+
+    std::vector<uint8_t> big(3 * FramedFifo::MAX_CHUNK_SIZE + 5);
+    std::iota(big.begin(), big.end(), 0);
+    EXPECT_EQ(strict.write_frame(big.data(), big.size()), -1);
+    EXPECT_EQ(errno, EMSGSIZE);
+    EXPECT_EQ(strict.write_frame(big.data(), FramedFifo::MAX_CHUNK_SIZE), FramedFifo::MAX_CHUNK_SIZE);
+
+    std::thread producer([&]() { EXPECT_EQ(writer.write_frame(big.data(), big.size()), big.size()); });
+    FramedFifo::Frame frame;
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.producer, 2);
+    EXPECT_EQ(frame.data.size(), FramedFifo::MAX_CHUNK_SIZE);
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.producer, 1);
+    EXPECT_EQ(frame.data, big);
+    producer.join();
+}
+
+// Test that a frame left unfinished by a producer that died is replaced by
+// the next frame with the same producer id
+TEST_F(FramedFifoTest, AbandonedPartialFrame) {
+    FramedFifo reader(fifo_path, Fifo::Mode::READ);
+    {
+        // The first chunk of a 100-byte frame whose writer never finishes it
+        Fifo dead(fifo_path, Fifo::Mode::WRITE);
+        std::vector<uint8_t> chunk(FramedFifo::HEADER_SIZE + 10, 0xee);
+        const uint32_t producer = 9, size = 100;
+        const uint16_t length = 10, flags = FramedFifo::FIRST | FramedFifo::MORE;
+        std::memcpy(chunk.data(), &producer, 4);
+        std::memcpy(chunk.data() + 4, &size, 4);
+        std::memcpy(chunk.data() + 8, &length, 2);
+        std::memcpy(chunk.data() + 10, &flags, 2);
+        ASSERT_EQ(dead.write(chunk.data(), chunk.size()), chunk.size());
+    }
+    FramedFifo writer(fifo_path, Fifo::Mode::WRITE, 9);
+    std::vector<uint8_t> big(2 * FramedFifo::MAX_CHUNK_SIZE);
+    std::iota(big.begin(), big.end(), 0);
+    const std::string msg = "restarted";
+    ASSERT_EQ(writer.write_frame(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    std::thread producer([&]() { EXPECT_EQ(writer.write_frame(big.data(), big.size()), big.size()); });
+
+    FramedFifo::Frame frame;
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.producer, 9);
+    EXPECT_EQ(std::string(frame.data.begin(), frame.data.end()), msg);
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.data, big);
+    producer.join();
+}
+
+// Test that malformed chunks from one producer do not stop the reader
+TEST_F(FramedFifoTest, MalformedChunksSkipped) {
+    FramedFifo reader(fifo_path, Fifo::Mode::READ);
+    Fifo raw(fifo_path, Fifo::Mode::WRITE);
+    auto write_chunk = [&](uint32_t producer, uint32_t size, uint16_t length, uint16_t flags) {
+        std::vector<uint8_t> chunk(FramedFifo::HEADER_SIZE + length, 0xee);
+        std::memcpy(chunk.data(), &producer, 4);
+        std::memcpy(chunk.data() + 4, &size, 4);
+        std::memcpy(chunk.data() + 8, &length, 2);
+        std::memcpy(chunk.data() + 10, &flags, 2);
+        ASSERT_EQ(raw.write(chunk.data(), chunk.size()), chunk.size());
+    };
+    // A continuation whose first chunk was never written
+    write_chunk(5, 100, 10, 0);
+    // A single-chunk frame shorter than its size
+    write_chunk(5, 100, 10, FramedFifo::FIRST);
+    // A frame that grows past its size
+    write_chunk(5, 15, 10, FramedFifo::FIRST | FramedFifo::MORE);
+    write_chunk(5, 15, 10, FramedFifo::MORE);
+
+    FramedFifo writer(fifo_path, Fifo::Mode::WRITE, 6);
+    const std::string msg = "still readable";
+    ASSERT_EQ(writer.write_frame(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+
+    FramedFifo::Frame frame;
+    ASSERT_TRUE(reader.read_frame(frame));
+    EXPECT_EQ(frame.producer, 6);
+    EXPECT_EQ(std::string(frame.data.begin(), frame.data.end()), msg);
+    EXPECT_EQ(reader.malformed(), 3u);
+}
+
+// Test non-blocking reads with no complete frame
+TEST_F(FramedFifoTest, NonBlockingRead) {
+    FramedFifo reader(fifo_path, Fifo::Mode::READ, 0, true);
+    FramedFifo::Frame frame;
+    EXPECT_FALSE(reader.read_frame(frame));
+    EXPECT_EQ(errno, EAGAIN);
+}
+
+// Test many concurrent producers writing chunked frames to one reader
+TEST_F(FramedFifoTest, ManyProducersFanIn) {
+    constexpr int producers = 4;
+    constexpr int frames_per_producer = 50;
+    FramedFifo reader(fifo_path, Fifo::Mode::READ);
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < producers; p++) {
+        pid_t pid = ::fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            FramedFifo writer(fifo_path, Fifo::Mode::WRITE, p + 1);
+            bool ok = true;
+            for (int i = 0; i < frames_per_producer; i++) {
+                // Alternate small and multi-chunk frames
+                std::vector<uint8_t> frame((i % 2) ? 10000 : 100, static_cast<uint8_t>(i));
+                ok = ok && writer.write_frame(frame.data(), frame.size()) == static_cast<ssize_t>(frame.size());
+            }
+            ::_exit(ok ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+
+    std::map<uint32_t, int> next;
+    for (int n = 0; n < producers * frames_per_producer; n++) {
+        FramedFifo::Frame frame;
+        ASSERT_TRUE(reader.read_frame(frame));
+        ASSERT_GE(frame.producer, 1);
+        ASSERT_LE(frame.producer, producers);
+        int i = next[frame.producer]++;
+        ASSERT_EQ(frame.data.size(), (i % 2) ? 10000 : 100);
+        for (uint8_t byte : frame.data) {
+            ASSERT_EQ(byte, static_cast<uint8_t>(i)) << "Frame from producer " << frame.producer << " was torn.";
+        }
+    }
+    for (pid_t pid : children) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "rix/ipc/intra_channel.hpp"
+#include "rix/msg/geometry/Twist2DStamped.hpp"
+
+using namespace rix::ipc;
+using rix::msg::geometry::Twist2DStamped;
+using Channel = IntraChannel<Twist2DStamped>;
+
+namespace {
+
+std::shared_ptr<const Twist2DStamped> make_twist(uint32_t seq, double vx) {
+    auto msg = std::make_shared<Twist2DStamped>();
+    msg->header.seq = seq;
+    msg->twist.vx = vx;
+    return msg;
+}
+
+}  // namespace
+
+// Test default constructor
+TEST(IntraChannelTest, DefaultConstructor) {
+    Channel channel;
+    EXPECT_FALSE(channel.ok());
+    EXPECT_FALSE(channel.push(make_twist(0, 0)));
+    EXPECT_EQ(errno, EBADF);
+    std::shared_ptr<const Twist2DStamped> msg;
+    EXPECT_FALSE(channel.pop(msg));
+}
+
+// Test that the same object is passed through without copies
+TEST(IntraChannelTest, PushPopSharesMessage) {
+    auto [reader, writer] = Channel::create(4);
+    ASSERT_TRUE(reader.ok());
+    EXPECT_EQ(reader.mode(), Channel::Mode::READ);
+    EXPECT_EQ(writer.mode(), Channel::Mode::WRITE);
+    EXPECT_EQ(writer.capacity(), 4);
+
+    auto sent = make_twist(1, 0.5);
+    ASSERT_TRUE(writer.push(sent));
+    EXPECT_EQ(reader.size(), 1);
+
+    std::shared_ptr<const Twist2DStamped> received;
+    ASSERT_TRUE(reader.pop(received));
+    EXPECT_EQ(received.get(), sent.get());
+    EXPECT_FALSE(reader.pop(received));
+    EXPECT_EQ(errno, EAGAIN);
+
+    EXPECT_FALSE(writer.pop(received)) << "The write end should not be readable.";
+    EXPECT_FALSE(reader.push(sent)) << "The read end should not be writable.";
+}
+
+// Test a full channel and closed ends
+TEST(IntraChannelTest, FullAndClosed) {
+    auto [reader, writer] = Channel::create(2);
+    EXPECT_TRUE(writer.push(make_twist(0, 0)));
+    EXPECT_TRUE(writer.push(make_twist(1, 0)));
+    EXPECT_FALSE(writer.push(make_twist(2, 0)));
+    EXPECT_EQ(errno, EAGAIN);
+    EXPECT_FALSE(writer.wait_for_writable(rix::util::Duration(0.01)));
+
+    { Channel closed(std::move(writer)); }
+    EXPECT_TRUE(reader.closed());
+    std::shared_ptr<const Twist2DStamped> msg;
+    EXPECT_TRUE(reader.pop(msg));
+    EXPECT_TRUE(reader.pop(msg));
+    EXPECT_FALSE(reader.pop(msg));
+    EXPECT_EQ(errno, 0) << "An empty channel with a closed writer is at end of stream.";
+
+    auto [reader2, writer2] = Channel::create(2);
+    { Channel closed(std::move(reader2)); }
+    EXPECT_FALSE(writer2.push(make_twist(0, 0)));
+    EXPECT_EQ(errno, EPIPE);
+}
+
+// Test a blocking consumer on another thread
+TEST(IntraChannelTest, CrossThread) {
+    auto [reader, writer] = Channel::create(8);
+    constexpr uint32_t count = 10000;
+
+    std::thread producer([&writer]() {
+        for (uint32_t i = 0; i < count; i++) {
+            auto msg = make_twist(i, i);
+            while (!writer.push(msg)) {
+                ASSERT_EQ(errno, EAGAIN);
+                writer.wait_for_writable(rix::util::Duration(1.0));
+            }
+        }
+    });
+
+    std::shared_ptr<const Twist2DStamped> msg;
+    for (uint32_t i = 0; i < count; i++) {
+        while (!reader.pop(msg)) {
+            ASSERT_EQ(errno, EAGAIN);
+            reader.wait_for_readable(rix::util::Duration(1.0));
+        }
+        ASSERT_EQ(msg->header.seq, i);
+    }
+    producer.join();
+}
+
+// Test the serialized byte stream fallback in both directions
+TEST(IntraChannelTest, ByteStreamFallback) {
+    auto [reader, writer] = Channel::create(8);
+
+    Twist2DStamped twist;
+    twist.header.seq = 7;
+    twist.twist.wz = 1.5;
+    const uint32_t n = twist.size();
+    std::vector<uint8_t> frame(4 + n);
+    size_t offset = 0;
+    rix::msg::detail::serialize_number<uint32_t>(frame.data(), offset, n);
+    twist.serialize(frame.data(), offset);
+
+    // Split the frame across two writes
+    ASSERT_EQ(writer.write(frame.data(), 3), 3);
+    EXPECT_EQ(reader.size(), 0);
+    ASSERT_EQ(writer.write(frame.data() + 3, frame.size() - 3), frame.size() - 3);
+    ASSERT_EQ(reader.size(), 1);
+    std::shared_ptr<const Twist2DStamped> msg;
+    ASSERT_TRUE(reader.pop(msg));
+    EXPECT_EQ(msg->header.seq, 7);
+    EXPECT_EQ(msg->twist.wz, 1.5);
+
+    ASSERT_TRUE(writer.push(make_twist(7, 0)));
+    std::vector<uint8_t> bytes(frame.size());
+    size_t got = 0;
+    while (got < bytes.size()) {
+        ssize_t r = reader.read(bytes.data() + got, bytes.size() - got);
+        ASSERT_GT(r, 0);
+        got += r;
+    }
+    Twist2DStamped decoded;
+    offset = 4;
+    ASSERT_TRUE(decoded.deserialize(bytes.data(), bytes.size(), offset));
+    EXPECT_EQ(decoded.header.seq, 7);
+
+    reader.set_nonblocking(true);
+    uint8_t byte;
+    EXPECT_EQ(reader.read(&byte, 1), -1);
+    EXPECT_EQ(errno, EAGAIN);
+}
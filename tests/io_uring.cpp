@@ -0,0 +1,153 @@
+#include "rix/ipc/io_uring.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rix/ipc/fifo.hpp"
+#include "rix/ipc/pipe.hpp"
+
+using namespace rix::ipc;
+
+class IOUringTest : public ::testing::Test {
+   protected:
+    std::string temp_filename = "/tmp/test_io_uring.tmp";
+
+    void SetUp() override {
+        std::ofstream(temp_filename) << "Hello, io_uring!";
+        ring = IOUring(16);
+        if (!ring.ok()) {
+            GTEST_SKIP() << "io_uring is not available on this system.";
+        }
+    }
+
+    void TearDown() override { unlink(temp_filename.c_str()); }
+
+    IOUring ring{0};
+};
+
+// Test default construction state
+TEST(IOUringInvalidTest, ZeroEntries) {
+    IOUring ring(0);
+    EXPECT_FALSE(ring.ok());
+    uint8_t buf[4];
+    EXPECT_FALSE(ring.prepare_read(File(), buf, sizeof(buf), 0));
+    EXPECT_EQ(ring.submit(), -1);
+}
+
+// Test reading a regular file at an explicit offset
+TEST_F(IOUringTest, ReadFile) {
+    File f(temp_filename, O_RDONLY);
+    std::vector<uint8_t> buffer(8);
+    ASSERT_TRUE(ring.prepare_read(f, buffer.data(), buffer.size(), 42, 7));
+    EXPECT_EQ(ring.pending(), 1);
+    EXPECT_EQ(ring.submit(), 1);
+    EXPECT_EQ(ring.pending(), 0);
+
+    IOUring::Completion c;
+    ASSERT_TRUE(ring.wait(c, rix::util::Duration(1.0)));
+    EXPECT_EQ(c.user_data, 42);
+    ASSERT_EQ(c.result, 8);
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), "io_uring");
+}
+
+// Test that multiple requests are submitted with a single call
+TEST_F(IOUringTest, BatchedPipeWrites) {
+    auto [reader, writer] = Pipe::create();
+    const std::string a = "first ", b = "second";
+    ASSERT_TRUE(ring.prepare_write(writer, reinterpret_cast<const uint8_t *>(a.data()), a.size(), 1));
+    ASSERT_TRUE(ring.prepare_write(writer, reinterpret_cast<const uint8_t *>(b.data()), b.size(), 2));
+    EXPECT_EQ(ring.submit(2), 2);
+
+    std::vector<IOUring::Completion> completions;
+    EXPECT_EQ(ring.peek(completions), 2);
+    ASSERT_EQ(completions.size(), 2);
+    for (const auto &c : completions) {
+        EXPECT_EQ(c.result, c.user_data == 1 ? a.size() : b.size());
+    }
+
+    std::vector<uint8_t> buffer(a.size() + b.size());
+    ASSERT_EQ(reader.read(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), a + b);
+}
+
+// Test that wait times out when nothing completes
+TEST_F(IOUringTest, WaitTimesOut) {
+    auto [reader, writer] = Pipe::create();
+    uint8_t byte;
+    ASSERT_TRUE(ring.prepare_read(reader, &byte, 1, 7));
+
+    IOUring::Completion c;
+    EXPECT_FALSE(ring.wait(c, rix::util::Duration(0.05)));
+
+    // Completing the read releases the outstanding request
+    uint8_t value = 0xAB;
+    writer.write(&value, 1);
+    ASSERT_TRUE(ring.wait(c, rix::util::Duration(1.0)));
+    EXPECT_EQ(c.user_data, 7);
+    EXPECT_EQ(c.result, 1);
+    EXPECT_EQ(byte, 0xAB);
+}
+
+// Test fixed files and registered buffers with a Fifo
+TEST_F(IOUringTest, FixedFilesAndBuffers) {
+    const std::string path = "/tmp/test_io_uring_fifo";
+    Fifo fifo(path, Fifo::Mode::READ);
+    ASSERT_TRUE(fifo.ok());
+
+    std::vector<uint8_t> out_buffer = {'f', 'i', 'x', 'e', 'd'};
+    std::vector<uint8_t> in_buffer(out_buffer.size());
+    ASSERT_TRUE(ring.register_files({&fifo}));
+    ASSERT_TRUE(ring.register_buffers({{out_buffer.data(), out_buffer.size()}, {in_buffer.data(), in_buffer.size()}}));
+
+    ASSERT_TRUE(ring.prepare_write_fixed(0, out_buffer.data(), out_buffer.size(), 0, 1));
+    EXPECT_EQ(ring.submit(1), 1);
+    IOUring::Completion c;
+    ASSERT_TRUE(ring.wait(c, rix::util::Duration(1.0)));
+    EXPECT_EQ(c.user_data, 1);
+    EXPECT_EQ(c.result, out_buffer.size());
+
+    ASSERT_TRUE(ring.prepare_read_fixed(0, in_buffer.data(), in_buffer.size(), 1, 2));
+    ASSERT_TRUE(ring.wait(c, rix::util::Duration(1.0)));
+    EXPECT_EQ(c.user_data, 2);
+    EXPECT_EQ(c.result, in_buffer.size());
+    EXPECT_EQ(in_buffer, out_buffer);
+
+    EXPECT_TRUE(ring.unregister_buffers());
+    EXPECT_TRUE(ring.unregister_files());
+    EXPECT_FALSE(ring.prepare_read_fixed(0, in_buffer.data(), in_buffer.size(), -1, 3));
+    File::remove(path);
+}
+
+// Test that a full submission queue is reported
+TEST_F(IOUringTest, SubmissionQueueFull) {
+    File f(temp_filename, O_RDONLY);
+    uint8_t buf[1];
+    unsigned queued = 0;
+    while (ring.prepare_read(f, buf, 1, queued, 0)) {
+        queued++;
+        ASSERT_LE(queued, 1024);
+    }
+    EXPECT_GE(queued, 16);
+    EXPECT_EQ(ring.submit(queued), queued);
+    std::vector<IOUring::Completion> completions;
+    EXPECT_EQ(ring.peek(completions), queued);
+}
+
+// Test move construction
+TEST_F(IOUringTest, MoveConstructor) {
+    int fd = ring.fd();
+    IOUring moved(std::move(ring));
+    EXPECT_FALSE(ring.ok());
+    EXPECT_TRUE(moved.ok());
+    EXPECT_EQ(moved.fd(), fd);
+
+    File f(temp_filename, O_RDONLY);
+    uint8_t buf[5];
+    ASSERT_TRUE(moved.prepare_read(f, buf, sizeof(buf), 9, 0));
+    IOUring::Completion c;
+    ASSERT_TRUE(moved.wait(c, rix::util::Duration(1.0)));
+    EXPECT_EQ(c.result, 5);
+}
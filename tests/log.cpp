@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rix/util/log.hpp"
+
+using namespace rix::util;
+
+namespace {
+
+size_t count(const std::string &text, const std::string &pattern) {
+    size_t n = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        n++;
+    }
+    return n;
+}
+
+}  // namespace
+
+class LogTest : public ::testing::Test {
+   protected:
+    // Log outputs can only be added, so every test shares one
+    inline static std::stringstream output;
+
+    static void SetUpTestSuite() { Log::add_output(output.rdbuf()); }
+
+    void SetUp() override { output.str(""); }
+
+    void TearDown() override {
+        Log::stop_async();
+        Log::set_level(static_cast<Log::Level>(RIX_UTIL_LOG_LEVEL));
+    }
+};
+
+// Test that synchronous logging writes the header and message
+TEST_F(LogTest, Synchronous) {
+    EXPECT_FALSE(Log::is_async());
+    Log::info << "sync message " << 42 << std::endl;
+    Log::debug << "below the compile-time level" << std::endl;
+
+    const std::string text = output.str();
+    EXPECT_NE(text.find("INFO"), std::string::npos);
+    EXPECT_NE(text.find("sync message 42\n"), std::string::npos);
+    EXPECT_EQ(text.find("below the compile-time level"), std::string::npos);
+}
+
+// Test that RIX_LOG does not evaluate the arguments of disabled levels
+TEST_F(LogTest, MacroSkipsDisabledLevels) {
+    int evaluated = 0;
+    auto argument = [&evaluated]() { return ++evaluated; };
+
+    RIX_LOG(DEBUG) << "compiled out " << argument() << std::endl;
+    RIX_LOG(INFO) << "enabled " << argument() << std::endl;
+    EXPECT_EQ(evaluated, 1);
+
+    Log::set_level(Log::Level::WARN);
+    EXPECT_EQ(Log::get_level(), Log::Level::WARN);
+    EXPECT_FALSE(Log::enabled(Log::Level::INFO));
+    RIX_LOG(INFO) << "disabled at runtime " << argument() << std::endl;
+    Log::info << "disabled stream " << 7 << std::endl;
+    RIX_LOG(ERROR) << "still enabled " << argument() << std::endl;
+    EXPECT_EQ(evaluated, 2);
+
+    // The runtime level can not enable a level that is compiled out
+    Log::set_level(Log::Level::DEBUG);
+    EXPECT_FALSE(Log::enabled(Log::Level::DEBUG));
+    RIX_LOG(DEBUG) << "compiled out " << argument() << std::endl;
+    EXPECT_EQ(evaluated, 2);
+
+    const std::string text = output.str();
+    EXPECT_NE(text.find("enabled 1\n"), std::string::npos);
+    EXPECT_NE(text.find("still enabled 2\n"), std::string::npos);
+    EXPECT_EQ(text.find("disabled"), std::string::npos);
+    EXPECT_EQ(text.find("compiled out"), std::string::npos);
+}
+
+// Test that asynchronous records from several threads are all written
+TEST_F(LogTest, AsynchronousThreads) {
+    Log::start_async();
+    ASSERT_TRUE(Log::is_async());
+    const size_t dropped = Log::dropped();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 100; i++) {
+                Log::warn << "thread " << t << " record " << i << std::endl;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    Log::stop_async();
+    EXPECT_FALSE(Log::is_async());
+
+    const std::string text = output.str();
+    EXPECT_EQ(count(text, "WARN") + (Log::dropped() - dropped), 400);
+    EXPECT_NE(text.find("thread 3 record 99\n"), std::string::npos);
+}
+
+// Test how records are ended
+TEST_F(LogTest, AsynchronousRecordBoundaries) {
+    Log::start_async();
+    Log::error << "first";
+    Log::error << "second\n";
+    Log::error << "third" << std::flush;
+    Log::error << "fourth";
+    Log::stop_async();
+
+    const std::string text = output.str();
+    EXPECT_EQ(count(text, "ERROR"), 4);
+    EXPECT_NE(text.find("first"), std::string::npos);
+    EXPECT_NE(text.find("fourth"), std::string::npos);
+    EXPECT_LT(text.find("first"), text.find("second"));
+    EXPECT_LT(text.find("third"), text.find("fourth"));
+}
+
+// Test that a full ring drops records instead of blocking
+TEST_F(LogTest, AsynchronousDropsWhenFull) {
+    const size_t dropped = Log::dropped();
+    Log::start_async(64);
+    std::thread logger([]() {
+        const std::string big(100, 'x');
+        Log::info << big << std::endl;
+    });
+    logger.join();
+    Log::stop_async();
+    EXPECT_EQ(Log::dropped(), dropped + 1);
+}
+
+// Test that pending records are written at exit without stop_async
+TEST_F(LogTest, AsynchronousStopsAtExit) {
+    testing::FLAGS_gtest_death_test_style = "threadsafe";
+    EXPECT_EXIT(
+        {
+            Log::add_output(std::cerr.rdbuf());
+            Log::start_async();
+            Log::info << "record before exit" << std::endl;
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0), "record before exit");
+}
+
+// Test the cached header time field against Time::to_string
+TEST(HeaderFormatterTest, MatchesTimeToString) {
+    detail::HeaderFormatter formatter;
+    const int64_t day = 86'400'000'000'000;
+    EXPECT_EQ(formatter.format(day + 1'000'042'000, "x"), "[01/02/70 00:00:01.000042 GMT] x");
+    EXPECT_EQ(formatter.format(day + 1'999'999'999, ""), "[01/02/70 00:00:01.999999 GMT] ");
+    EXPECT_EQ(formatter.format(day + 2'000'000'000, ""), "[01/02/70 00:00:02.000000 GMT] ");
+
+    Time now = Time::now();
+    const std::string expected = "[" + now.to_string() + "] ";
+    EXPECT_EQ(formatter.format(now.to_nanoseconds(), ""), expected);
+}
+
+TEST_F(LogTest, HeaderFormat) {
+    Log::info << "formatted" << std::endl;
+    const std::string text = output.str();
+    ASSERT_GE(text.size(), 31);
+    EXPECT_EQ(text[0], '[');
+    EXPECT_EQ(text[18], '.');
+    EXPECT_EQ(text.substr(25, 6), " GMT] ");
+    EXPECT_NE(text.find("formatted\n"), std::string::npos);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rix/ipc/mapped_file.hpp"
+#include "rix/msg/standard/UInt32.hpp"
+
+using namespace rix::ipc;
+
+class MappedFileTest : public ::testing::Test {
+   protected:
+    std::string temp_filename = "/tmp/test_mapped_file.tmp";
+
+    void SetUp() override { std::ofstream(temp_filename) << "Hello, MappedFile!"; }
+
+    void TearDown() override { unlink(temp_filename.c_str()); }
+};
+
+// Test default constructor
+TEST_F(MappedFileTest, DefaultConstructor) {
+    MappedFile f;
+    EXPECT_FALSE(f.ok());
+    EXPECT_TRUE(f.data().empty());
+    EXPECT_FALSE(f.resize(16));
+}
+
+// Test read-only mapping of an existing file
+TEST_F(MappedFileTest, ReadOnlyMapping) {
+    MappedFile f(temp_filename, MappedFile::Mode::READ);
+    ASSERT_TRUE(f.ok());
+    EXPECT_EQ(f.mode(), MappedFile::Mode::READ);
+    auto bytes = f.data();
+    ASSERT_EQ(bytes.size(), 18);
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()), "Hello, MappedFile!");
+    EXPECT_TRUE(f.writable_data().empty()) << "A read-only mapping cannot be written.";
+    EXPECT_FALSE(f.resize(64)) << "A read-only mapping cannot be resized.";
+    EXPECT_TRUE(f.advise(MappedFile::Advice::SEQUENTIAL));
+    EXPECT_TRUE(f.advise(MappedFile::Advice::WILLNEED, 7, 4));
+}
+
+// Test that a missing file is not mapped
+TEST_F(MappedFileTest, MissingFile) {
+    MappedFile f("/tmp/does_not_exist_mapped_file.tmp", MappedFile::Mode::READ);
+    EXPECT_FALSE(f.ok());
+}
+
+// Test writes through the mapping, growth and shrinking
+TEST_F(MappedFileTest, ReadWriteResize) {
+    const std::string path = "/tmp/test_mapped_file_rw.tmp";
+    unlink(path.c_str());
+    {
+        MappedFile f(path, MappedFile::Mode::READ_WRITE, 4);
+        ASSERT_TRUE(f.ok());
+        ASSERT_EQ(f.size(), 4);
+        std::memcpy(f.writable_data().data(), "abcd", 4);
+
+        // Grow well past the original page so the mapping may have to move
+        ASSERT_TRUE(f.resize(1 << 20));
+        EXPECT_EQ(f.size(), 1 << 20);
+        EXPECT_EQ(std::string(f.data().begin(), f.data().begin() + 4), "abcd");
+        f.writable_data()[(1 << 20) - 1] = 'z';
+        EXPECT_TRUE(f.sync());
+
+        ASSERT_TRUE(f.resize(2));
+        EXPECT_EQ(f.size(), 2);
+        EXPECT_TRUE(f.sync(false));
+    }
+    std::ifstream in(path);
+    std::string contents;
+    in >> contents;
+    EXPECT_EQ(contents, "ab");
+    unlink(path.c_str());
+}
+
+// Test that remap picks up data appended by another writer
+TEST_F(MappedFileTest, RemapAfterAppend) {
+    MappedFile f(temp_filename, MappedFile::Mode::READ);
+    ASSERT_EQ(f.size(), 18);
+    std::ofstream(temp_filename, std::ios::app) << " More";
+    ASSERT_TRUE(f.remap());
+    EXPECT_EQ(std::string(f.data().begin(), f.data().end()), "Hello, MappedFile! More");
+}
+
+// Test huge page alignment request
+TEST_F(MappedFileTest, HugePageAlignment) {
+    const std::string path = "/tmp/test_mapped_file_huge.tmp";
+    unlink(path.c_str());
+    MappedFile f(path, MappedFile::Mode::READ_WRITE, 4 << 20, true);
+    ASSERT_TRUE(f.ok());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(f.data().data()) % (2 << 20), 0);
+    f.writable_data()[0] = 1;
+    EXPECT_EQ(f.data()[0], 1);
+    unlink(path.c_str());
+}
+
+// Test deserializing messages directly from the mapping
+TEST_F(MappedFileTest, DeserializeInPlace) {
+    const std::string path = "/tmp/test_mapped_file_msgs.tmp";
+    unlink(path.c_str());
+    {
+        std::vector<uint8_t> buffer;
+        for (uint32_t i = 0; i < 100; i++) {
+            rix::msg::standard::UInt32 msg;
+            msg.data = i;
+            size_t offset = buffer.size();
+            buffer.resize(offset + msg.size());
+            msg.serialize(buffer.data(), offset);
+        }
+        File out(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT_EQ(out.write(buffer.data(), buffer.size()), buffer.size());
+    }
+
+    MappedFile f(path, MappedFile::Mode::READ);
+    ASSERT_TRUE(f.ok());
+    auto bytes = f.data();
+    size_t offset = 0;
+    uint32_t expected = 0;
+    rix::msg::standard::UInt32 msg;
+    while (offset < bytes.size() && msg.deserialize(bytes.data(), bytes.size(), offset)) {
+        EXPECT_EQ(msg.data, expected++);
+    }
+    EXPECT_EQ(expected, 100);
+    unlink(path.c_str());
+}
+
+// Test move
+TEST_F(MappedFileTest, Move) {
+    MappedFile f(temp_filename, MappedFile::Mode::READ);
+    const uint8_t *addr = f.data().data();
+    MappedFile moved(std::move(f));
+    EXPECT_FALSE(f.ok());
+    EXPECT_TRUE(f.data().empty());
+    EXPECT_EQ(moved.data().data(), addr);
+
+    MappedFile assigned;
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved.ok());
+    EXPECT_EQ(assigned.data().data(), addr);
+}
@@ -3,6 +3,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <thread>
+
+#include "rix/ipc/event_notification.hpp"
+#include "rix/ipc/pipe.hpp"
 #include "mocks/mock_io.hpp"
 #include "mocks/mock_mbot.hpp"
 #include "mocks/mock_notification.hpp"
@@ -77,6 +81,33 @@ TEST(MBotDriverTest, TranslatesDriveCommandsAndExitsOnEOF) {
     twist_equal(mbot_ptr->twists[3].twist, {});
 }
 
+TEST(MBotDriverTest, PopsFromIntraChannelAndExitsWhenWriterCloses) {
+    using Channel = rix::ipc::IntraChannel<rix::msg::geometry::Twist2DStamped>;
+    auto [reader, writer] = Channel::create(8);
+
+    auto twist1 = std::make_shared<rix::msg::geometry::Twist2DStamped>();
+    twist1->twist.vx = 1.0f;
+    twist1->twist.vy = 2.0f;
+    twist1->twist.wz = 3.0f;
+    auto twist2 = std::make_shared<rix::msg::geometry::Twist2DStamped>();
+    twist2->twist.vx = 4.0f;
+    ASSERT_TRUE(writer.push(twist1));
+    ASSERT_TRUE(writer.push(twist2));
+    { Channel closed(std::move(writer)); }
+
+    auto input = std::make_unique<Channel>(std::move(reader));
+    auto mbot = std::make_unique<testing::NiceMock<MockMBot>>();
+    auto *mbot_ptr = mbot.get(); // Need to get raw pointer for inspection
+
+    auto mbot_driver = std::make_unique<MBotDriver>(std::move(input), std::move(mbot));
+    mbot_driver->spin(std::make_unique<testing::NiceMock<MockNotification>>());
+
+    ASSERT_EQ(mbot_ptr->twists.size(), 3);
+    twist_equal(mbot_ptr->twists[0].twist, twist1->twist);
+    twist_equal(mbot_ptr->twists[1].twist, twist2->twist);
+    twist_equal(mbot_ptr->twists[2].twist, {});
+}
+
 TEST(MBotDriverTest, TranslatesDriveCommandsAndExitsOnNotification) {
     rix::msg::geometry::Twist2DStamped twist1;
     twist1.header.frame_id = "mbot_one";
@@ -120,4 +151,26 @@ TEST(MBotDriverTest, TranslatesDriveCommandsAndExitsOnNotification) {
     twist_equal(mbot_ptr->twists[0].twist, twist1.twist);
     twist_equal(mbot_ptr->twists[1].twist, twist2.twist);
     twist_equal(mbot_ptr->twists[2].twist, {});
-}
\ No newline at end of file
+}
+
+TEST(MBotDriverTest, ExitsOnEventNotificationFromAnotherThread) {
+    auto [reader, writer] = rix::ipc::Pipe::create();
+    auto input = std::make_unique<rix::ipc::Pipe>(std::move(reader));
+
+    auto mbot = std::make_unique<testing::NiceMock<MockMBot>>();
+    auto *mbot_ptr = mbot.get(); // Need to get raw pointer for inspection
+
+    rix::ipc::EventNotification shutdown;
+    auto notif = std::make_unique<rix::ipc::EventNotification>(shutdown);
+    auto mbot_driver = std::make_unique<MBotDriver>(std::move(input), std::move(mbot));
+
+    std::thread stopper([&shutdown]() {
+        rix::util::sleep_for(rix::util::Duration(0.05));
+        shutdown.raise();
+    });
+    mbot_driver->spin(std::move(notif));
+    stopper.join();
+
+    ASSERT_EQ(mbot_ptr->twists.size(), 1);
+    twist_equal(mbot_ptr->twists[0].twist, {});
+}
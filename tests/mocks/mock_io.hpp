@@ -8,7 +8,7 @@
 
 class MockIO : public rix::ipc::interfaces::IO {
    public:
-    MockIO() : write_end_open(true), read_end_open(true) {
+    MockIO() : nonblocking(false), write_end_open(true), read_end_open(true) {
         ON_CALL(*this, read).WillByDefault([this](uint8_t *dst, size_t len) -> ssize_t {
             size_t p = buffer.size();
             // Simulate the behavior of a POSIX FIFO
@@ -40,6 +40,31 @@ class MockIO : public rix::ipc::interfaces::IO {
             cv.notify_all();
             return len;
         });
+        ON_CALL(*this, readv).WillByDefault([this](const struct iovec *iov, int iovcnt) -> ssize_t {
+            // Scatter one read across the buffers, like readv(2)
+            ssize_t total = 0;
+            for (int i = 0; i < iovcnt; i++) {
+                if (iov[i].iov_len == 0) continue;
+                ssize_t n = read(static_cast<uint8_t *>(iov[i].iov_base), iov[i].iov_len);
+                if (n <= 0) return total > 0 ? total : n;
+                total += n;
+                if (static_cast<size_t>(n) < iov[i].iov_len) break;
+            }
+            return total;
+        });
+        ON_CALL(*this, writev).WillByDefault([this](const struct iovec *iov, int iovcnt) -> ssize_t {
+            // Write the buffers in order with one `write` each. Like writev(2),
+            // stop at the first short write so the stream has no gaps
+            ssize_t total = 0;
+            for (int i = 0; i < iovcnt; i++) {
+                if (iov[i].iov_len == 0) continue;
+                ssize_t n = write(static_cast<const uint8_t *>(iov[i].iov_base), iov[i].iov_len);
+                if (n <= 0) return total > 0 ? total : n;
+                total += n;
+                if (static_cast<size_t>(n) < iov[i].iov_len) break;
+            }
+            return total;
+        });
         ON_CALL(*this, wait_for_writable).WillByDefault([this](const rix::util::Duration &d) -> bool {
             return read_end_open;
         });
@@ -56,6 +81,8 @@ class MockIO : public rix::ipc::interfaces::IO {
 
     MOCK_METHOD(ssize_t, read, (uint8_t *buffer, size_t len), (const, override));
     MOCK_METHOD(ssize_t, write, (const uint8_t *buffer, size_t len), (const, override));
+    MOCK_METHOD(ssize_t, readv, (const struct iovec *iov, int iovcnt), (const, override));
+    MOCK_METHOD(ssize_t, writev, (const struct iovec *iov, int iovcnt), (const, override));
     MOCK_METHOD(bool, wait_for_writable, (const rix::util::Duration &duration), (const, override));
     MOCK_METHOD(bool, wait_for_readable, (const rix::util::Duration &duration), (const, override));
     MOCK_METHOD(void, set_nonblocking, (bool status), (override));
@@ -3,6 +3,8 @@
 #include <thread>
 #include <chrono>
 
+#include <sys/socket.h>
+
 #include "rix/ipc/pipe.hpp"
 
 using namespace rix::ipc;
@@ -110,3 +112,181 @@ TEST(PipeTest, ReadEndCannotWrite) {
     ssize_t result = reader.write(reinterpret_cast<const uint8_t*>(msg.data()), msg.size());
     EXPECT_EQ(result, -1);  // Should fail
 }
+
+// Test capacity control on create
+TEST(PipeTest, CreateWithCapacity) {
+    auto [reader, writer] = Pipe::create(1 << 20);
+    ASSERT_TRUE(reader.ok());
+    EXPECT_GE(writer.capacity(), 1 << 20);
+    EXPECT_EQ(reader.capacity(), writer.capacity());
+
+    EXPECT_TRUE(writer.set_capacity(4096));
+    EXPECT_EQ(writer.capacity(), 4096);
+}
+
+// Test vmsplice into the write end and tee to a second pipe
+TEST(PipeTest, VmspliceAndTee) {
+    auto [reader, writer] = Pipe::create();
+    auto [copy_reader, copy_writer] = Pipe::create();
+    const std::string msg = "zero copy";
+
+    ASSERT_EQ(writer.vmsplice(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    EXPECT_EQ(reader.vmsplice(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), -1);
+
+    ASSERT_EQ(reader.tee(copy_writer, msg.size()), msg.size());
+    EXPECT_EQ(reader.tee(copy_reader, msg.size()), -1);
+
+    std::vector<uint8_t> buffer(msg.size());
+    ASSERT_EQ(reader.read(buffer.data(), buffer.size()), msg.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), msg);
+    ASSERT_EQ(copy_reader.read(buffer.data(), buffer.size()), msg.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), msg);
+}
+
+// Test splicing between a regular file and a pipe
+TEST(PipeTest, SpliceFromAndTo) {
+    const std::string in_path = "/tmp/test_pipe_splice_in.tmp";
+    const std::string out_path = "/tmp/test_pipe_splice_out.tmp";
+    const std::string msg = "spliced through the kernel";
+    {
+        File f(in_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        f.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size());
+    }
+
+    auto [reader, writer] = Pipe::create();
+    File in(in_path, O_RDONLY);
+    File out(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    EXPECT_EQ(writer.splice_from(in, 7, 8), 7);  // "through"
+    EXPECT_EQ(reader.splice_from(in, 7), -1);
+    EXPECT_EQ(reader.splice_to(out, 7), 7);
+
+    File check(out_path, O_RDONLY);
+    std::vector<uint8_t> buffer(7);
+    ASSERT_EQ(check.read(buffer.data(), buffer.size()), 7);
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), "through");
+
+    File::remove(in_path);
+    File::remove(out_path);
+}
+
+// Test moving bytes between two regular files without user-space copies
+TEST(PipeTest, TransferBetweenFiles) {
+    const std::string in_path = "/tmp/test_pipe_transfer_in.tmp";
+    const std::string out_path = "/tmp/test_pipe_transfer_out.tmp";
+    std::vector<uint8_t> data(200000);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint8_t>(i * 7);
+    {
+        File f(in_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT_EQ(f.write(data.data(), data.size()), data.size());
+    }
+
+    {
+        File in(in_path, O_RDONLY);
+        File out(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        EXPECT_EQ(Pipe::transfer(in, out, data.size() + 100), data.size());
+    }
+
+    File check(out_path, O_RDONLY);
+    std::vector<uint8_t> buffer(data.size());
+    size_t got = 0;
+    while (got < buffer.size()) {
+        ssize_t n = check.read(buffer.data() + got, buffer.size() - got);
+        ASSERT_GT(n, 0);
+        got += n;
+    }
+    EXPECT_EQ(buffer, data);
+
+    File::remove(in_path);
+    File::remove(out_path);
+}
+
+// Test that a transfer into a full non-blocking socket waits for the reader
+// instead of dropping bytes already staged from the source
+TEST(PipeTest, TransferToNonBlockingSocket) {
+    const std::string in_path = "/tmp/test_pipe_transfer_socket.tmp";
+    std::vector<uint8_t> data(1 << 20);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint8_t>(i * 13);
+    {
+        File f(in_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT_EQ(f.write(data.data(), data.size()), data.size());
+    }
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+    File out(fds[0]);
+    File peer(fds[1]);
+
+    std::vector<uint8_t> received;
+    std::thread consumer([&]() {
+        std::vector<uint8_t> buffer(4096);
+        while (received.size() < data.size() && peer.wait_for_readable(rix::util::Duration(5.0))) {
+            ssize_t n = peer.read(buffer.data(), buffer.size());
+            if (n > 0) {
+                received.insert(received.end(), buffer.begin(), buffer.begin() + n);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+    File in(in_path, O_RDONLY);
+    EXPECT_EQ(Pipe::transfer(in, out, data.size()), data.size());
+    consumer.join();
+    EXPECT_EQ(received, data);
+    File::remove(in_path);
+}
+
+// Test that a blocking source returns what is available instead of waiting
+// for the full size
+TEST(PipeTest, TransferShortFromBlockingSocket) {
+    const std::string out_path = "/tmp/test_pipe_transfer_short.tmp";
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    File in(fds[0]);
+    File peer(fds[1]);
+    File out(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    const std::string first = "first", second = "second";
+    ASSERT_EQ(peer.write(reinterpret_cast<const uint8_t *>(first.data()), first.size()), first.size());
+    EXPECT_EQ(Pipe::transfer(in, out, 4096), first.size());
+    ASSERT_EQ(peer.write(reinterpret_cast<const uint8_t *>(second.data()), second.size()), second.size());
+    EXPECT_EQ(Pipe::transfer(in, out, 4096), second.size());
+    File::remove(out_path);
+}
+
+// Test that an empty non-blocking source is an error rather than end of stream
+TEST(PipeTest, TransferFromEmptyNonBlockingSocket) {
+    const std::string out_path = "/tmp/test_pipe_transfer_empty.tmp";
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds), 0);
+    File in(fds[0]);
+    File peer(fds[1]);
+
+    File out(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    errno = 0;
+    EXPECT_EQ(Pipe::transfer(in, out, 64), -1);
+    EXPECT_EQ(errno, EAGAIN);
+    File::remove(out_path);
+}
+
+// Test moving bytes from a pipe straight into a file
+TEST(PipeTest, TransferFromPipe) {
+    const std::string out_path = "/tmp/test_pipe_transfer_pipe.tmp";
+    auto [reader, writer] = Pipe::create();
+    const std::string msg = "from pipe";
+    writer.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size());
+
+    File out(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    EXPECT_EQ(Pipe::transfer(reader, out, msg.size()), msg.size());
+    File::remove(out_path);
+}
+
+// Test that sub-millisecond timeouts are not rounded up to a full millisecond
+TEST(PipeTest, SubMillisecondWaitTimeout) {
+    auto pipes = Pipe::create();
+    constexpr int iterations = 50;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        EXPECT_FALSE(pipes[0].wait_for_readable(rix::util::Duration(100e-6)));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::microseconds(100 * iterations));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(iterations)) << "Average wait should be well below 1 ms.";
+}
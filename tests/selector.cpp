@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rix/ipc/fifo.hpp"
+#include "rix/ipc/pipe.hpp"
+#include "rix/ipc/selector.hpp"
+
+using namespace rix::ipc;
+
+// Test default constructor
+TEST(SelectorTest, DefaultConstructor) {
+    Selector selector;
+    EXPECT_EQ(selector.size(), 0);
+    std::vector<Selector::Ready> ready;
+    EXPECT_EQ(selector.wait(rix::util::Duration(0.01), ready), 0);
+    EXPECT_TRUE(ready.empty());
+}
+
+// Test adding and removing descriptors
+TEST(SelectorTest, AddAndRemove) {
+    Selector selector;
+    auto pipes = Pipe::create();
+    EXPECT_FALSE(selector.add(File()));
+    EXPECT_TRUE(selector.add(pipes[0]));
+    EXPECT_TRUE(selector.add(pipes[0], Selector::READABLE));
+    EXPECT_EQ(selector.size(), 1) << "Adding the same descriptor twice should update it.";
+    EXPECT_TRUE(selector.add(pipes[1], Selector::WRITABLE));
+    EXPECT_EQ(selector.size(), 2);
+    EXPECT_TRUE(selector.remove(pipes[1]));
+    EXPECT_FALSE(selector.remove(pipes[1]));
+    selector.clear();
+    EXPECT_EQ(selector.size(), 0);
+}
+
+// Test that only the ready descriptors are returned
+TEST(SelectorTest, ReturnsReadySet) {
+    auto a = Pipe::create();
+    auto b = Pipe::create();
+    auto c = Pipe::create();
+    Selector selector;
+    selector.add(a[0]);
+    selector.add(b[0]);
+    selector.add(c[0]);
+
+    std::vector<Selector::Ready> ready;
+    EXPECT_EQ(selector.wait(rix::util::Duration(0.01), ready), 0);
+
+    uint8_t byte = 1;
+    ASSERT_EQ(b[1].write(&byte, 1), 1);
+    ASSERT_EQ(c[1].write(&byte, 1), 1);
+    ASSERT_EQ(selector.wait(rix::util::Duration(1.0), ready), 2);
+    EXPECT_EQ(ready[0].fd, b[0].fd());
+    EXPECT_TRUE(ready[0].events & Selector::READABLE);
+    EXPECT_EQ(ready[1].fd, c[0].fd());
+}
+
+// Test that one wait serves many sources and wakes on the first event
+TEST(SelectorTest, WakesOnWriteFromAnotherThread) {
+    auto a = Pipe::create();
+    auto b = Pipe::create();
+    EventNotification shutdown;
+    Selector selector;
+    selector.add(a[0]);
+    selector.add(b[0]);
+    selector.add(shutdown);
+
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        uint8_t byte = 7;
+        a[1].write(&byte, 1);
+    });
+
+    std::vector<Selector::Ready> ready;
+    ASSERT_EQ(selector.wait(rix::util::Duration(5.0), ready), 1);
+    EXPECT_EQ(ready[0].fd, a[0].fd());
+    writer.join();
+
+    shutdown.raise();
+    uint8_t byte;
+    ASSERT_EQ(a[0].read(&byte, 1), 1);
+    ASSERT_EQ(selector.wait(rix::util::Duration(1.0), ready), 1);
+    EXPECT_EQ(ready[0].fd, shutdown.fd());
+    EXPECT_TRUE(shutdown.wait(rix::util::Duration(0)));
+}
+
+// Test waiting on a Signal alongside other descriptors
+TEST(SelectorTest, SignalIsReported) {
+    Signal signal(SIGUSR1);
+    auto pipes = Pipe::create();
+    Selector selector;
+    ASSERT_TRUE(selector.add(signal));
+    selector.add(pipes[0]);
+
+    ASSERT_TRUE(signal.raise());
+    std::vector<Selector::Ready> ready;
+    ASSERT_EQ(selector.wait(rix::util::Duration(1.0), ready), 1);
+    EXPECT_EQ(ready[0].fd, signal.fd());
+    EXPECT_TRUE(signal.wait(rix::util::Duration(0)));
+    EXPECT_EQ(selector.wait(rix::util::Duration(0), ready), 0) << "The signal should be consumed by wait.";
+}
+
+// Test that a signal that is not in the set does not end the wait early
+TEST(SelectorTest, InterruptedWaitResumes) {
+    struct sigaction action = {};
+    struct sigaction previous;
+    action.sa_handler = [](int) {};
+    ASSERT_EQ(::sigaction(SIGUSR2, &action, &previous), 0);
+
+    auto pipes = Pipe::create();
+    Selector selector;
+    selector.add(pipes[0]);
+    const pthread_t waiter = ::pthread_self();
+    std::thread interrupter([waiter]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ::pthread_kill(waiter, SIGUSR2);
+    });
+    std::vector<Selector::Ready> ready;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(selector.wait(rix::util::Duration(0.1), ready), 0);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    interrupter.join();
+    ::sigaction(SIGUSR2, &previous, nullptr);
+}
+
+// Test writable events on a FIFO
+TEST(SelectorTest, WritableFifo) {
+    const std::string path = "/tmp/rix_selector_test_fifo";
+    File::remove(path);
+    Fifo writer(path, Fifo::Mode::WRITE, true);
+    ASSERT_TRUE(writer.ok());
+
+    Selector selector;
+    selector.add(writer, Selector::WRITABLE);
+    std::vector<Selector::Ready> ready;
+    ASSERT_EQ(selector.wait(rix::util::Duration(0.1), ready), 1);
+    EXPECT_TRUE(ready[0].events & Selector::WRITABLE);
+    File::remove(path);
+}
+
+// Test that a closed write end is reported as a hang-up
+TEST(SelectorTest, Hangup) {
+    auto pipes = Pipe::create();
+    Selector selector;
+    selector.add(pipes[0]);
+    pipes[1] = Pipe();
+    std::vector<Selector::Ready> ready;
+    ASSERT_EQ(selector.wait(rix::util::Duration(0.1), ready), 1);
+    EXPECT_TRUE(ready[0].events & POLLHUP);
+}
@@ -0,0 +1,266 @@
+#include "rix/ipc/shm_ring.hpp"
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rix::ipc;
+
+// Test default constructor
+TEST(ShmRingTest, DefaultConstructor) {
+    ShmRing ring;
+    EXPECT_FALSE(ring.ok());
+    uint8_t byte = 0;
+    EXPECT_EQ(ring.read(&byte, 1), -1);
+    EXPECT_EQ(ring.write(&byte, 1), -1);
+}
+
+// Test factory method and basic communication
+TEST(ShmRingTest, FactoryCreatesValidPair) {
+    auto [reader, writer] = ShmRing::create(100);
+    ASSERT_TRUE(reader.ok());
+    ASSERT_TRUE(writer.ok());
+    EXPECT_EQ(reader.mode(), ShmRing::Mode::READ);
+    EXPECT_EQ(writer.mode(), ShmRing::Mode::WRITE);
+    EXPECT_GE(writer.capacity(), 100);
+    EXPECT_EQ(writer.capacity() & (writer.capacity() - 1), 0) << "Capacity should be a power of two.";
+
+    const std::string msg = "shm ring test";
+    EXPECT_EQ(writer.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    EXPECT_EQ(reader.size(), msg.size());
+    EXPECT_TRUE(reader.is_readable());
+
+    std::vector<uint8_t> buffer(msg.size());
+    EXPECT_EQ(reader.read(buffer.data(), buffer.size()), msg.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), msg);
+    EXPECT_EQ(reader.size(), 0);
+}
+
+// Test unidirectional communication enforcement
+TEST(ShmRingTest, EndsAreUnidirectional) {
+    auto [reader, writer] = ShmRing::create(64);
+    uint8_t byte = 1;
+    EXPECT_EQ(reader.write(&byte, 1), -1);
+    EXPECT_EQ(writer.read(&byte, 1), -1);
+    EXPECT_EQ(reader.reserve(1), nullptr);
+    size_t size;
+    EXPECT_EQ(writer.peek(size), nullptr);
+}
+
+// Test non-blocking behavior on empty and full rings
+TEST(ShmRingTest, NonBlocking) {
+    auto [reader, writer] = ShmRing::create(1);
+    reader.set_nonblocking(true);
+    writer.set_nonblocking(true);
+    EXPECT_TRUE(reader.is_nonblocking());
+
+    uint8_t byte = 0;
+    EXPECT_EQ(reader.read(&byte, 1), -1);
+    EXPECT_EQ(errno, EAGAIN);
+    EXPECT_FALSE(reader.wait_for_readable(rix::util::Duration(0.01)));
+
+    std::vector<uint8_t> big(writer.capacity() + 10, 7);
+    EXPECT_EQ(writer.write(big.data(), big.size()), writer.capacity());
+    EXPECT_EQ(writer.write(big.data(), 1), -1);
+    EXPECT_EQ(errno, EAGAIN);
+    EXPECT_FALSE(writer.is_writable());
+}
+
+// Test in-place reserve/commit and peek/release across the wrap point
+TEST(ShmRingTest, ReserveCommitWrapsContiguously) {
+    auto [reader, writer] = ShmRing::create(1);
+    const size_t cap = writer.capacity();
+
+    // Move the indices close to the end of the buffer
+    std::vector<uint8_t> filler(cap - 3, 0);
+    ASSERT_EQ(writer.write(filler.data(), filler.size()), filler.size());
+    std::vector<uint8_t> sink(filler.size());
+    ASSERT_EQ(reader.read(sink.data(), sink.size()), sink.size());
+
+    EXPECT_EQ(writer.reserve(cap + 1), nullptr);
+    uint8_t *dst = writer.reserve(10);
+    ASSERT_NE(dst, nullptr);
+    std::iota(dst, dst + 10, 0);
+    EXPECT_EQ(reader.size(), 0) << "Reserved bytes should not be visible before commit.";
+    writer.commit(10);
+
+    size_t size = 0;
+    const uint8_t *src = reader.peek(size);
+    ASSERT_NE(src, nullptr);
+    ASSERT_EQ(size, 10);
+    for (uint8_t i = 0; i < 10; i++) {
+        EXPECT_EQ(src[i], i);
+    }
+    reader.release(size);
+    EXPECT_EQ(reader.size(), 0);
+}
+
+// Test that a commit larger than the free space is clamped
+TEST(ShmRingTest, OversizedCommitClamped) {
+    auto [reader, writer] = ShmRing::create(1);
+    const size_t cap = writer.capacity();
+    ASSERT_NE(writer.reserve(8), nullptr);
+    writer.commit(cap + 100);
+    EXPECT_EQ(reader.size(), cap);
+    EXPECT_EQ(writer.reserve(1), nullptr);
+    writer.commit(1);
+    EXPECT_EQ(reader.size(), cap);
+}
+
+// Test that a blocking read waits for the writer
+TEST(ShmRingTest, ReadBlocksUntilDataAvailable) {
+    auto [reader, writer] = ShmRing::create(64);
+    const std::string msg = "block";
+
+    std::thread writer_thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        writer.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size());
+    });
+
+    std::vector<uint8_t> buffer(msg.size());
+    EXPECT_EQ(reader.read(buffer.data(), buffer.size()), msg.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), msg);
+    writer_thread.join();
+}
+
+// Test a blocking transfer larger than the ring
+TEST(ShmRingTest, StreamLargerThanCapacity) {
+    auto [reader, writer] = ShmRing::create(1);
+    std::vector<uint8_t> data(writer.capacity() * 8 + 17);
+    std::iota(data.begin(), data.end(), 0);
+
+    std::thread writer_thread([&]() { EXPECT_EQ(writer.write(data.data(), data.size()), data.size()); });
+
+    std::vector<uint8_t> received;
+    std::vector<uint8_t> buffer(1000);
+    while (received.size() < data.size()) {
+        ssize_t n = reader.read(buffer.data(), buffer.size());
+        ASSERT_GT(n, 0);
+        received.insert(received.end(), buffer.begin(), buffer.begin() + n);
+    }
+    writer_thread.join();
+    EXPECT_EQ(received, data);
+}
+
+// Test end-of-stream and broken pipe semantics
+TEST(ShmRingTest, ClosedEnds) {
+    auto [reader, writer] = ShmRing::create(64);
+    uint8_t byte = 42;
+    ASSERT_EQ(writer.write(&byte, 1), 1);
+    { ShmRing closed(std::move(writer)); }
+
+    EXPECT_TRUE(reader.wait_for_readable(rix::util::Duration(0)));
+    uint8_t value = 0;
+    EXPECT_EQ(reader.read(&value, 1), 1);
+    EXPECT_EQ(value, 42);
+    EXPECT_EQ(reader.read(&value, 1), 0) << "Read should return 0 once the write end is closed.";
+
+    auto [reader2, writer2] = ShmRing::create(64);
+    { ShmRing closed(std::move(reader2)); }
+    EXPECT_EQ(writer2.write(&byte, 1), -1);
+    EXPECT_EQ(errno, EPIPE);
+}
+
+// Test a named ring shared between two processes
+TEST(ShmRingTest, NamedRingAcrossProcesses) {
+    const std::string name = "rix_shm_ring_test";
+    ShmRing::remove(name);
+    ShmRing reader(name, 4096, ShmRing::Mode::READ);
+    ASSERT_TRUE(reader.ok());
+
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        ShmRing writer(name, 0, ShmRing::Mode::WRITE);
+        const std::string msg = "hello from child";
+        ssize_t n = writer.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size());
+        ::_exit(n == static_cast<ssize_t>(msg.size()) ? 0 : 1);
+    }
+
+    std::vector<uint8_t> buffer(16);
+    size_t got = 0;
+    while (got < buffer.size()) {
+        ssize_t n = reader.read(buffer.data() + got, buffer.size() - got);
+        ASSERT_GT(n, 0);
+        got += n;
+    }
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), "hello from child");
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(reader.capacity(), 4096);
+    EXPECT_TRUE(ShmRing::remove(name));
+}
+
+// Test that a named ring can be used again after its writer closes
+TEST(ShmRingTest, NamedRingReopened) {
+    const std::string name = "rix_shm_ring_reopen";
+    ShmRing::remove(name);
+    ShmRing reader(name, 4096, ShmRing::Mode::READ, true);
+    ASSERT_TRUE(reader.ok());
+    uint8_t value = 0;
+    { ShmRing writer(name, 0, ShmRing::Mode::WRITE); }
+    EXPECT_EQ(reader.read(&value, 1), 0) << "Read should return 0 once the write end is closed.";
+
+    ShmRing writer(name, 0, ShmRing::Mode::WRITE);
+    ASSERT_TRUE(writer.ok());
+    EXPECT_EQ(reader.read(&value, 1), -1) << "A reopened write end should not be seen as closed.";
+    EXPECT_EQ(errno, EAGAIN);
+    uint8_t byte = 7;
+    ASSERT_EQ(writer.write(&byte, 1), 1);
+    EXPECT_EQ(reader.read(&value, 1), 1);
+    EXPECT_EQ(value, 7);
+    EXPECT_TRUE(ShmRing::remove(name));
+}
+
+// Test that named rings are private to their owner and that objects whose
+// size is not a valid ring size are rejected
+TEST(ShmRingTest, NamedRingValidation) {
+    const std::string name = "rix_shm_ring_invalid";
+    ShmRing::remove(name);
+    {
+        ShmRing ring(name, 4096, ShmRing::Mode::READ);
+        ASSERT_TRUE(ring.ok());
+        struct stat st;
+        ASSERT_EQ(::fstat(ring.fd(), &st), 0);
+        EXPECT_EQ(st.st_mode & 0777, 0600u);
+    }
+    ASSERT_TRUE(ShmRing::remove(name));
+
+    int fd = ::shm_open(("/" + name).c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::ftruncate(fd, ::sysconf(_SC_PAGESIZE) + 3000), 0);
+    ::close(fd);
+    errno = 0;
+    ShmRing ring(name, 0, ShmRing::Mode::WRITE);
+    EXPECT_FALSE(ring.ok());
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_TRUE(ShmRing::remove(name));
+}
+
+// Test gathered writes and scattered reads across the wrap point
+TEST(ShmRingTest, WritevReadv) {
+    auto [reader, writer] = ShmRing::create(1);
+    const size_t cap = writer.capacity();
+    std::vector<uint8_t> filler(cap - 2, 0);
+    ASSERT_EQ(writer.write(filler.data(), filler.size()), filler.size());
+    ASSERT_EQ(reader.read(filler.data(), filler.size()), filler.size());
+
+    std::string header = "HDR", payload = "payload";
+    struct iovec out[2] = {{header.data(), header.size()}, {payload.data(), payload.size()}};
+    ASSERT_EQ(writer.writev(out, 2), 10);
+
+    std::vector<uint8_t> a(4), b(6);
+    struct iovec in[2] = {{a.data(), a.size()}, {b.data(), b.size()}};
+    ASSERT_EQ(reader.readv(in, 2), 10);
+    EXPECT_EQ(std::string(a.begin(), a.end()), "HDRp");
+    EXPECT_EQ(std::string(b.begin(), b.end()), "ayload");
+}
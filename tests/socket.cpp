@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rix/ipc/socket.hpp"
+
+using namespace rix::ipc;
+
+// Test default constructor
+TEST(SocketTest, DefaultConstructor) {
+    Socket socket;
+    EXPECT_FALSE(socket.ok());
+}
+
+// Test that each read returns exactly one message
+TEST(SocketTest, SeqPacketPreservesMessageBoundaries) {
+    auto [a, b] = Socket::create_pair(Socket::Type::SEQPACKET);
+    ASSERT_TRUE(a.ok());
+    ASSERT_TRUE(b.ok());
+    EXPECT_EQ(a.type(), Socket::Type::SEQPACKET);
+
+    const std::string first = "first", second = "second message";
+    ASSERT_EQ(a.write(reinterpret_cast<const uint8_t *>(first.data()), first.size()), first.size());
+    ASSERT_EQ(a.write(reinterpret_cast<const uint8_t *>(second.data()), second.size()), second.size());
+
+    std::vector<uint8_t> buffer(64);
+    ssize_t n = b.read(buffer.data(), buffer.size());
+    ASSERT_EQ(n, first.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + n), first);
+    n = b.read(buffer.data(), buffer.size());
+    ASSERT_EQ(n, second.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + n), second);
+}
+
+// Test that writing to a socket whose peer has closed fails with EPIPE
+// instead of raising SIGPIPE (the default action would end the test)
+TEST(SocketTest, WriteToClosedPeer) {
+    auto [a, b] = Socket::create_pair(Socket::Type::SEQPACKET);
+    ASSERT_TRUE(a.ok());
+    b = Socket();
+
+    const std::string msg = "lost";
+    errno = 0;
+    EXPECT_EQ(a.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), -1);
+    EXPECT_EQ(errno, EPIPE);
+    struct iovec iov = {const_cast<char *>(msg.data()), msg.size()};
+    errno = 0;
+    EXPECT_EQ(a.writev(&iov, 1), -1);
+    EXPECT_EQ(errno, EPIPE);
+}
+
+// Test bidirectional datagram pair
+TEST(SocketTest, DatagramPair) {
+    auto [a, b] = Socket::create_pair(Socket::Type::DATAGRAM);
+    const std::string msg = "datagram";
+    ASSERT_EQ(b.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    EXPECT_TRUE(a.wait_for_readable(rix::util::Duration(0.1)));
+
+    std::vector<uint8_t> buffer(64);
+    ssize_t n = a.read(buffer.data(), buffer.size());
+    ASSERT_EQ(n, msg.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + n), msg);
+}
+
+// Test that many messages can be moved with one call each way
+TEST(SocketTest, BatchSendAndReceive) {
+    auto [a, b] = Socket::create_pair(Socket::Type::SEQPACKET);
+
+    std::vector<std::string> messages;
+    std::vector<struct iovec> out;
+    for (int i = 0; i < 32; i++) {
+        messages.push_back("frame " + std::to_string(i));
+    }
+    for (auto &m : messages) {
+        out.push_back({m.data(), m.size()});
+    }
+    ASSERT_EQ(a.send_batch(out), 32);
+
+    std::vector<std::vector<uint8_t>> storage(64, std::vector<uint8_t>(32));
+    std::vector<struct iovec> in;
+    for (auto &s : storage) {
+        in.push_back({s.data(), s.size()});
+    }
+    ASSERT_EQ(b.recv_batch(in), 32);
+    for (int i = 0; i < 32; i++) {
+        EXPECT_EQ(std::string(storage[i].begin(), storage[i].begin() + in[i].iov_len), messages[i]);
+    }
+}
+
+// Test that a nonblocking receive with nothing queued fails with EAGAIN
+TEST(SocketTest, NonBlockingRecvBatch) {
+    auto [a, b] = Socket::create_pair(Socket::Type::SEQPACKET);
+    b.set_nonblocking(true);
+    std::vector<uint8_t> storage(16);
+    std::vector<struct iovec> in = {{storage.data(), storage.size()}};
+    EXPECT_EQ(b.recv_batch(in), -1);
+    EXPECT_EQ(errno, EAGAIN);
+}
+
+// Test named SEQPACKET server and client
+TEST(SocketTest, BindListenAcceptConnect) {
+    const std::string path = "/tmp/rix_socket_test.sock";
+    File::remove(path);
+
+    Socket server(Socket::Type::SEQPACKET);
+    ASSERT_TRUE(server.bind(path));
+    EXPECT_EQ(server.pathname(), path);
+    ASSERT_TRUE(server.listen());
+
+    Socket client(Socket::Type::SEQPACKET);
+    ASSERT_TRUE(client.connect(path));
+    Socket conn = server.accept();
+    ASSERT_TRUE(conn.ok());
+
+    const std::string msg = "hello";
+    ASSERT_EQ(client.write(reinterpret_cast<const uint8_t *>(msg.data()), msg.size()), msg.size());
+    std::vector<uint8_t> buffer(16);
+    ssize_t n = conn.read(buffer.data(), buffer.size());
+    ASSERT_EQ(n, msg.size());
+    EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + n), msg);
+
+    // Closing the client is seen as end of stream
+    client = Socket();
+    EXPECT_EQ(conn.read(buffer.data(), buffer.size()), 0);
+    EXPECT_TRUE(File::remove(path));
+}
+
+// Test copy and move
+TEST(SocketTest, CopyAndMove) {
+    auto [a, b] = Socket::create_pair(Socket::Type::DATAGRAM);
+    Socket copy(a);
+    EXPECT_TRUE(copy.ok());
+    EXPECT_NE(copy.fd(), a.fd());
+    EXPECT_EQ(copy.type(), Socket::Type::DATAGRAM);
+
+    int fd = b.fd();
+    Socket moved(std::move(b));
+    EXPECT_FALSE(b.ok());
+    EXPECT_EQ(moved.fd(), fd);
+
+    Socket assigned;
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved.ok());
+    EXPECT_EQ(assigned.fd(), fd);
+}
@@ -3,6 +3,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
+#include "rix/ipc/event_notification.hpp"
 #include "mocks/mock_io.hpp"
 #include "mocks/mock_notification.hpp"
 
@@ -154,4 +158,114 @@ TEST(TeleopKeyboardTest, TranslatesInvalidKeysAndExitsOnNotification) {
 
     ASSERT_EQ(twists.size(), 3); // a, d, e
     validate_twists(data, 5, twists); // abcde
-}
\ No newline at end of file
+}
+
+TEST(TeleopKeyboardTest, ExitsOnEventNotificationFromAnotherThread) {
+    auto input = std::make_unique<testing::NiceMock<MockIO>>();
+    auto output = std::make_unique<testing::NiceMock<MockIO>>();
+    auto output_ptr = output.get();  // Get raw pointer for inspection
+
+    auto teleop_keyboard = std::make_unique<TeleopKeyboard>(std::move(input), std::move(output), 0.5, 1.5);
+
+    rix::ipc::EventNotification shutdown;
+    auto notif = std::make_unique<rix::ipc::EventNotification>(shutdown);
+
+    std::thread stopper([&shutdown]() {
+        rix::util::sleep_for(rix::util::Duration(0.05));
+        shutdown.raise();
+    });
+    teleop_keyboard->spin(std::move(notif));
+    stopper.join();
+
+    EXPECT_EQ(output_ptr->get_buffer().size(), 0);
+}
+
+// Runs `data` through a TeleopKeyboard whose output stays unwritable until
+// the input has ended, then returns the commands that reached the output
+size_t run_with_slow_output(TeleopKeyboard::OverflowPolicy policy, size_t capacity,
+                            std::vector<rix::msg::geometry::Twist2DStamped> &twists,
+                            const std::string &data = "wasdq") {
+    auto input = std::make_unique<testing::NiceMock<MockIO>>();
+    input->write((const uint8_t *)data.data(), data.size());
+    input->close_write_end();
+
+    std::atomic<bool> writable(false);
+    auto output = std::make_unique<testing::NiceMock<MockIO>>();
+    auto output_ptr = output.get();
+    ON_CALL(*output, wait_for_writable).WillByDefault([&writable](const rix::util::Duration &) -> bool {
+        return writable.load();
+    });
+    // The output's mode may be shared with other processes, so it is not changed
+    EXPECT_CALL(*output, set_nonblocking(testing::_)).Times(0);
+
+    TeleopKeyboard teleop_keyboard(std::move(input), std::move(output), 0.5, 1.5, capacity, policy);
+    std::thread consumer([&writable]() {
+        rix::util::sleep_for(rix::util::Duration(0.05));
+        writable = true;
+    });
+    teleop_keyboard.spin(std::make_unique<testing::NiceMock<MockNotification>>());
+    consumer.join();
+
+    convert_buffer_to_twists(output_ptr->get_buffer(), twists);
+    return teleop_keyboard.dropped();
+}
+
+TEST(TeleopKeyboardTest, SlowOutputDropsOldest) {
+    init_twist_map(0.5, 1.5);
+    std::vector<rix::msg::geometry::Twist2DStamped> twists;
+    EXPECT_EQ(run_with_slow_output(TeleopKeyboard::OverflowPolicy::DROP_OLDEST, 2, twists), 3);
+    ASSERT_EQ(twists.size(), 2);
+    validate_twists("dq", 2, twists);
+    EXPECT_EQ(twists[0].header.seq, 3);
+}
+
+TEST(TeleopKeyboardTest, SlowOutputDropsNewest) {
+    init_twist_map(0.5, 1.5);
+    std::vector<rix::msg::geometry::Twist2DStamped> twists;
+    EXPECT_EQ(run_with_slow_output(TeleopKeyboard::OverflowPolicy::DROP_NEWEST, 2, twists), 3);
+    ASSERT_EQ(twists.size(), 2);
+    validate_twists("wa", 2, twists);
+}
+
+// Test that a stop command is delivered even when the queue is full and the
+// policy drops new commands
+TEST(TeleopKeyboardTest, SlowOutputNeverDropsStop) {
+    init_twist_map(0.5, 1.5);
+    std::vector<rix::msg::geometry::Twist2DStamped> twists;
+    EXPECT_EQ(run_with_slow_output(TeleopKeyboard::OverflowPolicy::DROP_NEWEST, 2, twists, "wasd "), 3);
+    ASSERT_EQ(twists.size(), 2);
+    validate_twists("a ", 2, twists);
+    EXPECT_EQ(twists[1].header.seq, 4);
+}
+
+TEST(TeleopKeyboardTest, SlowOutputCollapsesToLatest) {
+    init_twist_map(0.5, 1.5);
+    std::vector<rix::msg::geometry::Twist2DStamped> twists;
+    EXPECT_EQ(run_with_slow_output(TeleopKeyboard::OverflowPolicy::COLLAPSE_TO_LATEST, 64, twists), 4);
+    ASSERT_EQ(twists.size(), 1);
+    validate_twists("q", 1, twists);
+}
+
+TEST(TeleopKeyboardTest, PushesToIntraChannelWithoutSerializing) {
+    using Channel = rix::ipc::IntraChannel<rix::msg::geometry::Twist2DStamped>;
+    auto input = std::make_unique<testing::NiceMock<MockIO>>();
+    const char *data = "qwe asd";
+    input->write((uint8_t *)data, 7);
+    input->close_write_end();
+
+    auto [reader, writer] = Channel::create(8);
+    auto output = std::make_unique<Channel>(std::move(writer));
+
+    init_twist_map(0.5, 1.5);
+    TeleopKeyboard teleop_keyboard(std::move(input), std::move(output), 0.5, 1.5);
+    teleop_keyboard.spin(std::make_unique<testing::NiceMock<MockNotification>>());
+
+    std::vector<rix::msg::geometry::Twist2DStamped> twists;
+    std::shared_ptr<const rix::msg::geometry::Twist2DStamped> msg;
+    while (reader.pop(msg)) {
+        twists.push_back(*msg);
+    }
+    ASSERT_EQ(twists.size(), 7);
+    validate_twists(data, 7, twists);
+    EXPECT_EQ(teleop_keyboard.dropped(), 0);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "rix/ipc/selector.hpp"
+#include "rix/util/timer_wheel.hpp"
+
+using namespace rix::util;
+
+// Test that one-shot timers run once, in order, and not before they are due
+TEST(TimerWheelTest, OneShot) {
+    TimerWheel wheel;
+    ASSERT_TRUE(wheel.ok());
+    std::vector<int> order;
+    const SteadyTime start = SteadyTime::now();
+    SteadyTime fired_at;
+    wheel.add(Duration(0.03), [&]() { order.push_back(3); });
+    wheel.add(Duration(0.01), [&]() {
+        order.push_back(1);
+        fired_at = SteadyTime::now();
+    });
+    wheel.add(Duration(0.02), [&]() { order.push_back(2); });
+    EXPECT_EQ(wheel.size(), 3u);
+
+    EXPECT_EQ(wheel.process(), 0u);
+    while (wheel.size() > 0 && SteadyTime::now() - start < Duration(1.0)) {
+        wheel.wait(Duration(1.0));
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_GE(fired_at - start, Duration(0.01));
+    EXPECT_LT(fired_at - start, Duration(0.05));
+}
+
+// Test that periodic timers keep their schedule and can be cancelled
+TEST(TimerWheelTest, PeriodicAndCancel) {
+    TimerWheel wheel;
+    int fast = 0, slow = 0, cancelled = 0;
+    const SteadyTime start = SteadyTime::now();
+    wheel.add_periodic(Duration(0.005), [&]() { fast++; });
+    auto slow_id = wheel.add_periodic(Duration(0.02), [&]() { slow++; }, Duration(0.0));
+    auto id = wheel.add(Duration(0.01), [&]() { cancelled++; });
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(TimerWheel::INVALID_ID));
+
+    while (SteadyTime::now() - start < Duration(0.1)) {
+        wheel.wait(Duration(0.1));
+    }
+    const double elapsed = (SteadyTime::now() - start).to_nanoseconds() * 1e-9;
+    EXPECT_EQ(cancelled, 0);
+    // A loaded machine may skip some missed periods, so only half of the
+    // scheduled runs are required, but missed periods are never run in a
+    // burst, so neither timer runs more often than its schedule
+    EXPECT_GE(fast, static_cast<int>(elapsed / 0.005 / 2));
+    EXPECT_LE(fast, static_cast<int>(elapsed / 0.005) + 1);
+    EXPECT_GE(slow, static_cast<int>(elapsed / 0.02 / 2));
+    EXPECT_LE(slow, static_cast<int>(elapsed / 0.02) + 1);
+    EXPECT_TRUE(wheel.cancel(slow_id));
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+// Test that callbacks can add timers and cancel themselves
+TEST(TimerWheelTest, CallbacksModifyWheel) {
+    TimerWheel wheel;
+    int runs = 0, chained = 0;
+    TimerWheel::Id self = TimerWheel::INVALID_ID;
+    self = wheel.add_periodic(Duration(0.002), [&]() {
+        if (++runs == 3) {
+            EXPECT_TRUE(wheel.cancel(self));
+            wheel.add(Duration(0.0), [&]() { chained++; });
+        }
+    });
+    const SteadyTime start = SteadyTime::now();
+    while (wheel.size() > 0 && SteadyTime::now() - start < Duration(1.0)) {
+        wheel.wait(Duration(0.1));
+    }
+    EXPECT_EQ(runs, 3);
+    EXPECT_EQ(chained, 1);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+// Test timers that start in the upper levels of the wheel and are cascaded
+// down until they expire, using the finest resolution so that short delays
+// span many ticks
+TEST(TimerWheelTest, Levels) {
+    TimerWheel wheel(Duration(std::chrono::microseconds(1)));
+    std::vector<int> order;
+    // 300 and 30000 ticks away start in level 1 (under 2^16 ticks), 70000
+    // ticks in level 2 (under 2^24) and 2e7 ticks in level 3
+    wheel.add(Duration(0.0003), [&]() { order.push_back(1); });
+    wheel.add(Duration(0.03), [&]() { order.push_back(2); });
+    wheel.add(Duration(0.07), [&]() { order.push_back(3); });
+    auto far = wheel.add(Duration(20.0), [&]() { order.push_back(4); });
+
+    const SteadyTime start = SteadyTime::now();
+    while (order.size() < 3 && SteadyTime::now() - start < Duration(1.0)) {
+        wheel.wait(Duration(0.1));
+    }
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_GE(SteadyTime::now() - start, Duration(0.07));
+    EXPECT_EQ(wheel.size(), 1u);
+    EXPECT_TRUE(wheel.cancel(far));
+}
+
+// Test thousands of timers driven through a Selector
+TEST(TimerWheelTest, ManyTimersWithSelector) {
+    constexpr int TIMERS = 5000;
+    TimerWheel wheel;
+    rix::ipc::Selector selector;
+    ASSERT_TRUE(selector.add(wheel.fd()));
+
+    int fired = 0;
+    std::vector<TimerWheel::Id> ids;
+    for (int i = 0; i < TIMERS; i++) {
+        ids.push_back(wheel.add(Duration(0.001 * (i % 50)), [&fired]() { fired++; }));
+    }
+    // Cancel every other timer
+    for (int i = 0; i < TIMERS; i += 2) {
+        EXPECT_TRUE(wheel.cancel(ids[i]));
+    }
+
+    std::vector<rix::ipc::Selector::Ready> ready;
+    const SteadyTime start = SteadyTime::now();
+    while (wheel.size() > 0 && SteadyTime::now() - start < Duration(1.0)) {
+        if (selector.wait(Duration(0.1), ready) > 0) {
+            wheel.process();
+        }
+    }
+    EXPECT_EQ(fired, TIMERS / 2);
+}
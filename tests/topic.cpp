@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "rix/ipc/publisher.hpp"
+#include "rix/ipc/subscriber.hpp"
+#include "rix/msg/geometry/Twist2DStamped.hpp"
+#include "rix/msg/standard/Header.hpp"
+#include "rix/msg/standard/UInt32.hpp"
+
+using namespace rix::ipc;
+using rix::msg::geometry::Twist2DStamped;
+using rix::msg::standard::UInt32;
+
+class TopicTest : public ::testing::Test {
+   protected:
+    std::string root = "/tmp/rix_topic_test_" + std::to_string(::getpid());
+
+    void TearDown() override { std::system(("rm -rf " + root).c_str()); }
+};
+
+// Test default constructors
+TEST_F(TopicTest, DefaultConstructors) {
+    Publisher<UInt32> pub;
+    Subscriber<UInt32> sub;
+    EXPECT_FALSE(pub.ok());
+    EXPECT_FALSE(sub.ok());
+    EXPECT_EQ(pub.publish(UInt32()), -1);
+}
+
+// Test that topics are private to the current user
+TEST_F(TopicTest, Permissions) {
+    Topic topic("robot_1/cmd_vel", UInt32().hash(), root);
+    ASSERT_TRUE(topic.ok());
+    struct stat st;
+    ASSERT_EQ(::stat(root.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0700u);
+    ASSERT_EQ(::stat(topic.path().c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0700u);
+    const std::string endpoint = topic.create_endpoint();
+    ASSERT_FALSE(endpoint.empty());
+    ASSERT_EQ(::stat(endpoint.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0600u);
+
+    // A directory that is not owned by the current user is not used
+    const std::string other = root + "/other";
+    ASSERT_EQ(::symlink("/tmp", other.c_str()), 0);
+    EXPECT_FALSE(Topic("other", UInt32().hash(), root).ok());
+    EXPECT_FALSE(Topic("cmd_vel", UInt32().hash(), other).ok());
+    EXPECT_EQ(errno, EACCES);
+}
+
+// Test that the default root is in the user's runtime directory
+TEST_F(TopicTest, DefaultRoot) {
+    const char *saved = std::getenv("XDG_RUNTIME_DIR");
+    const std::string previous = saved ? saved : "";
+    ::setenv("XDG_RUNTIME_DIR", root.c_str(), 1);
+    EXPECT_EQ(Topic::default_root(), root + "/rix_topics");
+    ::unsetenv("XDG_RUNTIME_DIR");
+    EXPECT_EQ(Topic::default_root(), "/tmp/rix_topics_" + std::to_string(::geteuid()));
+    if (saved) {
+        ::setenv("XDG_RUNTIME_DIR", previous.c_str(), 1);
+    }
+}
+
+// Test that invalid topic names are rejected
+TEST_F(TopicTest, InvalidNames) {
+    EXPECT_FALSE(Topic("", UInt32().hash(), root).ok());
+    EXPECT_FALSE(Topic("/absolute", UInt32().hash(), root).ok());
+    EXPECT_FALSE(Topic("a/../b", UInt32().hash(), root).ok());
+    EXPECT_FALSE(Topic("spaces are bad", UInt32().hash(), root).ok());
+    EXPECT_TRUE(Topic("robot_1/cmd-vel", UInt32().hash(), root).ok());
+}
+
+// Test one publisher and one subscriber
+TEST_F(TopicTest, PublishSubscribe) {
+    Subscriber<UInt32> sub("numbers", root);
+    ASSERT_TRUE(sub.ok());
+    Publisher<UInt32> pub("numbers", root);
+    ASSERT_TRUE(pub.ok());
+    EXPECT_EQ(pub.subscriber_count(), 1);
+
+    UInt32 msg;
+    msg.data = 1234;
+    ASSERT_EQ(pub.publish(msg), 1);
+
+    UInt32 received;
+    uint32_t publisher = 0;
+    ASSERT_TRUE(sub.wait_for_message(rix::util::Duration(1.0)));
+    ASSERT_TRUE(sub.receive(received, publisher));
+    EXPECT_EQ(received.data, 1234);
+    EXPECT_EQ(publisher, static_cast<uint32_t>(::getpid()));
+}
+
+// Test fan-out, late subscribers and unsubscribing
+TEST_F(TopicTest, FanOutAndDiscovery) {
+    Publisher<UInt32> pub("numbers", root);
+    EXPECT_EQ(pub.subscriber_count(), 0);
+    UInt32 msg;
+    msg.data = 1;
+    EXPECT_EQ(pub.publish(msg), 0);
+
+    Subscriber<UInt32> a("numbers", root);
+    {
+        Subscriber<UInt32> b("numbers", root);
+        msg.data = 2;
+        EXPECT_EQ(pub.publish(msg), 2);
+        UInt32 received;
+        ASSERT_TRUE(b.receive(received));
+        EXPECT_EQ(received.data, 2);
+    }
+    EXPECT_EQ(pub.subscriber_count(), 1) << "A destroyed subscriber should be removed from the topic.";
+    msg.data = 3;
+    EXPECT_EQ(pub.publish(msg), 1);
+
+    UInt32 received;
+    ASSERT_TRUE(a.receive(received));
+    EXPECT_EQ(received.data, 2);
+    ASSERT_TRUE(a.receive(received));
+    EXPECT_EQ(received.data, 3);
+}
+
+// Test that a change in the tick of the last listing is not missed when the
+// directory's modification time is coarse
+TEST_F(TopicTest, CoarseModificationTime) {
+    Publisher<UInt32> pub("coarse", root);
+    const std::string dir = pub.topic().path();
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME_COARSE, &now);
+
+    // Pin the modification time to the same value across a change, as a
+    // coarse timestamp would within one tick
+    struct timespec pinned[2] = {now, now};
+    pinned[1].tv_sec += 10;
+    ASSERT_EQ(utimensat(AT_FDCWD, dir.c_str(), pinned, 0), 0);
+    EXPECT_EQ(pub.subscriber_count(), 0);
+    Subscriber<UInt32> sub("coarse", root);
+    ASSERT_EQ(utimensat(AT_FDCWD, dir.c_str(), pinned, 0), 0);
+    EXPECT_EQ(pub.subscriber_count(), 1);
+
+    // A modification time before the last listing is settled
+    struct timespec past[2] = {now, now};
+    past[1].tv_sec -= 10;
+    ASSERT_EQ(utimensat(AT_FDCWD, dir.c_str(), past, 0), 0);
+    Topic topic("coarse", UInt32().hash(), root);
+    EXPECT_TRUE(topic.changed());
+    EXPECT_FALSE(topic.changed());
+}
+
+// Test that publishers only deliver to subscribers of the same type
+TEST_F(TopicTest, TypedByHash) {
+    Subscriber<Twist2DStamped> twist_sub("mixed", root, true);
+    Subscriber<UInt32> number_sub("mixed", root, true);
+    Publisher<UInt32> pub("mixed", root);
+    UInt32 msg;
+    msg.data = 9;
+    EXPECT_EQ(pub.publish(msg), 1);
+
+    UInt32 received;
+    EXPECT_TRUE(number_sub.receive(received));
+    Twist2DStamped twist;
+    EXPECT_FALSE(twist_sub.receive(twist));
+    EXPECT_EQ(errno, EAGAIN);
+}
+
+// Test many publishers in separate processes feeding one subscriber
+TEST_F(TopicTest, ManyToOneAcrossProcesses) {
+    Subscriber<Twist2DStamped> sub("cmd_vel", root);
+    constexpr int publishers = 3;
+    constexpr int messages = 20;
+
+    std::vector<pid_t> children;
+    for (int p = 0; p < publishers; p++) {
+        pid_t pid = ::fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            Publisher<Twist2DStamped> pub("cmd_vel", root);
+            bool ok = true;
+            for (int i = 0; i < messages; i++) {
+                Twist2DStamped msg;
+                msg.header.seq = i;
+                msg.twist.vx = p;
+                ok = ok && pub.publish(msg) == 1;
+            }
+            ::_exit(ok ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+
+    std::vector<int> counts(publishers, 0);
+    for (int n = 0; n < publishers * messages; n++) {
+        Twist2DStamped msg;
+        ASSERT_TRUE(sub.receive(msg));
+        int p = static_cast<int>(msg.twist.vx);
+        ASSERT_GE(p, 0);
+        ASSERT_LT(p, publishers);
+        EXPECT_EQ(msg.header.seq, static_cast<uint32_t>(counts[p]++));
+    }
+    for (pid_t pid : children) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
+
+// Test that endpoints of dead processes are cleaned up
+TEST_F(TopicTest, StaleEndpointsRemoved) {
+    Topic topic("stale", UInt32().hash(), root);
+    pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Leave an endpoint behind without unsubscribing
+        ::_exit(topic.create_endpoint().empty() ? 1 : 0);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    EXPECT_TRUE(topic.endpoints().empty());
+    Publisher<UInt32> pub("stale", root);
+    EXPECT_EQ(pub.subscriber_count(), 0);
+}
+
+// Test that a subscriber that stops reading large messages does not stall the
+// publisher or the other subscribers
+TEST_F(TopicTest, StalledSubscriber) {
+    Subscriber<rix::msg::standard::Header> stalled("large", root, true);
+    Subscriber<rix::msg::standard::Header> live("large", root, true);
+    Publisher<rix::msg::standard::Header> pub("large", root);
+    ASSERT_EQ(pub.subscriber_count(), 2);
+
+    // Three chunks per message, so the stalled FIFO fills part way through one
+    rix::msg::standard::Header msg;
+    msg.frame_id.assign(10000, 'x');
+    constexpr int messages = 20;
+    int stalled_count = 0;
+    for (int i = 0; i < messages; i++) {
+        msg.seq = i;
+        const ssize_t delivered = pub.publish(msg);
+        ASSERT_GE(delivered, 1);
+        stalled_count += static_cast<int>(delivered) - 1;
+        rix::msg::standard::Header received;
+        ASSERT_TRUE(live.receive(received));
+        EXPECT_EQ(received.seq, static_cast<uint32_t>(i));
+    }
+    EXPECT_GT(stalled_count, 0);
+    EXPECT_LT(stalled_count, messages);
+
+    // The stalled subscriber gets the complete messages; the partial frame is
+    // never returned
+    rix::msg::standard::Header received;
+    for (int i = 0; i < stalled_count; i++) {
+        ASSERT_TRUE(stalled.receive(received));
+        EXPECT_EQ(received.seq, static_cast<uint32_t>(i));
+        EXPECT_EQ(received.frame_id.size(), 10000u);
+    }
+    EXPECT_FALSE(stalled.receive(received));
+    EXPECT_EQ(errno, EAGAIN);
+
+    // Once drained, it receives new messages again
+    msg.seq = messages;
+    EXPECT_EQ(pub.publish(msg), 2);
+    ASSERT_TRUE(stalled.receive(received));
+    EXPECT_EQ(received.seq, static_cast<uint32_t>(messages));
+}